@@ -0,0 +1,72 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealBench
+
+ Minimal timing helpers for the benchmarks of the portable C modules. Benchmarks take a --quick argument that cuts
+ the number of iterations, so that ctest can check they run without spending time measuring.
+
+*/
+
+#ifndef SWRevealBench_h
+#define SWRevealBench_h
+
+#if !defined(_POSIX_C_SOURCE) && !defined(__APPLE__)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Returns a monotonic time in seconds
+static inline double SWBenchNow( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// Returns 'iterations', or a hundredth of it if the program was given --quick
+static inline long SWBenchIterations( int argc, char **argv, long iterations )
+{
+    for ( int i=1 ; i<argc ; i++ )
+        if ( strcmp( argv[i], "--quick" ) == 0 ) return iterations/100 > 0 ? iterations/100 : 1;
+
+    return iterations;
+}
+
+// Prints the time per operation of a timed run
+static inline void SWBenchReport( const char *name, double seconds, double operations )
+{
+    printf( "%-48s %10.2f ns/op  (%.0f ops in %.3f s)\n", name, seconds/operations*1e9, operations, seconds );
+}
+
+// Keeps a computed value alive so that the compiler does not drop the benchmarked work
+static volatile double SWBenchSink;
+
+#endif
@@ -0,0 +1,93 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealCommandQueue.h"
+#include "SWRevealBench.h"
+
+
+static void releaseObject( void *object )
+{
+    SWBenchSink += (double)(*(int *)object);
+}
+
+
+static int objects[512];
+
+
+// Enqueues a burst of 'size' commands that can not be coalesced and drains it, returns the elapsed time
+static double runBurst( SWRevealCommandQueue *queue, int size )
+{
+    double start = SWBenchNow();
+    for ( int i=0 ; i<size ; i++ )
+    {
+        SWRevealCommand command = { SWRevealCommandTransition, 0, 0, 0.25, i, 1, &objects[i], 0 };
+        SWRevealCommandQueueEnqueue( queue, &command );
+    }
+    while ( SWRevealCommandQueueDequeue( queue ) != NULL )
+        ;
+    return SWBenchNow()-start;
+}
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 200000 );
+    for ( int i=0 ; i<512 ; i++ ) objects[i] = i;
+
+    // bursts on a queue that already grew to fit them, reported per command and for the slowest burst
+    const int sizes[] = { 8, 64, 512 };
+    const char *names[] = { "burst of 8, per command", "burst of 64, per command", "burst of 512, per command" };
+    for ( int s=0 ; s<3 ; s++ )
+    {
+        SWRevealCommandQueue queue;
+        SWRevealCommandQueueInit( &queue, releaseObject );
+        runBurst( &queue, sizes[s] );
+
+        long bursts = iterations*8/sizes[s] > 0 ? iterations*8/sizes[s] : 1;
+        double total = 0, worst = 0;
+        for ( long i=0 ; i<bursts ; i++ )
+        {
+            double seconds = runBurst( &queue, sizes[s] );
+            total += seconds;
+            if ( seconds > worst ) worst = seconds;
+        }
+        SWBenchReport( names[s], total, (double)bursts*sizes[s] );
+        printf( "%-48s %10.2f ns\n", "  slowest burst", worst*1e9 );
+        SWRevealCommandQueueFree( &queue );
+    }
+
+    // the first burst on a new queue, which allocates and grows the ring
+    long bursts = iterations/64 > 0 ? iterations/64 : 1;
+    double total = 0;
+    for ( long i=0 ; i<bursts ; i++ )
+    {
+        SWRevealCommandQueue queue;
+        SWRevealCommandQueueInit( &queue, releaseObject );
+        total += runBurst( &queue, 512 );
+        SWRevealCommandQueueFree( &queue );
+    }
+    SWBenchReport( "burst of 512 on a new queue, per command", total, (double)bursts*512 );
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealCurveSampler.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 20000 );
+    static double values[SWRevealCurveMaxSamples];
+    const double frameInterval = 1/120.0;
+
+    // a 0.5 second animation at 120 Hz, sampled ahead in a batch or evaluated on each frame
+    const char *names[][2] =
+    {
+        { "ease out, batch per sample", "ease out, SWRevealCurveValue per sample" },
+        { "spring, batch per sample", "spring, SWRevealCurveValue per sample" },
+    };
+    for ( int c=0 ; c<2 ; c++ )
+    {
+        SWRevealCurve curve;
+        if ( c == 0 )
+            SWRevealCurveInitEaseOut( &curve, 0.5 );
+        else
+            SWRevealCurveInitSpring( &curve, 0.6, SWRevealSpringAngularFrequencyForSettlingTime( 0.6, 0.5, 1e-3 ), 2.0, 0.5 );
+
+        int count = SWRevealCurveSampleCount( &curve, frameInterval );
+        double start = SWBenchNow();
+        for ( long r=0 ; r<iterations ; r++ )
+        {
+            SWRevealCurveSample( &curve, frameInterval, values, count );
+            SWBenchSink = values[r % count];
+        }
+        SWBenchReport( names[c][0], SWBenchNow()-start, (double)iterations*count );
+
+        start = SWBenchNow();
+        for ( long r=0 ; r<iterations ; r++ )
+        {
+            for ( int i=0 ; i<count ; i++ )
+                values[i] = SWRevealCurveValue( &curve, i*frameInterval );
+            SWBenchSink = values[r % count];
+        }
+        SWBenchReport( names[c][1], SWBenchNow()-start, (double)iterations*count );
+    }
+
+    // a curve too long to be sampled ahead is evaluated on each frame
+    SWRevealCurve curve;
+    SWRevealCurveInitSpring( &curve, 0.3, SWRevealSpringAngularFrequencyForSettlingTime( 0.3, 20.0, 1e-3 ), 0.0, 20.0 );
+    long frames = iterations*60;
+    double start = SWBenchNow();
+    for ( long i=0 ; i<frames ; i++ )
+        SWBenchSink = SWRevealCurveValue( &curve, (i % 2400)*frameInterval );
+    SWBenchReport( "20 s spring, SWRevealCurveValue per frame", SWBenchNow()-start, frames );
+    return 0;
+}
@@ -0,0 +1,46 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealDeploymentModel.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long events = SWBenchIterations( argc, argv, 5000000 );
+
+    // throughput of the model over random event sequences, reported per executed command
+    SWRevealDeploymentModel model;
+    SWRevealDeploymentModelInit( &model, 1, 1, 0, 0, SWRevealPositionLeft );
+    double start = SWBenchNow();
+    SWRevealDeploymentModelRun( &model, 7, (unsigned long)events );
+    double seconds = SWBenchNow()-start;
+
+    SWBenchReport( "SWRevealDeploymentModelRun, per command", seconds, (long)model.stats.commands );
+    SWBenchReport( "SWRevealDeploymentModelRun, per event", seconds, events );
+    SWBenchSink = (double)model.stats.redundantCycles;
+    SWRevealDeploymentModelFree( &model );
+    return 0;
+}
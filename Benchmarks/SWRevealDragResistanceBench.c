@@ -0,0 +1,82 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealDragResistance.h"
+#include "SWRevealBench.h"
+
+
+// Direct evaluation of the rubber band curve, as the baked table replaces it
+static double rubberBandLocation( double x, double revealWidth, double revealOverdraw )
+{
+    if ( x <= revealWidth ) return x;
+    double u = (x-revealWidth)/revealOverdraw;
+    return revealWidth + revealOverdraw*(1.0 - 1.0/(u*0.55 + 1.0));
+}
+
+
+static double exponentialLocation( double x, double revealWidth, double revealOverdraw )
+{
+    if ( x <= revealWidth ) return x;
+    double u = (x-revealWidth)/revealOverdraw;
+    return revealWidth + revealOverdraw*(1.0 - exp( -u ));
+}
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 20000000 );
+    SWRevealResistanceTable table;
+    double sum = 0.0;
+
+    SWRevealResistanceCurve curves[] =
+    {
+        { SWRevealResistanceCurveRubberBand, 0.0, NULL, NULL },
+        { SWRevealResistanceCurveExponential, 0.0, NULL, NULL },
+    };
+    const char *names[] = { "table lookup, rubber band", "table lookup, exponential" };
+    double (*direct[])( double, double, double ) = { rubberBandLocation, exponentialLocation };
+    const char *directNames[] = { "direct evaluation, rubber band", "direct evaluation, exponential" };
+
+    for ( int c=0 ; c<2 ; c++ )
+    {
+        SWRevealResistanceTableBake( &table, &curves[c], 260, 60, 0 );
+
+        // drag locations sweep the reveal and overdraw areas, as during a gesture
+        double start = SWBenchNow();
+        for ( long i=0 ; i<iterations ; i++ )
+            sum += SWRevealResistanceTableLookup( &table, 200.0 + (i & 1023)*0.25, 0 );
+        SWBenchReport( names[c], SWBenchNow()-start, iterations );
+
+        start = SWBenchNow();
+        for ( long i=0 ; i<iterations ; i++ )
+            sum += direct[c]( 200.0 + (i & 1023)*0.25, 260, 60 );
+        SWBenchReport( directNames[c], SWBenchNow()-start, iterations );
+    }
+
+    SWBenchSink = sum;
+    return 0;
+}
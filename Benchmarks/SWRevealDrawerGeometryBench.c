@@ -0,0 +1,105 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealDrawerGeometry.h"
+#include "SWRevealBench.h"
+
+
+static SWRevealResistanceTable tables[2];
+
+
+static void makeConfig( SWRevealDrawerConfig *config, SWRevealDrawerSides sides )
+{
+    SWRevealResistanceCurve curve = { SWRevealResistanceCurveRubberBand, 0.0, NULL, NULL };
+    config->sides = sides;
+    config->rearPolicy = SWRevealOverdrawBounceBack;
+    config->rightPolicy = SWRevealOverdrawBounceBack;
+    config->quickFlickVelocity = 250;
+    config->decelerationRate = SWRevealFlingDefaultDecelerationRate;
+    for ( int i=0 ; i<2 ; i++ )
+    {
+        config->revealWidth[i] = 260;
+        config->revealOverdraw[i] = 60;
+        SWRevealResistanceTableBake( &tables[i], &curve, 260, 60, 0 );
+        config->resistanceTables[i] = &tables[i];
+    }
+}
+
+
+// Drag locations as taken before the drawer functions, clamping and a table lookup
+static double tableDragLocation( const SWRevealDrawerConfig *config, double x, int stableTrack )
+{
+    if ( (x < 0 && !(config->sides & SWRevealDrawerSidesRight)) || (x > 0 && !(config->sides & SWRevealDrawerSidesRear)) )
+        x = 0;
+
+    int symetry = x<0 ? -1 : 1;
+    return symetry*SWRevealResistanceTableLookup( config->resistanceTables[symetry<0 ? 0 : 1], x*symetry, stableTrack );
+}
+
+
+static void runDrag( const char *name, double (*dragLocation)( const SWRevealDrawerConfig*, double, int ),
+    const SWRevealDrawerConfig *config, long iterations )
+{
+    double sum = 0;
+    double start = SWBenchNow();
+    for ( long i=0 ; i<iterations ; i++ )
+        sum += dragLocation( config, (i % 701) - 350.0, 0 );
+    SWBenchReport( name, SWBenchNow()-start, iterations );
+    SWBenchSink = sum;
+}
+
+
+static void runRelease( const char *name, SWRevealPosition (*releasePosition)( const SWRevealDrawerConfig*, double, double, double* ),
+    const SWRevealDrawerConfig *config, long iterations )
+{
+    double sum = 0;
+    double start = SWBenchNow();
+    for ( long i=0 ; i<iterations ; i++ )
+    {
+        double journey;
+        sum += releasePosition( config, (i % 641) - 320.0, (i % 97)*40.0 - 1940.0, &journey ) + journey;
+    }
+    SWBenchReport( name, SWBenchNow()-start, iterations );
+    SWBenchSink = sum;
+}
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 20000000 );
+
+    SWRevealDrawerConfig rear, both;
+    makeConfig( &rear, SWRevealDrawerSidesRear );
+    makeConfig( &both, SWRevealDrawerSidesBoth );
+
+    runDrag( "drag, rear bounce back, drawer", SWRevealDrawerDragLocation, &rear, iterations );
+    runDrag( "drag, rear bounce back, table lookup", tableDragLocation, &rear, iterations );
+    runDrag( "drag, both bounce back, drawer", SWRevealDrawerDragLocation, &both, iterations );
+    runDrag( "drag, both bounce back, table lookup", tableDragLocation, &both, iterations );
+
+    runRelease( "release, rear bounce back", SWRevealDrawerReleasePosition, &rear, iterations );
+    runRelease( "release, both bounce back", SWRevealDrawerReleasePosition, &both, iterations );
+    return 0;
+}
@@ -0,0 +1,50 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealFrameStats.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 20000000 );
+    SWRevealFrameStats stats;
+    SWRevealFrameStatsReset( &stats, 1.0/120.0 );
+
+    // the cost added to each gesture move and each display frame when instrumentation is on
+    double start = SWBenchNow();
+    for ( long i=0 ; i<iterations ; i++ )
+        SWRevealFrameStatsAddWork( &stats, (i & 255)*0.0001 );
+    SWBenchReport( "SWRevealFrameStatsAddWork", SWBenchNow()-start, iterations );
+
+    double t = 0.0;
+    start = SWBenchNow();
+    for ( long i=0 ; i<iterations ; i++ )
+        SWRevealFrameStatsAddFrame( &stats, t += (i % 97 ? 1.0/120.0 : 3.0/120.0) );
+    SWBenchReport( "SWRevealFrameStatsAddFrame", SWBenchNow()-start, iterations );
+
+    SWBenchSink = SWRevealFrameHistogramPercentile( &stats.frameIntervals, 0.99 ) + stats.missedFrames;
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <stdlib.h>
+
+#include "SWRevealGeometry.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 2000 );
+    enum { count = 4096 };
+
+    SWRevealGeometryConfig config = { 375, 812, 260, 60, 40, -100, 60, 40, 64 };
+    double *locations = malloc( count*sizeof *locations );
+    SWRevealLayoutFrames *frames = malloc( count*sizeof *frames );
+    if ( !locations || !frames )
+        return 1;
+
+    for ( int i=0 ; i<count ; i++ )
+        locations[i] = -375.0 + 750.0*i/count;
+
+    double start = SWBenchNow();
+    for ( long n=0 ; n<iterations ; n++ )
+        for ( int i=0 ; i<count ; i++ )
+            SWRevealGetLayoutFrames( &config, locations[i], &frames[i] );
+    SWBenchReport( "SWRevealGetLayoutFrames, per location", SWBenchNow()-start, (double)iterations*count );
+    SWBenchSink = frames[count/2].rear.x;
+
+    start = SWBenchNow();
+    for ( long n=0 ; n<iterations ; n++ )
+        SWRevealGetLayoutFramesBatch( &config, locations, frames, count );
+    SWBenchReport( "SWRevealGetLayoutFramesBatch, per location", SWBenchNow()-start, (double)iterations*count );
+    SWBenchSink = frames[count/2].rear.x;
+
+    free( locations );
+    free( frames );
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealShadow.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 2000 );
+
+    // the default shadow of the controller on 2x and 3x screens, and a large soft shadow
+    SWRevealShadowConfig configs[] =
+    {
+        { 2.5, 0.0, 0.0, 0.0, 1.0, 1.0, 2.0 },
+        { 2.5, 0.0, 0.0, 0.0, 1.0, 1.0, 3.0 },
+        { 12.0, 0.0, 0.0, 0.0, 1.0, 0.5, 3.0 },
+    };
+    const char *names[] = { "render, radius 2.5 at 2x", "render, radius 2.5 at 3x", "render, radius 12 at 3x" };
+
+    for ( int c=0 ; c<3 ; c++ )
+    {
+        SWRevealShadowImage image;
+        double start = SWBenchNow();
+        for ( long i=0 ; i<iterations ; i++ )
+        {
+            SWRevealShadowImageRender( &image, &configs[c] );
+            SWBenchSink = image.pixels[image.width*2];
+            SWRevealShadowImageFree( &image );
+        }
+        SWBenchReport( names[c], SWBenchNow()-start, iterations );
+    }
+
+    SWRevealShadowCache cache;
+    SWRevealShadowCacheInit( &cache );
+    long lookups = iterations*100;
+    double start = SWBenchNow();
+    for ( long i=0 ; i<lookups ; i++ )
+        SWBenchSink = SWRevealShadowCacheGetImage( &cache, &configs[i % 3] )->width;
+    SWBenchReport( "cache lookup", SWBenchNow()-start, lookups );
+    SWRevealShadowCacheFree( &cache );
+    return 0;
+}
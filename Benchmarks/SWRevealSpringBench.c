@@ -0,0 +1,60 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealSpring.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 1000000 );
+    double tolerance = SWRevealSpringDefaultTolerance;
+
+    // the work done when a position animation starts, for release velocities across the usual range
+    const double dampingRatios[] = { 0.5, 1.0, 2.0 };
+    const char *names[] = { "start, underdamped", "start, critically damped", "start, overdamped" };
+    for ( int c=0 ; c<3 ; c++ )
+    {
+        double start = SWBenchNow();
+        for ( long i=0 ; i<iterations ; i++ )
+        {
+            double angularFrequency = SWRevealSpringAngularFrequencyForSettlingTime( dampingRatios[c], 0.3, tolerance );
+            SWRevealSpring spring;
+            SWRevealSpringInit( &spring, dampingRatios[c], angularFrequency, 1.0, (i % 41) - 20.0 );
+            SWBenchSink = SWRevealSpringSettlingTime( &spring, tolerance );
+        }
+        SWBenchReport( names[c], SWBenchNow()-start, iterations );
+    }
+
+    // evaluation on every display link frame
+    SWRevealSpring spring;
+    SWRevealSpringInit( &spring, 0.7, SWRevealSpringAngularFrequencyForSettlingTime( 0.7, 0.3, tolerance ), 1.0, 4.0 );
+    long frames = iterations*10;
+    double start = SWBenchNow();
+    for ( long i=0 ; i<frames ; i++ )
+        SWBenchSink = SWRevealSpringPosition( &spring, (i & 1023)/3000.0 );
+    SWBenchReport( "SWRevealSpringPosition", SWBenchNow()-start, frames );
+    return 0;
+}
@@ -0,0 +1,64 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <string.h>
+
+#include "SWRevealStateCodec.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 5000000 );
+
+    SWRevealState state;
+    memset( &state, 0, sizeof state );
+    state.rearViewRevealWidth = 260.0;
+    state.toggleAnimationDuration = 0.3;
+    state.flags = SWRevealStateBounceBackOnOverdraw;
+    state.frontViewPosition = 4;
+
+    unsigned char bytes[256];
+    size_t length = 0;
+    double start = SWBenchNow();
+    for ( long i=0 ; i<iterations ; i++ )
+    {
+        state.frontViewPosition = (int)(i & 7);
+        length = SWRevealStateEncode( &state, bytes );
+        SWBenchSink = bytes[length-1];
+    }
+    SWBenchReport( "SWRevealStateEncode", SWBenchNow()-start, iterations );
+
+    SWRevealState decoded = state;
+    start = SWBenchNow();
+    for ( long i=0 ; i<iterations ; i++ )
+    {
+        bytes[length-1] = (unsigned char)(i & 7);
+        SWRevealStateDecode( bytes, length, &decoded );
+        SWBenchSink = decoded.frontViewPosition;
+    }
+    SWBenchReport( "SWRevealStateDecode", SWBenchNow()-start, iterations );
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealTransformTracks.h"
+#include "SWRevealBench.h"
+
+
+int main( int argc, char **argv )
+{
+    long iterations = SWBenchIterations( argc, argv, 5000000 );
+
+    // progress moves a little between frames, as it does while dragging or animating
+    SWRevealTrackSet set;
+    SWRevealTrackSetInit( &set );
+    double progress[8], values[8];
+    for ( int k=0 ; k<8 ; k++ ) progress[k] = -1.0 + k*2.0/7, values[k] = k*k;
+
+    SWRevealLayerValues layers[SWRevealTrackLayerCount];
+    const int trackCounts[] = { 1, 4, SWRevealTrackLayerCount*SWRevealTrackPropertyCount };
+    const char *names[] = { "evaluate, 1 track of 8 keyframes", "evaluate, 4 tracks of 8 keyframes", "evaluate, 15 tracks of 8 keyframes" };
+
+    for ( int c=0 ; c<3 ; c++ )
+    {
+        SWRevealTrackSetRemoveAll( &set );
+        for ( int t=0 ; t<trackCounts[c] ; t++ )
+            SWRevealTrackSetAdd( &set, t % SWRevealTrackLayerCount, t / SWRevealTrackLayerCount, progress, values, 8 );
+
+        double start = SWBenchNow();
+        for ( long i=0 ; i<iterations ; i++ )
+        {
+            SWRevealTrackSetEvaluate( &set, 1.2*sin( i*1e-3 ), layers );
+            SWBenchSink = layers[i % SWRevealTrackLayerCount].values[i % SWRevealTrackPropertyCount];
+        }
+        SWBenchReport( names[c], SWBenchNow()-start, iterations );
+    }
+
+    SWRevealTrackSetFree( &set );
+    return 0;
+}
@@ -94,12 +94,9 @@
     // navigation bar as well as a "reveal" button, we also set
     if ( grandParentRevealController )
     {
-        // to present a title, we count the number of ancestor reveal controllers we have, this is of course
-        // only a hack for demonstration purposes, on a real project you would have a model telling this.
-        NSInteger level=0;
-        UIViewController *controller = grandParentRevealController;
-        while( nil != (controller = [controller revealViewController]) )
-            level++;
+        // to present a title, we use the number of ancestor reveal controllers our grand parent has, this is of course
+        // only for demonstration purposes, on a real project you would have a model telling this.
+        NSInteger level = grandParentRevealController.nestingLevel;
         
         NSString *title = [NSString stringWithFormat:@"Detail Level %d", level];
             
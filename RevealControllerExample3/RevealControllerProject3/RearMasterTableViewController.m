@@ -132,53 +132,59 @@
         case 4: text = @"Best Wishes!"; break;
    }
     
-    UIViewController *frontController = nil;
-    switch ( row )
+    // front controllers are cached by row, so that going back to a recently selected row does not rebuild it
+    UIViewController *frontController = [revealController frontViewControllerForKey:@(row) provider:^UIViewController *
     {
-        case 0:
-        case 1:
-        case 2:
+        UIViewController *controller = nil;
+        switch ( row )
         {
-            FrontViewControllerImage *imageController = [[FrontViewControllerImage alloc] init];
-            imageController.image = [UIImage imageNamed:text];
-            frontController = imageController;
-            break;
-        }
+            case 0:
+            case 1:
+            case 2:
+            {
+                FrontViewControllerImage *imageController = [[FrontViewControllerImage alloc] init];
+                imageController.image = [UIImage imageNamed:text];
+                controller = imageController;
+                break;
+            }
         
-        case 3:
-        case 4:
-        {
-            FrontViewControllerLabel *labelController = [[FrontViewControllerLabel alloc] init];
-            labelController.text = text;
-            frontController = labelController;
-            break;
-        }
+            case 3:
+            case 4:
+            {
+                FrontViewControllerLabel *labelController = [[FrontViewControllerLabel alloc] init];
+                labelController.text = text;
+                controller = labelController;
+                break;
+            }
         
-        case 5:
-        {
-            RearTableViewController *rearViewController = [[RearTableViewController alloc] init];
-            FrontViewControllerImage *frontViewController = [[FrontViewControllerImage alloc] init];
-            [frontViewController setImage:[UIImage imageNamed:@"bg_flowers.jpg"]];
+            case 5:
+            {
+                RearTableViewController *rearViewController = [[RearTableViewController alloc] init];
+                FrontViewControllerImage *frontViewController = [[FrontViewControllerImage alloc] init];
+                [frontViewController setImage:[UIImage imageNamed:@"bg_flowers.jpg"]];
     
-            SWRevealViewController *childRevealController =
-                [[SWRevealViewController alloc] initWithRearViewController:rearViewController frontViewController:frontViewController];
+                SWRevealViewController *childRevealController =
+                    [[SWRevealViewController alloc] initWithRearViewController:rearViewController frontViewController:frontViewController];
             
 #define NoRevealOverdraw true
 #if NoRevealOverdraw
-            childRevealController.rearViewRevealWidth = 60;
-            childRevealController.rearViewRevealOverdraw = 120;
-            childRevealController.bounceBackOnOverdraw = NO;
-            childRevealController.stableDragOnOverdraw = YES;
+                childRevealController.rearViewRevealWidth = 60;
+                childRevealController.rearViewRevealOverdraw = 120;
+                childRevealController.bounceBackOnOverdraw = NO;
+                childRevealController.stableDragOnOverdraw = YES;
 #else
-            childRevealController.rearViewRevealWidth = 200;
+                childRevealController.rearViewRevealWidth = 200;
 #endif
-            childRevealController.rearViewRevealDisplacement = 0;
+                childRevealController.rearViewRevealDisplacement = 0;
             
-            [childRevealController setFrontViewPosition:FrontViewPositionRight animated:NO];
-            frontController = childRevealController;
-            break;
+                [childRevealController setFrontViewPosition:FrontViewPositionRight animated:NO];
+                controller = childRevealController;
+                break;
+            }
         }
-    }
+    
+        return controller;
+    }];
     
     if ( row != 5 )
     {
@@ -0,0 +1,255 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <stdlib.h>
+
+#include "SWRevealCommandQueue.h"
+
+
+/* Helpers */
+
+static inline SWRevealCommand *commandAt( SWRevealCommandQueue *queue, unsigned int i )
+{
+    return &queue->commands[(queue->head + i) & (queue->capacity - 1)];
+}
+
+
+// Doubles the ring, or allocates it, moving the commands to the start of the new one. Returns 0 on success or -1
+static int growQueue( SWRevealCommandQueue *queue )
+{
+    unsigned int capacity = queue->capacity > 0 ? 2*queue->capacity : SWRevealCommandQueueInitialCapacity;
+    if ( capacity < queue->capacity )
+        return -1;
+
+    SWRevealCommand *commands = malloc( capacity*sizeof *commands );
+    if ( commands == NULL )
+        return -1;
+
+    for ( unsigned int i=0 ; i<queue->count ; i++ )
+        commands[i] = *commandAt( queue, i );
+
+    free( queue->commands );
+    queue->commands = commands;
+    queue->capacity = capacity;
+    queue->head = 0;
+    return 0;
+}
+
+
+static void releaseCommand( SWRevealCommandQueue *queue, SWRevealCommand *command )
+{
+    if ( command->object && queue->releaseObject )
+        queue->releaseObject( command->object );
+
+    command->object = NULL;
+}
+
+
+// Removes the pending commands for which 'discard' returns non zero, keeping the order of the remaining ones
+static unsigned int removePending( SWRevealCommandQueue *queue, int (*discard)(const SWRevealCommand*, unsigned int), unsigned int keepGroup )
+{
+    unsigned int removed = 0;
+    unsigned int dst = 1;
+
+    for ( unsigned int src=1 ; src<queue->count ; src++ )
+    {
+        SWRevealCommand *command = commandAt( queue, src );
+        if ( discard( command, keepGroup ) )
+        {
+            releaseCommand( queue, command );
+            removed += 1;
+            continue;
+        }
+
+        if ( dst != src ) *commandAt( queue, dst ) = *command;
+        dst += 1;
+    }
+
+    queue->count -= removed;
+    return removed;
+}
+
+
+static int isNotStartedGroup( const SWRevealCommand *command, unsigned int runningGroup )
+{
+    return command->group != 0 && command->group != runningGroup;
+}
+
+
+static int isNotInGroup( const SWRevealCommand *command, unsigned int runningGroup )
+{
+    return runningGroup == 0 || command->group != runningGroup;
+}
+
+
+static int isStandalonePosition( const SWRevealCommand *command, unsigned int runningGroup )
+{
+    (void)runningGroup;
+    return command->type == SWRevealCommandSetPosition && command->group == 0;
+}
+
+
+static unsigned int runningGroup( SWRevealCommandQueue *queue )
+{
+    return queue->count > 0 ? commandAt( queue, 0 )->group : 0;
+}
+
+
+/* Queue */
+
+void SWRevealCommandQueueInit( SWRevealCommandQueue *queue, SWRevealCommandReleaseFunction releaseObject )
+{
+    queue->commands = NULL;
+    queue->capacity = 0;
+    queue->head = 0;
+    queue->count = 0;
+    queue->lastGroup = 0;
+    queue->releaseObject = releaseObject;
+}
+
+
+void SWRevealCommandQueueClear( SWRevealCommandQueue *queue )
+{
+    for ( unsigned int i=0 ; i<queue->count ; i++ )
+        releaseCommand( queue, commandAt( queue, i ) );
+
+    queue->head = 0;
+    queue->count = 0;
+}
+
+
+void SWRevealCommandQueueFree( SWRevealCommandQueue *queue )
+{
+    SWRevealCommandQueueClear( queue );
+    free( queue->commands );
+    queue->commands = NULL;
+    queue->capacity = 0;
+}
+
+
+unsigned int SWRevealCommandQueueNewGroup( SWRevealCommandQueue *queue )
+{
+    queue->lastGroup += 1;
+    if ( queue->lastGroup == 0 ) queue->lastGroup = 1;
+    return queue->lastGroup;
+}
+
+
+SWRevealCommandEnqueueResult SWRevealCommandQueueEnqueue( SWRevealCommandQueue *queue, const SWRevealCommand *command )
+{
+    if ( queue->count > 1 )
+    {
+        // a new group supersedes pending groups that did not start yet
+        if ( command->group != 0 && command->group != commandAt( queue, queue->count-1 )->group )
+            removePending( queue, isNotStartedGroup, runningGroup( queue ) );
+
+        // consecutive position changes collapse into the last target
+        SWRevealCommand *last = commandAt( queue, queue->count-1 );
+        if ( queue->count > 1 && command->type == SWRevealCommandSetPosition && command->group == 0 &&
+            last->type == SWRevealCommandSetPosition && last->group == 0 )
+        {
+            last->position = command->position;
+            last->duration = command->duration;
+            last->detent = command->detent;
+            return SWRevealCommandCoalesced;
+        }
+    }
+
+    if ( queue->count == queue->capacity && growQueue( queue ) != 0 )
+    {
+        SWRevealCommand discarded = *command;
+        releaseCommand( queue, &discarded );
+        return SWRevealCommandOverflow;
+    }
+
+    *commandAt( queue, queue->count ) = *command;
+    queue->count += 1;
+
+    return queue->count == 1 ? SWRevealCommandExecuteNow : SWRevealCommandQueued;
+}
+
+
+const SWRevealCommand *SWRevealCommandQueueFront( const SWRevealCommandQueue *queue )
+{
+    if ( queue->count == 0 ) return NULL;
+    return commandAt( (SWRevealCommandQueue *)queue, 0 );
+}
+
+
+SWRevealCommand *SWRevealCommandQueuePendingAtIndex( SWRevealCommandQueue *queue, unsigned int index )
+{
+    if ( index+1 >= queue->count ) return NULL;
+    return commandAt( queue, index+1 );
+}
+
+
+const SWRevealCommand *SWRevealCommandQueueDequeue( SWRevealCommandQueue *queue )
+{
+    if ( queue->count == 0 ) return NULL;
+
+    releaseCommand( queue, commandAt( queue, 0 ) );
+    queue->head = (queue->head + 1) & (queue->capacity - 1);
+    queue->count -= 1;
+
+    return SWRevealCommandQueueFront( queue );
+}
+
+
+unsigned int SWRevealCommandQueueCancelPending( SWRevealCommandQueue *queue )
+{
+    return removePending( queue, isNotInGroup, runningGroup( queue ) );
+}
+
+
+int SWRevealCommandQueueCanInterrupt( SWRevealCommandQueue *queue )
+{
+    if ( queue->count == 0 ) return 0;
+
+    const SWRevealCommand *front = commandAt( queue, 0 );
+    if ( front->type != SWRevealCommandSetPosition ) return 0;
+
+    for ( unsigned int i=1 ; front->group != 0 && i<queue->count ; i++ )
+        if ( commandAt( queue, i )->group == front->group ) return 0;
+
+    return 1;
+}
+
+
+unsigned int SWRevealCommandQueueInterrupt( SWRevealCommandQueue *queue, const SWRevealCommand *command )
+{
+    if ( queue->count == 0 ) return 0;
+
+    SWRevealCommand *front = commandAt( queue, 0 );
+    releaseCommand( queue, front );
+    *front = *command;
+
+    return removePending( queue, isStandalonePosition, front->group );
+}
+
+
+unsigned int SWRevealCommandQueueCount( const SWRevealCommandQueue *queue )
+{
+    return queue->count;
+}
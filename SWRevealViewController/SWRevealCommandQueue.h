@@ -0,0 +1,143 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealCommandQueue
+
+ Portable typed command queue for SWRevealViewController. Position changes and controller replacements requested
+ while an animation is in progress are stored on a ring buffer that grows as needed, and executed in order. Pending
+ commands made obsolete by later ones are coalesced: consecutive position changes collapse into a single target, and a
+ pending push is dropped when a later push supersedes it. The queue does not execute anything itself, it just tells the owner
+ which command must be executed next.
+
+*/
+
+#ifndef SWRevealCommandQueue_h
+#define SWRevealCommandQueue_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Command types
+typedef enum
+{
+    SWRevealCommandSetPosition,     // <-- animates to 'position' with 'duration', resting at 'detent' if not zero
+    SWRevealCommandTransition,      // <-- replaces the controller for 'operation' with 'object'
+    SWRevealCommandGesture,         // <-- holds the queue while a gesture is in progress
+    SWRevealCommandBatch,           // <-- performs the replacements and position change held by 'object' as a single transition
+
+} SWRevealCommandType;
+
+// A queued command. Commands sharing a non zero 'group' are executed as a unit, this is used for the
+// steps of a push. 'object' is owned by the queue and released through its release function when the command
+// is removed, pass NULL if not used
+typedef struct
+{
+    SWRevealCommandType type;
+    unsigned int group;
+    int position;
+    double duration;
+    int operation;
+    int animated;
+    void *object;
+    int detent;
+
+} SWRevealCommand;
+
+// Number of commands the ring is allocated for on the first enqueue, it doubles whenever it fills up. Coalescing keeps
+// the queue short in practice
+#define SWRevealCommandQueueInitialCapacity 16
+
+typedef void (*SWRevealCommandReleaseFunction)( void *object );
+
+// The queue. The first command is the one being executed, if any
+typedef struct
+{
+    SWRevealCommand *commands;      // <-- ring of 'capacity' commands, a power of two, NULL until the first enqueue
+    unsigned int capacity;
+    unsigned int head;
+    unsigned int count;
+    unsigned int lastGroup;
+    SWRevealCommandReleaseFunction releaseObject;
+
+} SWRevealCommandQueue;
+
+// Enqueue results
+typedef enum
+{
+    SWRevealCommandQueued,          // <-- the command was added to the queue and will be executed later
+    SWRevealCommandCoalesced,       // <-- the command was merged with a pending one
+    SWRevealCommandExecuteNow,      // <-- the queue was empty, the caller must execute the command right away
+    SWRevealCommandOverflow,        // <-- the queue could not grow, the command was discarded and its object released
+
+} SWRevealCommandEnqueueResult;
+
+
+// Initializes an empty queue
+void SWRevealCommandQueueInit( SWRevealCommandQueue *queue, SWRevealCommandReleaseFunction releaseObject );
+
+// Removes all commands, including the one being executed
+void SWRevealCommandQueueClear( SWRevealCommandQueue *queue );
+
+// Removes all commands and releases the queue memory
+void SWRevealCommandQueueFree( SWRevealCommandQueue *queue );
+
+// Returns a new group identifier for commands that must be executed as a unit
+unsigned int SWRevealCommandQueueNewGroup( SWRevealCommandQueue *queue );
+
+// Enqueues a command coalescing it with pending ones when possible. Commands starting a new group
+// supersede any pending group that has not started yet
+SWRevealCommandEnqueueResult SWRevealCommandQueueEnqueue( SWRevealCommandQueue *queue, const SWRevealCommand *command );
+
+// Returns the command being executed, or NULL if the queue is empty
+const SWRevealCommand *SWRevealCommandQueueFront( const SWRevealCommandQueue *queue );
+
+// Returns the pending command at 'index', index zero being the first after the one being executed, or NULL
+SWRevealCommand *SWRevealCommandQueuePendingAtIndex( SWRevealCommandQueue *queue, unsigned int index );
+
+// Removes the command being executed and returns the next one, which must be executed by the caller, or NULL
+const SWRevealCommand *SWRevealCommandQueueDequeue( SWRevealCommandQueue *queue );
+
+// Removes all pending commands except the ones belonging to the group being executed. Returns the number of removed commands
+unsigned int SWRevealCommandQueueCancelPending( SWRevealCommandQueue *queue );
+
+// Returns non zero if the command being executed is a position change that can be interrupted,
+// that is, it is not followed by pending commands of its own group
+int SWRevealCommandQueueCanInterrupt( SWRevealCommandQueue *queue );
+
+// Replaces the command being executed by 'command' and removes pending position changes that do not belong to a group,
+// these are superseded by the position where the interrupting command leaves the front view. Returns the number of removed commands
+unsigned int SWRevealCommandQueueInterrupt( SWRevealCommandQueue *queue, const SWRevealCommand *command );
+
+// Returns the number of commands, including the one being executed
+unsigned int SWRevealCommandQueueCount( const SWRevealCommandQueue *queue );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,250 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealCurveSampler.h"
+
+
+/* Initialization */
+
+void SWRevealCurveInitEaseOut( SWRevealCurve *curve, double duration )
+{
+    curve->type = SWRevealCurveEaseOut;
+    curve->duration = duration;
+    curve->x1 = 0.0, curve->y1 = 0.0;
+    curve->x2 = 0.58, curve->y2 = 1.0;
+    SWRevealSpringInit( &curve->spring, 1.0, 0.0, 1.0, 0.0 );
+}
+
+
+void SWRevealCurveInitSpring( SWRevealCurve *curve, double dampingRatio, double angularFrequency, double velocity, double duration )
+{
+    curve->type = SWRevealCurveSpring;
+    curve->duration = duration;
+    curve->x1 = curve->y1 = curve->x2 = curve->y2 = 0.0;
+    SWRevealSpringInit( &curve->spring, dampingRatio, angularFrequency, 1.0, velocity );
+}
+
+
+/* Bezier */
+
+// polynomial coefficients of one bezier coordinate, value is ((a*u + b)*u + c)*u
+static void bezierCoefficients( double p1, double p2, double *a, double *b, double *c )
+{
+    *c = 3.0*p1;
+    *b = 3.0*(p2-p1) - *c;
+    *a = 1.0 - *c - *b;
+}
+
+
+// Solves the bezier parameter for the horizontal coordinate x. Newton iterations start from 'seed', bisection over
+// [lo, 1] takes over where the slope vanishes, as it does at the start of the ease out curve
+static double bezierSolve( const SWRevealCurve *curve, double x, double seed, double lo )
+{
+    double ax, bx, cx;
+    bezierCoefficients( curve->x1, curve->x2, &ax, &bx, &cx );
+
+    double u = seed;
+    for ( int i=0 ; i<8 ; i++ )
+    {
+        double error = ((ax*u + bx)*u + cx)*u - x;
+        if ( fabs(error) < 1e-9 )
+            return u;
+
+        double slope = (3.0*ax*u + 2.0*bx)*u + cx;
+        if ( fabs(slope) < 1e-6 )
+            break;
+
+        u -= error/slope;
+        if ( u < lo || u > 1.0 )
+            break;
+    }
+
+    double hi = 1.0;
+    u = lo;
+    for ( int i=0 ; i<64 && hi-lo > 1e-12 ; i++ )
+    {
+        u = 0.5*(lo+hi);
+        if ( ((ax*u + bx)*u + cx)*u < x ) lo = u;
+        else hi = u;
+    }
+    return u;
+}
+
+
+static double bezierValue( const SWRevealCurve *curve, double u )
+{
+    double ay, by, cy;
+    bezierCoefficients( curve->y1, curve->y2, &ay, &by, &cy );
+    return ((ay*u + by)*u + cy)*u;
+}
+
+
+/* Evaluation */
+
+double SWRevealCurveValue( const SWRevealCurve *curve, double t )
+{
+    if ( !(t < curve->duration) )
+        return 1.0;
+
+    if ( t <= 0.0 )
+        t = 0.0;
+
+    if ( curve->type == SWRevealCurveSpring )
+        return SWRevealSpringPosition( &curve->spring, t );
+
+    double x = t/curve->duration;
+    return bezierValue( curve, bezierSolve( curve, x, x, 0.0 ) );
+}
+
+
+// index of the first sample at the curve duration, a sample that falls short of it by a rounding error counts as there
+static double durationIndex( const SWRevealCurve *curve, double frameInterval )
+{
+    if ( !(curve->duration > 0.0) || !(frameInterval > 0.0) )
+        return 0.0;
+
+    return ceil( curve->duration/frameInterval - 1e-9 );
+}
+
+
+int SWRevealCurveFitsSamples( const SWRevealCurve *curve, double frameInterval )
+{
+    return durationIndex( curve, frameInterval ) < SWRevealCurveMaxSamples;
+}
+
+
+int SWRevealCurveSampleCount( const SWRevealCurve *curve, double frameInterval )
+{
+    double frames = durationIndex( curve, frameInterval );
+    return frames < SWRevealCurveMaxSamples-1 ? (int)frames + 1 : SWRevealCurveMaxSamples;
+}
+
+
+/* Batch sampling */
+
+// Rounding errors of the stepped exponentials and rotations build up with the number of steps,
+// so spring states are evaluated exactly again every this many samples
+#define SWRevealCurveReseedInterval 64
+
+static void sampleEaseOut( const SWRevealCurve *curve, double frameInterval, double *values, int count )
+{
+    // x grows with t and u grows with x, so each solve is bounded below by the previous one and
+    // seeded by extrapolating the last two
+    double u = 0.0, du = 0.0;
+    for ( int i=0 ; i<count ; i++ )
+    {
+        double x = i*frameInterval/curve->duration;
+        double seed = fmin( u + du, 1.0 );
+        double next = bezierSolve( curve, x, seed, u );
+        du = next - u;
+        u = next;
+        values[i] = bezierValue( curve, u );
+    }
+}
+
+
+static void sampleSpring( const SWRevealCurve *curve, double frameInterval, double *values, int count )
+{
+    const SWRevealSpring *spring = &curve->spring;
+    double a = spring->a, b = spring->b;
+    double h = frameInterval;
+
+    switch ( spring->regime )
+    {
+        case SWRevealSpringUnderdamped:
+        {
+            double stepDecay = exp(-spring->rateA*h);
+            double stepCos = cos(spring->rateB*h), stepSin = sin(spring->rateB*h);
+            double decay = 1.0, c = 1.0, s = 0.0;
+            for ( int i=0 ; i<count ; i++ )
+            {
+                if ( i % SWRevealCurveReseedInterval == 0 )
+                {
+                    double t = i*h;
+                    decay = exp(-spring->rateA*t);
+                    c = cos(spring->rateB*t), s = sin(spring->rateB*t);
+                }
+                values[i] = spring->distance + decay*(a*c + b*s);
+                double nc = c*stepCos - s*stepSin;
+                s = s*stepCos + c*stepSin;
+                c = nc;
+                decay *= stepDecay;
+            }
+            break;
+        }
+        case SWRevealSpringCriticallyDamped:
+        {
+            double stepDecay = exp(-spring->rateA*h);
+            double decay = 1.0;
+            for ( int i=0 ; i<count ; i++ )
+            {
+                double t = i*h;
+                if ( i % SWRevealCurveReseedInterval == 0 )
+                    decay = exp(-spring->rateA*t);
+                values[i] = spring->distance + decay*(a + b*t);
+                decay *= stepDecay;
+            }
+            break;
+        }
+        case SWRevealSpringOverdamped:
+        {
+            double stepA = exp(spring->rateA*h), stepB = exp(spring->rateB*h);
+            double ea = 1.0, eb = 1.0;
+            for ( int i=0 ; i<count ; i++ )
+            {
+                if ( i % SWRevealCurveReseedInterval == 0 )
+                {
+                    double t = i*h;
+                    ea = exp(spring->rateA*t), eb = exp(spring->rateB*t);
+                }
+                values[i] = spring->distance + a*ea + b*eb;
+                ea *= stepA;
+                eb *= stepB;
+            }
+            break;
+        }
+    }
+}
+
+
+void SWRevealCurveSample( const SWRevealCurve *curve, double frameInterval, double *values, int count )
+{
+    if ( count <= 0 )
+        return;
+
+    // samples at or past the duration are not computed
+    double frames = durationIndex( curve, frameInterval );
+    int active = frames < count ? (int)frames : count;
+
+    if ( curve->type == SWRevealCurveSpring )
+        sampleSpring( curve, frameInterval, values, active );
+    else
+        sampleEaseOut( curve, frameInterval, values, active );
+
+    for ( int i=active ; i<count ; i++ )
+        values[i] = 1.0;
+}
@@ -0,0 +1,96 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+/*
+
+ SWRevealCurveSampler
+
+ Portable timing curves for SWRevealViewController animations driven frame by frame. A curve maps the time elapsed since
+ the start of an animation to its progress, from 0 to 1, and can be the cubic bezier ease out curve used by UIKit or a
+ damped spring. Curves are sampled in batches at a fixed frame interval: springs step their exponentials and rotations by
+ constant factors instead of evaluating them for each sample, and bezier curves seed each solve with the previous one.
+ Nothing is allocated while sampling.
+
+*/
+
+#ifndef SWRevealCurveSampler_h
+#define SWRevealCurveSampler_h
+
+#include "SWRevealSpring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of samples taken by SWRevealCurveSampleCount, about 8 seconds at 120 Hz. Longer curves are evaluated
+// with SWRevealCurveValue on each frame instead, see SWRevealCurveFitsSamples
+#define SWRevealCurveMaxSamples 1024
+
+// Curve types
+typedef enum
+{
+    SWRevealCurveEaseOut,
+    SWRevealCurveSpring,
+
+} SWRevealCurveType;
+
+// Timing curve. Progress is 1 at 'duration' and after it
+typedef struct
+{
+    SWRevealCurveType type;
+    double duration;            // <-- in seconds
+    double x1, y1, x2, y2;      // <-- bezier control points, ease out curves only
+    SWRevealSpring spring;      // <-- unit journey spring, spring curves only
+
+} SWRevealCurve;
+
+
+// Initializes the ease out curve of UIKit animations, a cubic bezier with control points (0, 0) and (0.58, 1)
+void SWRevealCurveInitEaseOut( SWRevealCurve *curve, double duration );
+
+// Initializes a spring curve over a unit journey. 'velocity' is the initial velocity in journeys per second. Springs
+// are not exactly settled at 'duration', progress jumps to 1 there
+void SWRevealCurveInitSpring( SWRevealCurve *curve, double dampingRatio, double angularFrequency, double velocity, double duration );
+
+// Returns the progress at time t. Springs may return values outside 0 to 1 when they overshoot
+double SWRevealCurveValue( const SWRevealCurve *curve, double t );
+
+// Returns non zero if SWRevealCurveMaxSamples samples cover the curve duration at 'frameInterval'
+int SWRevealCurveFitsSamples( const SWRevealCurve *curve, double frameInterval );
+
+// Returns the number of samples needed to cover the curve duration at 'frameInterval', including both ends. This is
+// clamped to SWRevealCurveMaxSamples, so the samples of a curve that does not fit only cover its beginning
+int SWRevealCurveSampleCount( const SWRevealCurve *curve, double frameInterval );
+
+// Fills 'values' with the progress at times i*frameInterval for i from 0 to count-1. Samples at or after the curve
+// duration, up to rounding errors, are exactly 1
+void SWRevealCurveSample( const SWRevealCurve *curve, double frameInterval, double *values, int count );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
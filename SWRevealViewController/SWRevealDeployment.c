@@ -0,0 +1,70 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealDeployment.h"
+
+
+/* Rules */
+
+void SWRevealFrontDeploymentStep( int position, int newPosition, int hasRear, int hasRight, SWRevealDeploymentStep *step )
+{
+    if ( (!hasRight && newPosition < SWRevealPositionLeft) || (!hasRear && newPosition > SWRevealPositionLeft) )
+        newPosition = SWRevealPositionLeft;
+
+    step->position = newPosition;
+
+    step->appear =
+        (position >= SWRevealPositionRightMostRemoved || position <= SWRevealPositionLeftSideMostRemoved || position == SWRevealPositionNone) &&
+        (newPosition < SWRevealPositionRightMostRemoved && newPosition > SWRevealPositionLeftSideMostRemoved);
+
+    step->disappear =
+        (newPosition >= SWRevealPositionRightMostRemoved || newPosition <= SWRevealPositionLeftSideMostRemoved) &&
+        (position < SWRevealPositionRightMostRemoved && position > SWRevealPositionLeftSideMostRemoved && position != SWRevealPositionNone);
+}
+
+
+void SWRevealRearDeploymentStep( int position, int newPosition, int hasRear, int hierarchical, SWRevealDeploymentStep *step )
+{
+    if ( hierarchical )
+        newPosition = SWRevealPositionRight;
+
+    if ( !hasRear && newPosition > SWRevealPositionLeft )
+        newPosition = SWRevealPositionLeft;
+
+    step->position = newPosition;
+    step->appear = (position <= SWRevealPositionLeft || position == SWRevealPositionNone) && newPosition > SWRevealPositionLeft;
+    step->disappear = newPosition <= SWRevealPositionLeft && (position > SWRevealPositionLeft && position != SWRevealPositionNone);
+}
+
+
+void SWRevealRightDeploymentStep( int position, int newPosition, int hasRight, SWRevealDeploymentStep *step )
+{
+    if ( !hasRight && newPosition < SWRevealPositionLeft )
+        newPosition = SWRevealPositionLeft;
+
+    step->position = newPosition;
+    step->appear = (position >= SWRevealPositionLeft || position == SWRevealPositionNone) && newPosition < SWRevealPositionLeft;
+    step->disappear = newPosition >= SWRevealPositionLeft && (position < SWRevealPositionLeft && position != SWRevealPositionNone);
+}
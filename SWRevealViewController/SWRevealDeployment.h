@@ -0,0 +1,66 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+/*
+
+ SWRevealDeployment
+
+ Portable SWRevealViewController deployment rules. For each position change the rules decide which of the
+ front, rear and right controller views appear and disappear, including the FrontViewPositionNone and ...Removed cases.
+ SWRevealViewController uses them directly, and the deployment model in Tools replays them headlessly.
+
+*/
+
+#ifndef SWRevealDeployment_h
+#define SWRevealDeployment_h
+
+#include "SWRevealGeometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// No position, this mirrors FrontViewPositionNone. Views are loaded again when moving from it
+#define SWRevealPositionNone 0xff
+
+// Deployment decision for one of the controllers
+typedef struct
+{
+    int position;   // <-- the new position, adjusted for missing controllers
+    int appear;     // <-- the controller view must be added to its container
+    int disappear;  // <-- the controller view must be removed from its container once the animation completes
+
+} SWRevealDeploymentStep;
+
+// Decides the deployment of the front, rear and right controllers for a change from 'position' to 'newPosition'.
+// 'position' is the last position the controller was deployed for, or SWRevealPositionNone
+void SWRevealFrontDeploymentStep( int position, int newPosition, int hasRear, int hasRight, SWRevealDeploymentStep *step );
+void SWRevealRearDeploymentStep( int position, int newPosition, int hasRear, int hierarchical, SWRevealDeploymentStep *step );
+void SWRevealRightDeploymentStep( int position, int newPosition, int hasRight, SWRevealDeploymentStep *step );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,152 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+#include "SWRevealDetents.h"
+#include "SWRevealFlingPredictor.h"
+
+
+/* Stops */
+
+int SWRevealDetentSideInit( SWRevealDetentSide *side, const double *offsets, unsigned int count, double thresholdFraction )
+{
+    side->count = 0;
+    if ( count+1 > SWRevealDetentCapacity )
+        return -1;
+
+    for ( unsigned int i=0 ; i<count ; i++ )
+    {
+        double previous = i>0 ? offsets[i-1] : 0.0;
+        if ( !(offsets[i] > previous) )
+            return -1;
+    }
+
+    if ( !(thresholdFraction >= 0.0 && thresholdFraction <= 1.0) )
+        thresholdFraction = 0.5;
+
+    side->offsets[0] = 0.0;
+    for ( unsigned int i=0 ; i<count ; i++ )
+    {
+        side->offsets[i+1] = offsets[i];
+        side->thresholds[i] = side->offsets[i] + (offsets[i]-side->offsets[i])*thresholdFraction;
+    }
+
+    side->count = count+1;
+    return 0;
+}
+
+
+void SWRevealDetentSideInitWithRevealWidth( SWRevealDetentSide *side, double revealWidth, double revealOverdraw )
+{
+    double offsets[2] = { revealWidth, revealWidth+revealOverdraw };
+    unsigned int count = revealOverdraw > 0.0 ? 2 : 1;
+    if ( SWRevealDetentSideInit( side, offsets, count, 0.5 ) != 0 )
+    {
+        // degenerate widths just leave the closed location
+        side->offsets[0] = 0.0;
+        side->count = 1;
+    }
+}
+
+
+unsigned int SWRevealDetentSideIndexForOffset( const SWRevealDetentSide *side, double offset )
+{
+    if ( side->count == 0 )
+        return 0;
+
+    // number of thresholds not above the offset
+    unsigned int low = 0, high = side->count-1;
+    while ( low < high )
+    {
+        unsigned int mid = (low+high)/2;
+        if ( side->thresholds[mid] <= offset ) low = mid+1;
+        else high = mid;
+    }
+    return low;
+}
+
+
+/* Detents */
+
+int SWRevealDetentsSnap( const SWRevealDetents *detents, double x, double velocity, double decelerationRate, double *pTarget )
+{
+    int symetry = x<0 ? -1 : 1;
+    const SWRevealDetentSide *side = &detents->sides[symetry<0 ? 0 : 1];
+
+    double projectedLocation = x + SWRevealFlingProjectedDistance( velocity, decelerationRate );
+    unsigned int index = SWRevealDetentSideIndexForOffset( side, projectedLocation*symetry );
+
+    *pTarget = side->count > 0 ? side->offsets[index]*symetry : 0.0;
+    return (int)index*symetry;
+}
+
+
+double SWRevealDetentsLocation( const SWRevealDetents *detents, int detent )
+{
+    int symetry = detent<0 ? -1 : 1;
+    const SWRevealDetentSide *side = &detents->sides[symetry<0 ? 0 : 1];
+    if ( side->count == 0 )
+        return 0.0;
+
+    unsigned int index = (unsigned int)(detent*symetry);
+    if ( index > side->count-1 ) index = side->count-1;
+    return side->offsets[index]*symetry;
+}
+
+
+double SWRevealDetentsProgress( const SWRevealDetents *detents, double x )
+{
+    int symetry = x<0 ? -1 : 1;
+    const SWRevealDetentSide *side = &detents->sides[symetry<0 ? 0 : 1];
+    double offset = x*symetry;
+    if ( side->count < 2 )
+        return 0.0;
+
+    unsigned int last = side->count-1;
+    if ( offset >= side->offsets[last] )
+        return (double)last*symetry;
+
+    // last stop not above the offset
+    unsigned int low = 0, high = last;
+    while ( high-low > 1 )
+    {
+        unsigned int mid = (low+high)/2;
+        if ( side->offsets[mid] <= offset ) low = mid;
+        else high = mid;
+    }
+
+    double fraction = (offset-side->offsets[low])/(side->offsets[low+1]-side->offsets[low]);
+    return (low+fraction)*symetry;
+}
+
+
+SWRevealPosition SWRevealDetentsPresetPosition( int detent )
+{
+    int symetry = detent<0 ? -1 : 1;
+    SWRevealPosition position = SWRevealPositionLeft;
+    if ( detent*symetry == 1 ) position = SWRevealPositionRight;
+    if ( detent*symetry >= 2 ) position = SWRevealPositionRightMost;
+    return SWRevealAdjustedPosition( position, symetry );
+}
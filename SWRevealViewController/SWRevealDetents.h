@@ -0,0 +1,102 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+/*
+
+ SWRevealDetents
+
+ Portable detent engine for SWRevealViewController. Each side has a sorted list of stops, offsets of the front view
+ from its closed location, with precomputed snapping thresholds between consecutive stops. A release picks its stop
+ with a binary search of the thresholds for the location where the fling would come to rest, and any drag location
+ maps to a fractional progress between two stops.
+
+ Detents are signed indexes: 0 is the closed location, positive values are rear stops and negative values are right
+ stops. The stops equivalent to the FrontViewPosition values are provided as a preset.
+
+*/
+
+#ifndef SWRevealDetents_h
+#define SWRevealDetents_h
+
+#include "SWRevealGeometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of stops per side, including the closed location
+#define SWRevealDetentCapacity 16
+
+// Stops of a side
+typedef struct
+{
+    double offsets[SWRevealDetentCapacity];     // <-- ascending, offsets[0] is always 0
+    double thresholds[SWRevealDetentCapacity];  // <-- thresholds[i] separates offsets[i] and offsets[i+1]
+    unsigned int count;
+
+} SWRevealDetentSide;
+
+// Stops of both sides, right (0) and rear (1). A side with no stops always snaps closed
+typedef struct
+{
+    SWRevealDetentSide sides[2];
+
+} SWRevealDetents;
+
+
+// Sets the stops of a side from 'count' ascending positive offsets, the closed location is added in front of them.
+// Thresholds are placed at 'thresholdFraction' of the distance between consecutive stops, 0.5 puts them halfway.
+// Returns 0 on success, or -1 if the offsets are not ascending and positive or there are too many, in which case
+// the side is left with no stops
+int SWRevealDetentSideInit( SWRevealDetentSide *side, const double *offsets, unsigned int count, double thresholdFraction );
+
+// Sets the stops equivalent to the FrontViewPosition values: closed, revealWidth and revealWidth+revealOverdraw.
+// These snap halfway between stops, so unlike the default release decisions a fling can rest on the overdraw stop
+// without being dragged past revealWidth, and the bounce back and stable drag rules do not apply
+void SWRevealDetentSideInitWithRevealWidth( SWRevealDetentSide *side, double revealWidth, double revealOverdraw );
+
+// Returns the index of the stop a side snaps to for a resting 'offset' (symetry adjusted)
+unsigned int SWRevealDetentSideIndexForOffset( const SWRevealDetentSide *side, double offset );
+
+// Returns the detent for a release at location x with the given velocity, in points per second, and the detent
+// location in 'pTarget'. The resting location of the fling is projected with 'decelerationRate', see SWRevealFlingPredictor.h
+int SWRevealDetentsSnap( const SWRevealDetents *detents, double x, double velocity, double decelerationRate, double *pTarget );
+
+// Returns the location of a detent, detents past the last stop of a side are clamped to it
+double SWRevealDetentsLocation( const SWRevealDetents *detents, int detent );
+
+// Returns the fractional detent at location x, for example 1.25 is a quarter of the way from rear stop 1 to rear stop 2
+// and -0.5 is halfway from the closed location to right stop 1. Locations past the last stop return its detent
+double SWRevealDetentsProgress( const SWRevealDetents *detents, double x );
+
+// Returns the position of a detent of the preset stops
+SWRevealPosition SWRevealDetentsPresetPosition( int detent );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealDragResistance.h"
+
+
+/* Curves */
+
+// Normalized overshoot range covered by the table for asymptotic curves, values are held beyond it
+static const double kAsymptoticCurveDomain = 8.0;
+
+
+static double curveParameter( const SWRevealResistanceCurve *curve )
+{
+    if ( curve->parameter > 0 ) return curve->parameter;
+
+    switch ( curve->type )
+    {
+        case SWRevealResistanceCurveRubberBand: return 0.55;
+        case SWRevealResistanceCurveExponential: return 1.0;
+        default: return 0.5;
+    }
+}
+
+
+static double curveDomain( const SWRevealResistanceCurve *curve )
+{
+    if ( curve->type == SWRevealResistanceCurveLinearClamp || (curve->type == SWRevealResistanceCurveCustom && !curve->function) )
+        return 1.0/curveParameter( curve );
+
+    return kAsymptoticCurveDomain;
+}
+
+
+static double curveValue( const SWRevealResistanceCurve *curve, double u )
+{
+    double k = curveParameter( curve );
+    double v;
+
+    switch ( curve->type )
+    {
+        case SWRevealResistanceCurveRubberBand:
+            v = 1.0 - 1.0/(u*k + 1.0);
+            break;
+
+        case SWRevealResistanceCurveExponential:
+            v = 1.0 - exp( -u*k );
+            break;
+
+        case SWRevealResistanceCurveCustom:
+            // with no function provided we fall back to the linear clamp curve
+            v = curve->function ? curve->function( u, curve->context ) : u*k;
+            break;
+
+        default:
+            v = u*k;
+            break;
+    }
+
+    if ( !(v >= 0.0) ) v = 0.0;  // <-- also catches nan
+    if ( v > 1.0 ) v = 1.0;
+    return v;
+}
+
+
+/* Table */
+
+void SWRevealResistanceTableBake( SWRevealResistanceTable *table, const SWRevealResistanceCurve *curve,
+    double revealWidth, double revealOverdraw, int stableTrack )
+{
+    double domain = curveDomain( curve );
+
+    table->revealWidth = revealWidth;
+    table->revealOverdraw = revealOverdraw;
+    table->stableTrack = stableTrack || !(revealOverdraw > 0);
+    table->indexScale = SWRevealResistanceTableIntervals/domain;
+
+    for ( int i=0 ; i<=SWRevealResistanceTableIntervals ; i++ )
+        table->values[i] = curveValue( curve, i/table->indexScale );
+}
+
+
+double SWRevealResistanceTableLookup( const SWRevealResistanceTable *table, double x, int stableTrack )
+{
+    double revealWidth = table->revealWidth;
+    double revealOverdraw = table->revealOverdraw;
+
+    if ( x <= revealWidth )
+        return x;   // Translate linearly.
+
+    if ( stableTrack || table->stableTrack )
+        return fmin( x, revealWidth+revealOverdraw );   // Translate linearly up to the most location.
+
+    double u = (x-revealWidth)/revealOverdraw*table->indexScale;
+    if ( u >= SWRevealResistanceTableIntervals )
+        return revealWidth + revealOverdraw*table->values[SWRevealResistanceTableIntervals];
+
+    int i = (int)u;
+    double v = table->values[i] + (table->values[i+1]-table->values[i])*(u-i);
+    return revealWidth + revealOverdraw*v;
+}
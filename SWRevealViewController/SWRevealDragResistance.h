@@ -0,0 +1,94 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealDragResistance
+
+ Portable drag resistance curves for SWRevealViewController. A curve defines how the front view follows the finger
+ once it is dragged beyond the reveal width into the overdraw area. Curves are baked into a small lookup table for each
+ side, so that adjusting a drag location costs a single interpolated lookup.
+
+*/
+
+#ifndef SWRevealDragResistance_h
+#define SWRevealDragResistance_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Curve types, these mirror the values of the SWRevealDragResistanceType enum
+typedef enum
+{
+    SWRevealResistanceCurveLinearClamp,   // <- linear at 'parameter' speed up to the overdraw limit, default parameter is 0.5
+    SWRevealResistanceCurveRubberBand,    // <- 1-1/(u*parameter+1), default parameter is 0.55
+    SWRevealResistanceCurveExponential,   // <- 1-exp(-u*parameter), default parameter is 1
+    SWRevealResistanceCurveCustom,        // <- user provided function
+
+} SWRevealResistanceCurveType;
+
+// Custom curve function. Both the overshoot and the returned value are relative to the overdraw width,
+// returned values are clamped to [0,1]
+typedef double (*SWRevealResistanceFunction)( double overshoot, void *context );
+
+// Curve description. A zero parameter selects the default for the curve type
+typedef struct
+{
+    SWRevealResistanceCurveType type;
+    double parameter;
+    SWRevealResistanceFunction function;   // <-- only for SWRevealResistanceCurveCustom
+    void *context;
+
+} SWRevealResistanceCurve;
+
+// Number of intervals of the lookup table
+#define SWRevealResistanceTableIntervals 64
+
+// Baked lookup table for one side
+typedef struct
+{
+    double revealWidth;     // <-- resolved reveal width
+    double revealOverdraw;
+    int stableTrack;        // <-- dragging is not resisted, but just clamped at revealWidth+revealOverdraw
+    double indexScale;      // <-- table intervals per overdraw unit
+    double values[SWRevealResistanceTableIntervals+1];
+
+} SWRevealResistanceTable;
+
+
+// Bakes the curve into the table. 'stableTrack' should be set if the bounce back flag is not set or the stable drag flag is set
+void SWRevealResistanceTableBake( SWRevealResistanceTable *table, const SWRevealResistanceCurve *curve,
+    double revealWidth, double revealOverdraw, int stableTrack );
+
+// Returns the adjusted drag location for location x, which must be non negative (symetry adjusted).
+// Pass a non zero 'stableTrack' to force stable tracking, as it happens when starting a drag from the most position
+double SWRevealResistanceTableLookup( const SWRevealResistanceTable *table, double x, int stableTrack );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,176 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+/*
+
+ SWRevealDrawerGeometry
+
+ Header only drag and release decisions of SWRevealViewController, for the drawer sides and overdraw policies in use.
+ SWRevealViewController and the gesture trace replay both make their drag and release decisions through these functions.
+
+ Drag locations give the same results as SWRevealResistanceTableLookup on tables baked for the side policies, for
+ locations already clamped to the sides that are present.
+
+*/
+
+#ifndef SWRevealDrawerGeometry_h
+#define SWRevealDrawerGeometry_h
+
+#include <math.h>
+
+#include "SWRevealGeometry.h"
+#include "SWRevealDragResistance.h"
+#include "SWRevealFlingPredictor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Drawer sides that have a controller
+typedef enum
+{
+    SWRevealDrawerSidesNone = 0,
+    SWRevealDrawerSidesRear = 1 << 0,
+    SWRevealDrawerSidesRight = 1 << 1,
+    SWRevealDrawerSidesBoth = SWRevealDrawerSidesRear|SWRevealDrawerSidesRight,
+
+} SWRevealDrawerSides;
+
+// Overdraw policy of a side, as set with the bounceBackOnOverdraw and stableDragOnOverdraw properties
+enum
+{
+    SWRevealOverdrawFree = 0,
+    SWRevealOverdrawBounceBack = 1 << 0,
+    SWRevealOverdrawStableDrag = 1 << 1,
+};
+typedef unsigned int SWRevealOverdrawPolicy;
+
+// Runtime configuration
+typedef struct
+{
+    SWRevealDrawerSides sides;
+    SWRevealOverdrawPolicy rearPolicy;
+    SWRevealOverdrawPolicy rightPolicy;
+    double revealWidth[2];              // <-- resolved widths, right (0) and rear (1)
+    double revealOverdraw[2];
+    const SWRevealResistanceTable *resistanceTables[2];     // <-- only used when dragging past a bounce back side
+    double quickFlickVelocity;
+    double decelerationRate;
+
+} SWRevealDrawerConfig;
+
+
+// Returns the symetry for drag location x, always the rear side when it is the only one. Location zero is taken
+// as a rear location even if there is no rear side
+static inline int SWRevealDrawerSymetry( SWRevealDrawerSides sides, double x )
+{
+    if ( sides == SWRevealDrawerSidesRear ) return 1;
+    return x<0 ? -1 : 1;
+}
+
+
+// Returns the drag location clamped to zero towards a side that is not present
+static inline double SWRevealDrawerClampedLocation( SWRevealDrawerSides sides, double x )
+{
+    if ( !(sides & SWRevealDrawerSidesRear) && x > 0 ) return 0;
+    if ( !(sides & SWRevealDrawerSidesRight) && x < 0 ) return 0;
+    return x;
+}
+
+
+// Returns the front view location for drag location x, resisted or clamped past the reveal width according to the side policy.
+// Pass a non zero 'stableTrack' to force stable tracking, as it happens when starting a drag from the most position
+static inline double SWRevealDrawerDragLocation( const SWRevealDrawerConfig *config, double x, int stableTrack )
+{
+    x = SWRevealDrawerClampedLocation( config->sides, x );
+    int symetry = SWRevealDrawerSymetry( config->sides, x );
+    int index = symetry<0 ? 0 : 1;
+    SWRevealOverdrawPolicy policy = symetry<0 ? config->rightPolicy : config->rearPolicy;
+
+    double revealWidth = config->revealWidth[index];
+    double xs = x*symetry;
+    if ( xs <= revealWidth )
+        return x;
+
+    // only bounce back sides without stable drag resist dragging
+    if ( stableTrack || (policy & SWRevealOverdrawBounceBack) == 0 || (policy & SWRevealOverdrawStableDrag) != 0 )
+        return fmin( xs, revealWidth+config->revealOverdraw[index] )*symetry;
+
+    return SWRevealResistanceTableLookup( config->resistanceTables[index], xs, 0 )*symetry;
+}
+
+
+// Returns the position the front view should go to when the drag is released at location x with the given velocity,
+// and the distance to go in 'pJourney'. The position is decided on the resting location projected with the deceleration
+// rate, quick flicks outwards are not bounced back
+static inline SWRevealPosition SWRevealDrawerReleasePosition( const SWRevealDrawerConfig *config, double x, double velocity, double *pJourney )
+{
+    double projectedLocation = x + SWRevealFlingProjectedDistance( velocity, config->decelerationRate );
+
+    int symetry = SWRevealDrawerSymetry( config->sides, x );
+    int index = symetry<0 ? 0 : 1;
+    SWRevealOverdrawPolicy policy = symetry<0 ? config->rightPolicy : config->rearPolicy;
+    double revealWidth = config->revealWidth[index];
+    double revealOverdraw = config->revealOverdraw[index];
+
+    x = x*symetry;
+    projectedLocation = projectedLocation*symetry;
+
+    // a quick flick outwards is not bounced back
+    int quickFlick = velocity*symetry > config->quickFlickVelocity;
+
+    SWRevealPosition position = SWRevealPositionLeft;
+    double journey = x;
+
+    if ( projectedLocation > revealWidth*0.5 )
+    {
+        position = SWRevealPositionRight;
+        journey = revealWidth - x;
+
+        if ( x > revealWidth )
+        {
+            if ( (policy & SWRevealOverdrawBounceBack) && !quickFlick )
+            {
+                position = SWRevealPositionLeft;
+                journey = x;
+            }
+            else if ( !(policy & SWRevealOverdrawBounceBack) && (policy & SWRevealOverdrawStableDrag) && projectedLocation > revealWidth+revealOverdraw*0.5 )
+            {
+                position = SWRevealPositionRightMost;
+                journey = revealWidth+revealOverdraw - x;
+            }
+        }
+    }
+
+    *pJourney = fabs( journey );
+    return SWRevealAdjustedPosition( position, symetry );
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
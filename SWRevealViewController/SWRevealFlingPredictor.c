@@ -0,0 +1,122 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealFlingPredictor.h"
+
+
+/* Samples */
+
+static unsigned int sampleIndex( const SWRevealFlingPredictor *predictor, unsigned int index )
+{
+    return (predictor->head + index) % SWRevealFlingSampleCapacity;
+}
+
+
+static SWRevealFlingSample *sampleAt( SWRevealFlingPredictor *predictor, unsigned int index )
+{
+    return &predictor->samples[sampleIndex( predictor, index )];
+}
+
+
+void SWRevealFlingPredictorReset( SWRevealFlingPredictor *predictor )
+{
+    predictor->head = 0;
+    predictor->count = 0;
+}
+
+
+void SWRevealFlingPredictorAddSample( SWRevealFlingPredictor *predictor, double time, double location )
+{
+    if ( predictor->count > 0 )
+    {
+        SWRevealFlingSample *last = sampleAt( predictor, predictor->count-1 );
+        if ( !(time > last->time) )
+        {
+            last->location = location;
+            return;
+        }
+    }
+
+    if ( predictor->count == SWRevealFlingSampleCapacity )
+    {
+        predictor->head = (predictor->head + 1) % SWRevealFlingSampleCapacity;
+        predictor->count -= 1;
+    }
+
+    SWRevealFlingSample *sample = sampleAt( predictor, predictor->count );
+    sample->time = time;
+    sample->location = location;
+    predictor->count += 1;
+}
+
+
+/* Estimation */
+
+int SWRevealFlingPredictorGetVelocity( const SWRevealFlingPredictor *predictor, double window, double halfLife, double *pVelocity )
+{
+    const SWRevealFlingPredictor *p = predictor;
+    if ( p->count < 2 )
+        return 0;
+
+    double lastTime = p->samples[sampleIndex( p, p->count-1 )].time;
+    double decay = halfLife > 0.0 ? log(2.0)/halfLife : 0.0;
+
+    // times are taken relative to the last sample to keep the sums well conditioned
+    double sw = 0, st = 0, sx = 0, stt = 0, stx = 0;
+    unsigned int used = 0;
+
+    for ( unsigned int i=p->count ; i>0 ; i-- )
+    {
+        const SWRevealFlingSample *sample = &p->samples[sampleIndex( p, i-1 )];
+        double t = sample->time - lastTime;
+        if ( -t > window )
+            break;
+
+        double w = exp(decay*t);
+        sw += w;
+        st += w*t;
+        sx += w*sample->location;
+        stt += w*t*t;
+        stx += w*t*sample->location;
+        used += 1;
+    }
+
+    double denominator = sw*stt - st*st;
+    if ( used < 2 || !(denominator > 0.0) )
+        return 0;
+
+    *pVelocity = (sw*stx - st*sx)/denominator;
+    return 1;
+}
+
+
+double SWRevealFlingProjectedDistance( double velocity, double decelerationRate )
+{
+    // per millisecond deceleration summed as a geometric series
+    return (velocity/1000.0)*decelerationRate/(1.0-decelerationRate);
+}
+
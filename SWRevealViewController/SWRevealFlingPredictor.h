@@ -0,0 +1,91 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealFlingPredictor
+
+ Portable touch history for SWRevealViewController. Timestamped drag locations are kept on a small ring buffer and an
+ exponentially weighted least squares fit over the most recent ones gives the release velocity, which is much less
+ sensitive to a single jittery sample than the velocity of the last touch. The velocity is then projected to the
+ location where the front view would come to rest, as if it decelerated like a scroll view. The release decision made
+ on that location is in SWRevealDrawerGeometry.h.
+
+*/
+
+#ifndef SWRevealFlingPredictor_h
+#define SWRevealFlingPredictor_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of samples kept, older ones are overwritten
+#define SWRevealFlingSampleCapacity 16
+
+// Default estimator parameters, in seconds
+#define SWRevealFlingDefaultWindow 0.1
+#define SWRevealFlingDefaultHalfLife 0.03
+
+// Default deceleration rate per millisecond, same as UIScrollViewDecelerationRateNormal
+#define SWRevealFlingDefaultDecelerationRate 0.998
+
+// Timestamped drag location
+typedef struct
+{
+    double time;
+    double location;
+
+} SWRevealFlingSample;
+
+// Ring buffer of the most recent samples
+typedef struct
+{
+    SWRevealFlingSample samples[SWRevealFlingSampleCapacity];
+    unsigned int head;      // <-- index of the oldest sample
+    unsigned int count;
+
+} SWRevealFlingPredictor;
+
+
+// Removes all samples
+void SWRevealFlingPredictorReset( SWRevealFlingPredictor *predictor );
+
+// Adds a sample. A sample that is not later than the last one replaces it, so that coalesced touches do not produce infinite slopes
+void SWRevealFlingPredictorAddSample( SWRevealFlingPredictor *predictor, double time, double location );
+
+// Fits a line to the samples not older than 'window' relative to the last one, each weighted by 0.5^(age/halfLife).
+// Returns non zero and the slope on 'pVelocity' if at least two samples are in the window, zero otherwise
+int SWRevealFlingPredictorGetVelocity( const SWRevealFlingPredictor *predictor, double window, double halfLife, double *pVelocity );
+
+// Returns the distance travelled until rest by something moving at 'velocity' per second and decelerating by
+// 'decelerationRate' per millisecond
+double SWRevealFlingProjectedDistance( double velocity, double decelerationRate );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
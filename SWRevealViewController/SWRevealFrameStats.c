@@ -0,0 +1,124 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+#include <string.h>
+
+#include "SWRevealFrameStats.h"
+
+
+/* Histogram */
+
+static void histogramReset( SWRevealFrameHistogram *histogram, double bucketWidth )
+{
+    memset( histogram, 0, sizeof *histogram );
+    histogram->bucketWidth = bucketWidth;
+}
+
+
+static void histogramAdd( SWRevealFrameHistogram *histogram, double duration )
+{
+    if ( !(duration >= 0.0) ) duration = 0.0;
+
+    // bucket i holds durations in (i*bucketWidth, (i+1)*bucketWidth], with some slack for rounding errors
+    double index = histogram->bucketWidth > 0.0 ? ceil( duration/histogram->bucketWidth - 1e-6 ) - 1 : 0.0;
+    if ( index < 0 ) index = 0;
+    unsigned int bucket = index < SWRevealFrameHistogramBuckets-1 ? (unsigned int)index : SWRevealFrameHistogramBuckets-1;
+
+    histogram->counts[bucket] += 1;
+    histogram->count += 1;
+    histogram->total += duration;
+    if ( duration > histogram->max ) histogram->max = duration;
+}
+
+
+double SWRevealFrameHistogramPercentile( const SWRevealFrameHistogram *histogram, double percentile )
+{
+    if ( histogram->count == 0 )
+        return 0.0;
+
+    double target = ceil( percentile*histogram->count );
+    if ( target < 1 ) target = 1;
+
+    unsigned int accumulated = 0;
+    for ( unsigned int i=0 ; i<SWRevealFrameHistogramBuckets-1 ; i++ )
+    {
+        accumulated += histogram->counts[i];
+        if ( accumulated >= target )
+        {
+            // upper bound of the bucket, but never more than the actual maximum
+            double bound = (i+1)*histogram->bucketWidth;
+            return bound < histogram->max ? bound : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
+
+
+double SWRevealFrameHistogramMean( const SWRevealFrameHistogram *histogram )
+{
+    return histogram->count > 0 ? histogram->total/histogram->count : 0.0;
+}
+
+
+/* Frame statistics */
+
+void SWRevealFrameStatsReset( SWRevealFrameStats *stats, double frameBudget )
+{
+    stats->frameBudget = frameBudget;
+    histogramReset( &stats->workDurations, frameBudget/8 );
+    histogramReset( &stats->frameIntervals, frameBudget/8 );
+    stats->workOverBudget = 0;
+    stats->framesOverBudget = 0;
+    stats->missedFrames = 0;
+    stats->lastFrameTime = -1.0;
+}
+
+
+void SWRevealFrameStatsAddWork( SWRevealFrameStats *stats, double duration )
+{
+    histogramAdd( &stats->workDurations, duration );
+    if ( duration > stats->frameBudget )
+        stats->workOverBudget += 1;
+}
+
+
+void SWRevealFrameStatsAddFrame( SWRevealFrameStats *stats, double timestamp )
+{
+    if ( stats->lastFrameTime >= 0.0 )
+    {
+        double interval = timestamp - stats->lastFrameTime;
+        histogramAdd( &stats->frameIntervals, interval );
+
+        // display timestamps jitter a little, an interval only counts as late past one and a half budgets
+        if ( stats->frameBudget > 0.0 && interval > 1.5*stats->frameBudget )
+        {
+            stats->framesOverBudget += 1;
+            stats->missedFrames += (unsigned int)floor( interval/stats->frameBudget + 0.5 ) - 1;
+        }
+    }
+    stats->lastFrameTime = timestamp;
+}
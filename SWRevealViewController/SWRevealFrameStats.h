@@ -0,0 +1,90 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealFrameStats
+
+ Portable frame pacing statistics for SWRevealViewController. Work durations, such as the time spent handling a pan
+ gesture move, and display frame intervals are accumulated on fixed size histograms measured against a frame budget,
+ with counters for work over budget and missed frames. Nothing is allocated while collecting.
+
+*/
+
+#ifndef SWRevealFrameStats_h
+#define SWRevealFrameStats_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of histogram buckets, each bucket is an eighth of the frame budget wide. The last bucket collects all longer durations
+#define SWRevealFrameHistogramBuckets 64
+
+// Histogram of durations, in seconds
+typedef struct
+{
+    double bucketWidth;
+    unsigned int counts[SWRevealFrameHistogramBuckets];
+    unsigned int count;
+    double total;
+    double max;
+
+} SWRevealFrameHistogram;
+
+// Statistics for a gesture or an animation
+typedef struct
+{
+    double frameBudget;
+    SWRevealFrameHistogram workDurations;
+    SWRevealFrameHistogram frameIntervals;
+    unsigned int workOverBudget;        // <-- work durations longer than the frame budget
+    unsigned int framesOverBudget;      // <-- frame intervals noticeably longer than the frame budget
+    unsigned int missedFrames;          // <-- frames that should have been displayed in those intervals
+    double lastFrameTime;               // <-- negative before the first frame
+
+} SWRevealFrameStats;
+
+
+// Clears the statistics and sets the frame budget, in seconds
+void SWRevealFrameStatsReset( SWRevealFrameStats *stats, double frameBudget );
+
+// Adds a work duration
+void SWRevealFrameStatsAddWork( SWRevealFrameStats *stats, double duration );
+
+// Adds a display frame at 'timestamp', the interval from the previous frame is added to the frame intervals
+void SWRevealFrameStatsAddFrame( SWRevealFrameStats *stats, double timestamp );
+
+// Returns the duration below which 'percentile' (0 to 1) of the histogram samples are, at bucket resolution
+double SWRevealFrameHistogramPercentile( const SWRevealFrameHistogram *histogram, double percentile );
+
+// Returns the mean duration of the histogram samples
+double SWRevealFrameHistogramMean( const SWRevealFrameHistogram *histogram );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
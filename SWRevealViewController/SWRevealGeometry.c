@@ -0,0 +1,219 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+#include "SWRevealGeometry.h"
+
+
+/* Scaling */
+
+// clamps v to [min,max], a nan value is clamped to min. Written as plain selects so that it vectorizes
+static inline double clampedValue( double v, double min, double max )
+{
+    v = !(v >= min) ? min : v;
+    v = v > max ? max : v;
+    return v;
+}
+
+
+double SWRevealScaledValue( double v1, double min2, double max2, double min1, double max1 )
+{
+    double result = min2 + (v1-min1)*((max2-min2)/(max1-min1));
+    return clampedValue( result, min2, max2 );
+}
+
+
+/* Widths and positions */
+
+double SWRevealResolvedWidth( double revealWidth, double boundsWidth )
+{
+    if ( revealWidth < 0 ) revealWidth = boundsWidth + revealWidth;
+    return revealWidth;
+}
+
+
+void SWRevealGetRevealWidth( const SWRevealGeometryConfig *config, int symetry, double *pRevealWidth, double *pRevealOverdraw )
+{
+    if ( symetry < 0 ) *pRevealWidth = config->rightRevealWidth, *pRevealOverdraw = config->rightRevealOverdraw;
+    else *pRevealWidth = config->rearRevealWidth, *pRevealOverdraw = config->rearRevealOverdraw;
+
+    *pRevealWidth = SWRevealResolvedWidth( *pRevealWidth, config->boundsWidth );
+}
+
+
+SWRevealPosition SWRevealAdjustedPosition( SWRevealPosition position, int symetry )
+{
+    if ( symetry < 0 ) position = SWRevealPositionLeft + symetry*((int)position-SWRevealPositionLeft);
+    return position;
+}
+
+
+double SWRevealFrontLocationForPosition( const SWRevealGeometryConfig *config, SWRevealPosition position )
+{
+    double revealWidth;
+    double revealOverdraw;
+
+    double location = 0.0;
+
+    int symetry = position<SWRevealPositionLeft ? -1 : 1;
+    SWRevealGetRevealWidth( config, symetry, &revealWidth, &revealOverdraw );
+    position = SWRevealAdjustedPosition( position, symetry );
+
+    if ( position == SWRevealPositionRight )
+        location = revealWidth;
+
+    else if ( position > SWRevealPositionRight )
+        location = revealWidth + revealOverdraw;
+
+    return location*symetry;
+}
+
+
+/* Layout frames */
+
+// Config invariants for the layout of a given x location, resolved once per call
+typedef struct
+{
+    double width, height;
+    double frontOffsetY;
+    double rearWidth, rearMin, rearScale;
+    double rightWidth, rightOrigin, rightMax, rightMin1, rightScale;
+
+} SWRevealLayoutInvariants;
+
+
+static void resolveInvariants( const SWRevealGeometryConfig *config, SWRevealLayoutInvariants *inv )
+{
+    double width = config->boundsWidth;
+    double rearRevealWidth = SWRevealResolvedWidth( config->rearRevealWidth, width );
+    double rightRevealWidth = SWRevealResolvedWidth( config->rightRevealWidth, width );
+
+    inv->width = width;
+    inv->height = config->boundsHeight;
+    inv->frontOffsetY = config->frontOffsetY;
+
+    // rear x location is scaled from [0,rearRevealWidth] to [-rearRevealDisplacement,0]
+    inv->rearWidth = rearRevealWidth + config->rearRevealOverdraw;
+    inv->rearMin = -config->rearRevealDisplacement;
+    inv->rearScale = (0-inv->rearMin)/(rearRevealWidth-0);
+
+    // right x location is scaled from [-rightRevealWidth,0] to [0,rightRevealDisplacement]
+    inv->rightWidth = rightRevealWidth + config->rightRevealOverdraw;
+    inv->rightOrigin = width - inv->rightWidth;
+    inv->rightMax = config->rightRevealDisplacement;
+    inv->rightMin1 = -rightRevealWidth;
+    inv->rightScale = (inv->rightMax-0)/(0-inv->rightMin1);
+}
+
+
+static inline void layoutFrames( const SWRevealLayoutInvariants *inv, double xLocation, SWRevealLayoutFrames *frames )
+{
+    double rearXLocation = clampedValue( inv->rearMin + xLocation*inv->rearScale, inv->rearMin, 0 );
+    double rightXLocation = clampedValue( (xLocation-inv->rightMin1)*inv->rightScale, 0, inv->rightMax );
+
+    frames->front.x = xLocation;
+    frames->front.y = inv->frontOffsetY;
+    frames->front.width = inv->width;
+    frames->front.height = inv->height - inv->frontOffsetY;
+
+    frames->rear.x = rearXLocation;
+    frames->rear.y = 0;
+    frames->rear.width = inv->rearWidth;
+    frames->rear.height = inv->height;
+
+    frames->right.x = inv->rightOrigin + rightXLocation;
+    frames->right.y = 0;
+    frames->right.width = inv->rightWidth;
+    frames->right.height = inv->height;
+}
+
+
+void SWRevealGetLayoutFrames( const SWRevealGeometryConfig *config, double xLocation, SWRevealLayoutFrames *frames )
+{
+    SWRevealLayoutInvariants inv;
+    resolveInvariants( config, &inv );
+    layoutFrames( &inv, xLocation, frames );
+}
+
+
+void SWRevealGetLayoutFramesBatch( const SWRevealGeometryConfig *config, const double *xLocations, SWRevealLayoutFrames *frames, size_t count )
+{
+    SWRevealLayoutInvariants inv;
+    resolveInvariants( config, &inv );
+
+    for ( size_t i=0 ; i<count ; i++ )
+        layoutFrames( &inv, xLocations[i], &frames[i] );
+}
+
+
+/* Metrics */
+
+void SWRevealMetricsResolveWidths( SWRevealMetrics *metrics, const SWRevealWidthProfile *profile, double boundsWidth, double boundsHeight )
+{
+    metrics->boundsWidth = boundsWidth;
+    metrics->boundsHeight = boundsHeight;
+    metrics->rearRevealWidth = SWRevealResolvedWidth( profile->rearRevealWidth, boundsWidth );
+    metrics->rearRevealOverdraw = profile->rearRevealOverdraw;
+    metrics->rightRevealWidth = SWRevealResolvedWidth( profile->rightRevealWidth, boundsWidth );
+    metrics->rightRevealOverdraw = profile->rightRevealOverdraw;
+}
+
+
+/* Layout state */
+
+SWRevealLayoutDirtyFlags SWRevealLayoutDirtyClosure( SWRevealLayoutDirtyFlags flags )
+{
+    if ( flags & SWRevealLayoutDirtyLocation )
+        flags |= SWRevealLayoutDirtyRearFrames | SWRevealLayoutDirtyFrontFrame;
+
+    if ( flags & SWRevealLayoutDirtyFrontOffset )
+        flags |= SWRevealLayoutDirtyFrontFrame | SWRevealLayoutDirtyShadowPath;
+
+    return flags;
+}
+
+
+SWRevealLayoutDirtyFlags SWRevealLayoutStateDiff( const SWRevealLayoutState *oldState, const SWRevealLayoutState *newState )
+{
+    SWRevealLayoutDirtyFlags flags = SWRevealLayoutDirtyNone;
+
+    if ( oldState->boundsWidth != newState->boundsWidth || oldState->boundsHeight != newState->boundsHeight )
+        return SWRevealLayoutDirtyAll;
+
+    if ( oldState->position != newState->position ||
+        oldState->rearRevealWidth != newState->rearRevealWidth || oldState->rearRevealOverdraw != newState->rearRevealOverdraw ||
+        oldState->rightRevealWidth != newState->rightRevealWidth || oldState->rightRevealOverdraw != newState->rightRevealOverdraw )
+        flags |= SWRevealLayoutDirtyLocation;
+
+    if ( oldState->rearRevealDisplacement != newState->rearRevealDisplacement ||
+        oldState->rightRevealDisplacement != newState->rightRevealDisplacement )
+        flags |= SWRevealLayoutDirtyRearFrames;
+
+    if ( oldState->presentFrontViewHierarchically != newState->presentFrontViewHierarchically )
+        flags |= SWRevealLayoutDirtyFrontOffset;
+
+    if ( oldState->frontShadowVisible != newState->frontShadowVisible )
+        flags |= SWRevealLayoutDirtyShadowPath;
+
+    return SWRevealLayoutDirtyClosure( flags );
+}
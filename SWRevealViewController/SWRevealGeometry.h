@@ -0,0 +1,181 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+/*
+
+ SWRevealGeometry
+
+ Portable geometry core for SWRevealViewController. This is plain C with no UIKit dependencies so it can be
+ compiled and exercised on any platform. SWRevealView uses it to compute the front, rear and right frames,
+ and you can use it directly to precompute whole keyframe tables for a transition in a single call.
+
+*/
+
+#ifndef SWRevealGeometry_h
+#define SWRevealGeometry_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Position values, these mirror the values of the FrontViewPosition enum
+typedef enum
+{
+    SWRevealPositionLeftSideMostRemoved,
+    SWRevealPositionLeftSideMost,
+    SWRevealPositionLeftSide,
+    SWRevealPositionLeft,
+    SWRevealPositionRight,
+    SWRevealPositionRightMost,
+    SWRevealPositionRightMostRemoved,
+
+} SWRevealPosition;
+
+// Rectangle type, values are in points
+typedef struct
+{
+    double x, y;
+    double width, height;
+
+} SWRevealRect;
+
+// Geometry configuration. Reveal widths follow the same rules than the SWRevealViewController properties of
+// the same name, particularly negative values indicate that the width is computed by substracting boundsWidth.
+typedef struct
+{
+    double boundsWidth;
+    double boundsHeight;
+    double rearRevealWidth;
+    double rearRevealOverdraw;
+    double rearRevealDisplacement;
+    double rightRevealWidth;
+    double rightRevealOverdraw;
+    double rightRevealDisplacement;
+    double frontOffsetY;    // <-- vertical offset of the front view, as used by presentFrontViewHierarchically
+
+} SWRevealGeometryConfig;
+
+// Frames for the front, rear and right views at a given front view x location
+typedef struct
+{
+    SWRevealRect front;
+    SWRevealRect rear;
+    SWRevealRect right;
+
+} SWRevealLayoutFrames;
+
+// Reveal widths and overdraws, as set on the controller properties or for a particular size class
+typedef struct
+{
+    double rearRevealWidth;
+    double rearRevealOverdraw;
+    double rightRevealWidth;
+    double rightRevealOverdraw;
+
+} SWRevealWidthProfile;
+
+// Cached layout metrics. Reveal widths are resolved against the bounds width
+typedef struct
+{
+    double boundsWidth;
+    double boundsHeight;
+    double rearRevealWidth;
+    double rearRevealOverdraw;
+    double rightRevealWidth;
+    double rightRevealOverdraw;
+    double barHeight;           // <-- navigation bar height, as used by presentFrontViewHierarchically
+    double statusBarInset;      // <-- status bar height if the view overlaps it, zero otherwise
+
+} SWRevealMetrics;
+
+// Snapshot of the inputs of a layout pass
+typedef struct
+{
+    double boundsWidth;
+    double boundsHeight;
+    SWRevealPosition position;
+    double rearRevealWidth;
+    double rearRevealOverdraw;
+    double rearRevealDisplacement;
+    double rightRevealWidth;
+    double rightRevealOverdraw;
+    double rightRevealDisplacement;
+    int presentFrontViewHierarchically;
+    int frontShadowVisible;     // <-- front view loaded and not removed
+
+} SWRevealLayoutState;
+
+// Parts of a layout pass that need to be recomputed
+enum
+{
+    SWRevealLayoutDirtyNone         = 0,
+    SWRevealLayoutDirtyLocation     = 1 << 0,   // <-- front view x location
+    SWRevealLayoutDirtyFrontOffset  = 1 << 1,   // <-- hierarchical front view offset
+    SWRevealLayoutDirtyRearFrames   = 1 << 2,   // <-- rear and right view frames
+    SWRevealLayoutDirtyFrontFrame   = 1 << 3,   // <-- front view frame
+    SWRevealLayoutDirtyShadowPath   = 1 << 4,   // <-- front view shadow path
+    SWRevealLayoutDirtyAll          = 0x1f,
+};
+typedef unsigned int SWRevealLayoutDirtyFlags;
+
+
+// Linearly maps v1 from the range [min1,max1] to the range [min2,max2], clamping the result to the later.
+// Returns min2 if the mapping is undefined
+double SWRevealScaledValue( double v1, double min2, double max2, double min1, double max1 );
+
+// Returns the reveal width resolved against the bounds width, (negative widths are substracted from boundsWidth)
+double SWRevealResolvedWidth( double revealWidth, double boundsWidth );
+
+// Returns the resolved reveal width and overdraw for the rear (symetry > 0) or right (symetry < 0) side
+void SWRevealGetRevealWidth( const SWRevealGeometryConfig *config, int symetry, double *pRevealWidth, double *pRevealOverdraw );
+
+// Returns the position adjusted for the given symetry, so that right side positions can be handled as left ones
+SWRevealPosition SWRevealAdjustedPosition( SWRevealPosition position, int symetry );
+
+// Returns the front view x location for the given position
+double SWRevealFrontLocationForPosition( const SWRevealGeometryConfig *config, SWRevealPosition position );
+
+// Computes the front, rear and right frames for a single front view x location
+void SWRevealGetLayoutFrames( const SWRevealGeometryConfig *config, double xLocation, SWRevealLayoutFrames *frames );
+
+// Computes the front, rear and right frames for 'count' front view x locations at once.
+// Config invariants are resolved once and the per sample work is kept branch free so the loop can be vectorized.
+void SWRevealGetLayoutFramesBatch( const SWRevealGeometryConfig *config, const double *xLocations, SWRevealLayoutFrames *frames, size_t count );
+
+// Resolves the widths of 'profile' for the given bounds into 'metrics'. Bar height and status bar inset are not changed
+void SWRevealMetricsResolveWidths( SWRevealMetrics *metrics, const SWRevealWidthProfile *profile, double boundsWidth, double boundsHeight );
+
+// Compares two layout states and returns the parts of the layout that depend on the differing values
+SWRevealLayoutDirtyFlags SWRevealLayoutStateDiff( const SWRevealLayoutState *oldState, const SWRevealLayoutState *newState );
+
+// Adds to 'flags' the parts of the layout that depend on the ones already in 'flags'
+SWRevealLayoutDirtyFlags SWRevealLayoutDirtyClosure( SWRevealLayoutDirtyFlags flags );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,389 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "SWRevealGestureTrace.h"
+#include "SWRevealFlingPredictor.h"
+#include "SWRevealDrawerGeometry.h"
+
+
+/* Format */
+
+// A trace starts with a header, followed by a configuration record for each gesture and a fixed size record for each event.
+// All values are little endian
+//
+//  header:  'S' 'W' 'G' 'T' version(u8)
+//  config:  0xC0 startTime(f64) geometry(9 x f64) initialPosition(u8) quickFlickVelocity(f64) flags(u8) resistanceType(u8) resistanceParameter(f64)
+//  event:   phase(u8) time(f32) location(f32) velocity(f32)
+
+enum
+{
+    SWRevealTraceHeaderSize = 5,
+    SWRevealTraceConfigTag = 0xC0,
+    SWRevealTraceConfigSize = 1 + 8 + 9*8 + 1 + 8 + 1 + 1 + 8,
+    SWRevealTraceEventSize = 1 + 3*4,
+};
+
+enum
+{
+    SWRevealTraceFlagRearBounceBack = 1 << 0,
+    SWRevealTraceFlagRearStableDrag = 1 << 1,
+    SWRevealTraceFlagRightBounceBack = 1 << 2,
+    SWRevealTraceFlagRightStableDrag = 1 << 3,
+    SWRevealTraceFlagHasRear = 1 << 4,
+    SWRevealTraceFlagHasRight = 1 << 5,
+};
+
+
+static unsigned char *putU32( unsigned char *p, uint32_t v )
+{
+    for ( int i=0 ; i<4 ; i++ ) *p++ = (unsigned char)(v >> (8*i));
+    return p;
+}
+
+
+static unsigned char *putF32( unsigned char *p, double value )
+{
+    float f = (float)value;
+    uint32_t v;
+    memcpy( &v, &f, sizeof v );
+    return putU32( p, v );
+}
+
+
+static unsigned char *putF64( unsigned char *p, double value )
+{
+    uint64_t v;
+    memcpy( &v, &value, sizeof v );
+    for ( int i=0 ; i<8 ; i++ ) *p++ = (unsigned char)(v >> (8*i));
+    return p;
+}
+
+
+static const unsigned char *getF32( const unsigned char *p, double *pValue )
+{
+    uint32_t v = 0;
+    for ( int i=0 ; i<4 ; i++ ) v |= (uint32_t)p[i] << (8*i);
+    float f;
+    memcpy( &f, &v, sizeof f );
+    *pValue = f;
+    return p + 4;
+}
+
+
+static const unsigned char *getF64( const unsigned char *p, double *pValue )
+{
+    uint64_t v = 0;
+    for ( int i=0 ; i<8 ; i++ ) v |= (uint64_t)p[i] << (8*i);
+    memcpy( pValue, &v, sizeof v );
+    return p + 8;
+}
+
+
+/* Recording */
+
+// makes room for 'size' more bytes and returns where they start, or NULL if memory could not be allocated
+static unsigned char *reserve( SWRevealTraceRecorder *recorder, size_t size )
+{
+    if ( recorder->length + size > recorder->capacity )
+    {
+        size_t capacity = recorder->capacity > 0 ? recorder->capacity : 256;
+        while ( capacity < recorder->length + size ) capacity *= 2;
+
+        unsigned char *bytes = realloc( recorder->bytes, capacity );
+        if ( !bytes ) return NULL;
+
+        recorder->bytes = bytes;
+        recorder->capacity = capacity;
+    }
+
+    unsigned char *p = recorder->bytes + recorder->length;
+    recorder->length += size;
+    return p;
+}
+
+
+int SWRevealTraceRecorderInit( SWRevealTraceRecorder *recorder, size_t capacity )
+{
+    recorder->bytes = NULL;
+    recorder->length = 0;
+    recorder->capacity = 0;
+    recorder->startTime = 0.0;
+
+    if ( capacity < SWRevealTraceHeaderSize ) capacity = SWRevealTraceHeaderSize;
+    recorder->bytes = malloc( capacity );
+    if ( !recorder->bytes ) return 0;
+    recorder->capacity = capacity;
+
+    unsigned char *p = reserve( recorder, SWRevealTraceHeaderSize );
+    memcpy( p, "SWGT", 4 );
+    p[4] = SWRevealGestureTraceVersion;
+    return 1;
+}
+
+
+void SWRevealTraceRecorderFree( SWRevealTraceRecorder *recorder )
+{
+    free( recorder->bytes );
+    recorder->bytes = NULL;
+    recorder->length = 0;
+    recorder->capacity = 0;
+}
+
+
+int SWRevealTraceRecorderBeginGesture( SWRevealTraceRecorder *recorder, const SWRevealTraceConfig *config, double time )
+{
+    unsigned char *p = reserve( recorder, SWRevealTraceConfigSize );
+    if ( !p ) return 0;
+
+    const SWRevealGeometryConfig *geometry = &config->geometry;
+    unsigned char flags =
+        (config->rearBounceBack ? SWRevealTraceFlagRearBounceBack : 0) |
+        (config->rearStableDrag ? SWRevealTraceFlagRearStableDrag : 0) |
+        (config->rightBounceBack ? SWRevealTraceFlagRightBounceBack : 0) |
+        (config->rightStableDrag ? SWRevealTraceFlagRightStableDrag : 0) |
+        (config->hasRear ? SWRevealTraceFlagHasRear : 0) |
+        (config->hasRight ? SWRevealTraceFlagHasRight : 0);
+
+    *p++ = SWRevealTraceConfigTag;
+    p = putF64( p, time );
+    p = putF64( p, geometry->boundsWidth );
+    p = putF64( p, geometry->boundsHeight );
+    p = putF64( p, geometry->rearRevealWidth );
+    p = putF64( p, geometry->rearRevealOverdraw );
+    p = putF64( p, geometry->rearRevealDisplacement );
+    p = putF64( p, geometry->rightRevealWidth );
+    p = putF64( p, geometry->rightRevealOverdraw );
+    p = putF64( p, geometry->rightRevealDisplacement );
+    p = putF64( p, geometry->frontOffsetY );
+    *p++ = (unsigned char)config->initialPosition;
+    p = putF64( p, config->quickFlickVelocity );
+    *p++ = flags;
+    *p++ = (unsigned char)config->resistanceType;
+    p = putF64( p, config->resistanceParameter );
+
+    recorder->startTime = time;
+    return 1;
+}
+
+
+int SWRevealTraceRecorderAddEvent( SWRevealTraceRecorder *recorder, SWRevealTracePhase phase, double time, double location, double velocity )
+{
+    unsigned char *p = reserve( recorder, SWRevealTraceEventSize );
+    if ( !p ) return 0;
+
+    *p++ = (unsigned char)phase;
+    p = putF32( p, time - recorder->startTime );
+    p = putF32( p, location );
+    p = putF32( p, velocity );
+    return 1;
+}
+
+
+/* Replay */
+
+// Replay state for a gesture, mirrors what SWRevealViewController keeps during a pan
+typedef struct
+{
+    SWRevealTraceConfig config;
+    SWRevealResistanceTable tables[2];      // <-- right (0) and rear (1) sides
+    SWRevealDrawerConfig drawer;
+    SWRevealFlingPredictor predictor;
+    double frontLocation;
+
+} SWRevealTraceReplayState;
+
+
+static const unsigned char *readConfig( const unsigned char *p, SWRevealTraceConfig *config, double *pStartTime )
+{
+    SWRevealGeometryConfig *geometry = &config->geometry;
+    p += 1;     // <-- tag
+    p = getF64( p, pStartTime );
+    p = getF64( p, &geometry->boundsWidth );
+    p = getF64( p, &geometry->boundsHeight );
+    p = getF64( p, &geometry->rearRevealWidth );
+    p = getF64( p, &geometry->rearRevealOverdraw );
+    p = getF64( p, &geometry->rearRevealDisplacement );
+    p = getF64( p, &geometry->rightRevealWidth );
+    p = getF64( p, &geometry->rightRevealOverdraw );
+    p = getF64( p, &geometry->rightRevealDisplacement );
+    p = getF64( p, &geometry->frontOffsetY );
+    config->initialPosition = (SWRevealPosition)*p++;
+    p = getF64( p, &config->quickFlickVelocity );
+
+    unsigned char flags = *p++;
+    config->rearBounceBack = (flags & SWRevealTraceFlagRearBounceBack) != 0;
+    config->rearStableDrag = (flags & SWRevealTraceFlagRearStableDrag) != 0;
+    config->rightBounceBack = (flags & SWRevealTraceFlagRightBounceBack) != 0;
+    config->rightStableDrag = (flags & SWRevealTraceFlagRightStableDrag) != 0;
+    config->hasRear = (flags & SWRevealTraceFlagHasRear) != 0;
+    config->hasRight = (flags & SWRevealTraceFlagHasRight) != 0;
+
+    config->resistanceType = (SWRevealResistanceCurveType)*p++;
+    p = getF64( p, &config->resistanceParameter );
+    return p;
+}
+
+
+static void prepareReplayState( SWRevealTraceReplayState *state )
+{
+    const SWRevealTraceConfig *config = &state->config;
+
+    SWRevealResistanceCurve curve;
+    curve.type = config->resistanceType;
+    curve.parameter = config->resistanceParameter;
+    curve.function = 0;
+    curve.context = 0;
+    if ( curve.type == SWRevealResistanceCurveCustom ) curve.type = SWRevealResistanceCurveLinearClamp;
+
+    for ( int i=0 ; i<2 ; i++ )
+    {
+        double revealWidth, revealOverdraw;
+        int symetry = i==0 ? -1 : 1;
+        int bounceBack = i==0 ? config->rightBounceBack : config->rearBounceBack;
+        int stableDrag = i==0 ? config->rightStableDrag : config->rearStableDrag;
+
+        SWRevealGetRevealWidth( &config->geometry, symetry, &revealWidth, &revealOverdraw );
+        SWRevealResistanceTableBake( &state->tables[i], &curve, revealWidth, revealOverdraw, !bounceBack || stableDrag );
+
+        SWRevealOverdrawPolicy policy = SWRevealOverdrawFree;
+        if ( bounceBack ) policy |= SWRevealOverdrawBounceBack;
+        if ( stableDrag ) policy |= SWRevealOverdrawStableDrag;
+        if ( i == 0 ) state->drawer.rightPolicy = policy;
+        else state->drawer.rearPolicy = policy;
+
+        state->drawer.revealWidth[i] = revealWidth;
+        state->drawer.revealOverdraw[i] = revealOverdraw;
+        state->drawer.resistanceTables[i] = &state->tables[i];
+    }
+
+    state->drawer.sides = SWRevealDrawerSidesNone;
+    if ( config->hasRear ) state->drawer.sides |= SWRevealDrawerSidesRear;
+    if ( config->hasRight ) state->drawer.sides |= SWRevealDrawerSidesRight;
+    state->drawer.quickFlickVelocity = config->quickFlickVelocity;
+    state->drawer.decelerationRate = SWRevealFlingDefaultDecelerationRate;
+
+    SWRevealFlingPredictorReset( &state->predictor );
+    state->frontLocation = SWRevealFrontLocationForPosition( &config->geometry, config->initialPosition );
+}
+
+
+// same as the drag adjustments of SWRevealViewController and SWRevealView
+static double frontLocationForDragLocation( const SWRevealTraceReplayState *state, double x )
+{
+    const SWRevealTraceConfig *config = &state->config;
+    int stableTrack = config->initialPosition == SWRevealPositionRightMost || config->initialPosition == SWRevealPositionLeftSideMost;
+    return SWRevealDrawerDragLocation( &state->drawer, x, stableTrack );
+}
+
+
+static void replayEvent( SWRevealTraceReplayState *state, SWRevealTraceReplayStep *step )
+{
+    const SWRevealTraceEvent *event = &step->event;
+    const SWRevealTraceConfig *config = &state->config;
+
+    step->finalPosition = config->initialPosition;
+    step->releaseVelocity = 0.0;
+
+    switch ( event->phase )
+    {
+        case SWRevealTracePhaseBegan:
+            SWRevealFlingPredictorReset( &state->predictor );
+            SWRevealFlingPredictorAddSample( &state->predictor, event->time, event->location );
+            break;
+
+        case SWRevealTracePhaseMoved:
+            SWRevealFlingPredictorAddSample( &state->predictor, event->time, event->location );
+            state->frontLocation = frontLocationForDragLocation( state, event->location );
+            break;
+
+        case SWRevealTracePhaseEnded:
+        {
+            double velocity, journey;
+            SWRevealFlingPredictorAddSample( &state->predictor, event->time, event->location );
+            if ( !SWRevealFlingPredictorGetVelocity( &state->predictor, SWRevealFlingDefaultWindow, SWRevealFlingDefaultHalfLife, &velocity ) )
+                velocity = event->velocity;
+
+            step->finalPosition = SWRevealDrawerReleasePosition( &state->drawer, state->frontLocation, velocity, &journey );
+            step->releaseVelocity = velocity;
+            break;
+        }
+
+        case SWRevealTracePhaseCancelled:
+            break;
+    }
+
+    step->frontLocation = state->frontLocation;
+    SWRevealGetLayoutFrames( &config->geometry, state->frontLocation, &step->frames );
+}
+
+
+int SWRevealTraceReplay( const unsigned char *bytes, size_t length, SWRevealTraceReplayFunction function, void *context )
+{
+    if ( length < SWRevealTraceHeaderSize || memcmp( bytes, "SWGT", 4 ) != 0 || bytes[4] != SWRevealGestureTraceVersion )
+        return -1;
+
+    SWRevealTraceReplayState state;
+    SWRevealTraceReplayStep step;
+    int gestures = 0;
+
+    const unsigned char *p = bytes + SWRevealTraceHeaderSize;
+    const unsigned char *end = bytes + length;
+
+    while ( p < end )
+    {
+        if ( *p == SWRevealTraceConfigTag )
+        {
+            if ( (size_t)(end-p) < SWRevealTraceConfigSize ) return -1;
+
+            double startTime;
+            p = readConfig( p, &state.config, &startTime );
+            if ( state.config.initialPosition > SWRevealPositionRightMostRemoved || state.config.resistanceType > SWRevealResistanceCurveCustom )
+                return -1;
+
+            prepareReplayState( &state );
+            gestures += 1;
+            continue;
+        }
+
+        // events are only valid after a configuration
+        if ( *p > SWRevealTracePhaseCancelled || gestures == 0 || (size_t)(end-p) < SWRevealTraceEventSize )
+            return -1;
+
+        step.gesture = gestures-1;
+        step.event.phase = (SWRevealTracePhase)*p++;
+        p = getF32( p, &step.event.time );
+        p = getF32( p, &step.event.location );
+        p = getF32( p, &step.event.velocity );
+
+        replayEvent( &state, &step );
+        if ( function ) function( &step, context );
+    }
+
+    return gestures;
+}
@@ -0,0 +1,134 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealGestureTrace
+
+ Portable recording and replay of reveal pan gestures. A recorder appends the configuration active when a gesture begins,
+ followed by a compact fixed size record per gesture event, to a growable byte buffer in a platform independent little
+ endian format. Recording an event is a bounds check and a few stores.
+
+ Traces can be replayed anywhere. The replay feeds each gesture through the same drag resistance, layout geometry,
+ fling prediction and release decision code used by SWRevealViewController, and reports the resulting frames for each
+ event and the final position of each gesture.
+
+*/
+
+#ifndef SWRevealGestureTrace_h
+#define SWRevealGestureTrace_h
+
+#include <stddef.h>
+
+#include "SWRevealGeometry.h"
+#include "SWRevealDragResistance.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Trace format version
+#define SWRevealGestureTraceVersion 1
+
+// Gesture event phases
+typedef enum
+{
+    SWRevealTracePhaseBegan,
+    SWRevealTracePhaseMoved,
+    SWRevealTracePhaseEnded,
+    SWRevealTracePhaseCancelled,
+
+} SWRevealTracePhase;
+
+// Configuration active when a gesture begins. Custom drag resistance curves can not be recorded, they are replayed as linear clamp
+typedef struct
+{
+    SWRevealGeometryConfig geometry;
+    SWRevealPosition initialPosition;
+    double quickFlickVelocity;
+    int rearBounceBack, rearStableDrag;
+    int rightBounceBack, rightStableDrag;
+    int hasRear, hasRight;                  // <-- whether there are rear and right controllers to reveal
+    SWRevealResistanceCurveType resistanceType;
+    double resistanceParameter;
+
+} SWRevealTraceConfig;
+
+// Recorded gesture event. The location is the drag location before resistance, velocity is the recognizer velocity
+typedef struct
+{
+    SWRevealTracePhase phase;
+    double time;            // <-- seconds since the gesture began
+    double location;
+    double velocity;
+
+} SWRevealTraceEvent;
+
+// Recorder, use SWRevealTraceRecorderInit before use and SWRevealTraceRecorderFree when done
+typedef struct
+{
+    unsigned char *bytes;
+    size_t length;
+    size_t capacity;
+    double startTime;       // <-- absolute time of the current gesture
+
+} SWRevealTraceRecorder;
+
+// Replay result for an event
+typedef struct
+{
+    unsigned int gesture;               // <-- zero based gesture index
+    SWRevealTraceEvent event;
+    double frontLocation;               // <-- front view x location after resistance
+    SWRevealLayoutFrames frames;
+    SWRevealPosition finalPosition;     // <-- only set for ended and cancelled events
+    double releaseVelocity;             // <-- only set for ended events
+
+} SWRevealTraceReplayStep;
+
+typedef void (*SWRevealTraceReplayFunction)( const SWRevealTraceReplayStep *step, void *context );
+
+
+// Initializes an empty recorder with room for 'capacity' bytes, returns zero if the memory could not be allocated
+int SWRevealTraceRecorderInit( SWRevealTraceRecorder *recorder, size_t capacity );
+
+// Releases the recorder memory
+void SWRevealTraceRecorderFree( SWRevealTraceRecorder *recorder );
+
+// Starts a new gesture at absolute time 'time', returns zero if the memory could not be allocated
+int SWRevealTraceRecorderBeginGesture( SWRevealTraceRecorder *recorder, const SWRevealTraceConfig *config, double time );
+
+// Appends an event at absolute time 'time', returns zero if the memory could not be allocated
+int SWRevealTraceRecorderAddEvent( SWRevealTraceRecorder *recorder, SWRevealTracePhase phase, double time, double location, double velocity );
+
+// Replays a trace, calling 'function' after processing each event. Returns the number of gestures replayed or -1 if the trace is malformed,
+// that is a bad header, a record cut short, an unknown event phase, position or resistance curve, or an event before any configuration
+int SWRevealTraceReplay( const unsigned char *bytes, size_t length, SWRevealTraceReplayFunction function, void *context );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
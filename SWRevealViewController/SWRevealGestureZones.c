@@ -0,0 +1,293 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SWRevealGestureZones.h"
+
+
+/* Helpers */
+
+static int compareDoubles( const void *a, const void *b )
+{
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+
+// Sorts values and removes duplicates, returns the number of distinct values
+static unsigned int sortUnique( double *values, unsigned int count )
+{
+    if ( count == 0 )
+        return 0;
+
+    qsort( values, count, sizeof *values, compareDoubles );
+
+    unsigned int n = 1;
+    for ( unsigned int i=1 ; i<count ; i++ )
+        if ( values[i] != values[n-1] ) values[n++] = values[i];
+
+    return n;
+}
+
+
+// Returns the index of the last value not greater than x, values must be sorted and values[0] <= x
+static unsigned int lastNotAbove( const double *values, unsigned int count, double x )
+{
+    unsigned int low = 0, high = count-1;
+    while ( low < high )
+    {
+        unsigned int mid = (low+high+1)/2;
+        if ( values[mid] <= x ) low = mid;
+        else high = mid-1;
+    }
+    return low;
+}
+
+
+static int hasArea( const SWRevealRect *rect )
+{
+    return rect->width > 0.0 && rect->height > 0.0;
+}
+
+
+/* Index */
+
+int SWRevealZoneIndexBuild( SWRevealZoneIndex *index, const SWRevealIndexedRect *rects, unsigned int count )
+{
+    SWRevealZoneIndexFree( index );
+
+    // slab boundaries are the distinct vertical edges
+    double *xs = malloc( (2*count+1)*sizeof *xs );
+    if ( !xs )
+        return -1;
+
+    unsigned int n = 0;
+    for ( unsigned int i=0 ; i<count ; i++ )
+    {
+        if ( !hasArea( &rects[i].rect ) ) continue;
+        xs[n++] = rects[i].rect.x;
+        xs[n++] = rects[i].rect.x + rects[i].rect.width;
+    }
+
+    n = sortUnique( xs, n );
+    if ( n < 2 )
+    {
+        free( xs );
+        return 0;
+    }
+
+    unsigned int slabCount = n-1;
+    unsigned int capacity = slabCount*(2*count);
+    index->xs = xs;
+    index->slabCount = slabCount;
+    index->cellStart = malloc( (slabCount+1)*sizeof *index->cellStart );
+    index->ys = malloc( capacity*sizeof *index->ys );
+    index->masks = malloc( capacity*sizeof *index->masks );
+    double *breaks = malloc( (2*count+1)*sizeof *breaks );
+    if ( !index->cellStart || !index->ys || !index->masks || !breaks )
+    {
+        free( breaks );
+        SWRevealZoneIndexFree( index );
+        return -1;
+    }
+
+    unsigned int cells = 0;
+    for ( unsigned int s=0 ; s<slabCount ; s++ )
+    {
+        double x0 = index->xs[s], x1 = index->xs[s+1];
+
+        // cell boundaries are the distinct horizontal edges of the rectangles covering the slab
+        unsigned int k = 0;
+        for ( unsigned int i=0 ; i<count ; i++ )
+        {
+            const SWRevealRect *rect = &rects[i].rect;
+            if ( !hasArea( rect ) || rect->x > x0 || rect->x + rect->width < x1 ) continue;
+            breaks[k++] = rect->y;
+            breaks[k++] = rect->y + rect->height;
+        }
+        k = sortUnique( breaks, k );
+
+        index->cellStart[s] = cells;
+        for ( unsigned int j=0 ; j<k ; j++ )
+        {
+            // the last break closes the slab with an empty mask
+            unsigned int mask = 0;
+            for ( unsigned int i=0 ; j+1<k && i<count ; i++ )
+            {
+                const SWRevealRect *rect = &rects[i].rect;
+                if ( !hasArea( rect ) || rect->x > x0 || rect->x + rect->width < x1 ) continue;
+                if ( rect->y <= breaks[j] && rect->y + rect->height >= breaks[j+1] ) mask |= rects[i].mask;
+            }
+
+            // consecutive cells with the same mask are merged
+            if ( cells > index->cellStart[s] && index->masks[cells-1] == mask ) continue;
+            index->ys[cells] = breaks[j];
+            index->masks[cells] = mask;
+            cells += 1;
+        }
+    }
+    index->cellStart[slabCount] = cells;
+
+    free( breaks );
+    return 0;
+}
+
+
+unsigned int SWRevealZoneIndexLookup( const SWRevealZoneIndex *index, double x, double y )
+{
+    if ( index->slabCount == 0 || !(x >= index->xs[0] && x < index->xs[index->slabCount]) )
+        return 0;
+
+    unsigned int s = lastNotAbove( index->xs, index->slabCount+1, x );
+    unsigned int first = index->cellStart[s], end = index->cellStart[s+1];
+    if ( first == end || !(y >= index->ys[first]) )
+        return 0;
+
+    unsigned int j = first + lastNotAbove( index->ys+first, end-first, y );
+    return index->masks[j];
+}
+
+
+void SWRevealZoneIndexFree( SWRevealZoneIndex *index )
+{
+    free( index->xs );
+    free( index->cellStart );
+    free( index->ys );
+    free( index->masks );
+    memset( index, 0, sizeof *index );
+}
+
+
+/* Zone map */
+
+enum
+{
+    SWRevealZoneAllowMask = 1 << 0,
+    SWRevealZoneExcludeMask = 1 << 1,
+};
+
+
+void SWRevealZoneMapInit( SWRevealZoneMap *map )
+{
+    memset( map, 0, sizeof *map );
+}
+
+
+int SWRevealZoneMapAdd( SWRevealZoneMap *map, const SWRevealZone *zone )
+{
+    if ( map->count == map->capacity )
+    {
+        unsigned int capacity = map->capacity ? 2*map->capacity : 8;
+        SWRevealZone *zones = realloc( map->zones, capacity*sizeof *zones );
+        if ( !zones )
+            return -1;
+
+        map->zones = zones;
+        map->capacity = capacity;
+    }
+
+    map->zones[map->count++] = *zone;
+    map->compiled = 0;
+    return 0;
+}
+
+
+void SWRevealZoneMapRemoveAll( SWRevealZoneMap *map )
+{
+    map->count = 0;
+    map->compiled = 0;
+}
+
+
+// Resolves the rectangle of a zone for a view size
+static SWRevealRect resolvedRect( const SWRevealZone *zone, double width, double height )
+{
+    SWRevealRect rect = zone->rect;
+
+    if ( rect.width == 0.0 ) rect.x = 0.0, rect.width = width;
+    else if ( zone->edge == SWRevealZoneEdgeRight ) rect.x = width - rect.x - rect.width;
+
+    if ( rect.height == 0.0 ) rect.y = 0.0, rect.height = height;
+
+    return rect;
+}
+
+
+void SWRevealZoneMapCompile( SWRevealZoneMap *map, double width, double height )
+{
+    if ( map->compiled && map->width == width && map->height == height )
+        return;
+
+    SWRevealIndexedRect *rects = malloc( (map->count+1)*sizeof *rects );
+    map->allowPositions = 0;
+
+    for ( int position=0 ; position<SWRevealZonePositionCount ; position++ )
+    {
+        unsigned int count = 0;
+        for ( unsigned int i=0 ; rects && i<map->count ; i++ )
+        {
+            const SWRevealZone *zone = &map->zones[i];
+            if ( zone->positions != 0 && !(zone->positions & SWRevealZonePositionMask(position)) )
+                continue;
+
+            rects[count].rect = resolvedRect( zone, width, height );
+            rects[count].mask = zone->type == SWRevealZoneExclude ? SWRevealZoneExcludeMask : SWRevealZoneAllowMask;
+            if ( zone->type == SWRevealZoneAllow ) map->allowPositions |= SWRevealZonePositionMask(position);
+            count += 1;
+        }
+
+        // an index that fails to build is empty, gestures are then only restricted by the presence of allow zones
+        SWRevealZoneIndexBuild( &map->indexes[position], rects, count );
+    }
+
+    free( rects );
+    map->width = width;
+    map->height = height;
+    map->compiled = 1;
+}
+
+
+int SWRevealZoneMapAllows( const SWRevealZoneMap *map, SWRevealPosition position, double x, double y )
+{
+    if ( !map->compiled || position < 0 || position >= SWRevealZonePositionCount )
+        return 1;
+
+    unsigned int mask = SWRevealZoneIndexLookup( &map->indexes[position], x, y );
+    if ( mask & SWRevealZoneExcludeMask ) return 0;
+    if ( mask & SWRevealZoneAllowMask ) return 1;
+    return !(map->allowPositions & SWRevealZonePositionMask(position));
+}
+
+
+void SWRevealZoneMapFree( SWRevealZoneMap *map )
+{
+    for ( int position=0 ; position<SWRevealZonePositionCount ; position++ )
+        SWRevealZoneIndexFree( &map->indexes[position] );
+
+    free( map->zones );
+    memset( map, 0, sizeof *map );
+}
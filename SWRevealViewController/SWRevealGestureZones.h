@@ -0,0 +1,145 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+/*
+
+ SWRevealGestureZones
+
+ Portable zone map for SWRevealViewController. Zones are allow and exclude rectangles anchored to the left or right
+ edge of a view and restricted to some positions. For a given view size they are compiled into one interval index per
+ position, a list of vertical slabs each holding sorted vertical cells, so that any point is resolved with two binary
+ searches. The index is generic over cell masks, and it is also used to resolve extended hit tests on the views of the
+ reveal controller.
+
+*/
+
+#ifndef SWRevealGestureZones_h
+#define SWRevealGestureZones_h
+
+#include "SWRevealGeometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Index */
+
+// A rectangle with the mask it adds to the cells it covers
+typedef struct
+{
+    SWRevealRect rect;
+    unsigned int mask;
+
+} SWRevealIndexedRect;
+
+// Compiled index. Slab i spans xs[i] to xs[i+1], its cells are cellStart[i] to cellStart[i+1]-1, and cell j spans
+// ys[j] up to the next break of the slab with the given mask
+typedef struct
+{
+    double *xs;
+    unsigned int slabCount;
+    unsigned int *cellStart;
+    double *ys;
+    unsigned int *masks;
+
+} SWRevealZoneIndex;
+
+// Builds an index from 'count' rectangles, cells get the union of the masks of the rectangles covering them. Rectangles
+// with no area are ignored. Returns 0 on success or -1 on allocation failure, in which case the index is empty
+int SWRevealZoneIndexBuild( SWRevealZoneIndex *index, const SWRevealIndexedRect *rects, unsigned int count );
+
+// Returns the mask at a point, 0 if no rectangle covers it. Rectangles include their top left edges but not their bottom right ones
+unsigned int SWRevealZoneIndexLookup( const SWRevealZoneIndex *index, double x, double y );
+
+// Releases the memory of an index and leaves it empty. Zero filled indexes are empty
+void SWRevealZoneIndexFree( SWRevealZoneIndex *index );
+
+
+/* Zone map */
+
+// Zone types. Exclude zones take precedence, and points outside any zone are allowed unless there are allow zones
+typedef enum
+{
+    SWRevealZoneAllow,
+    SWRevealZoneExclude,
+
+} SWRevealZoneType;
+
+// Edge the x coordinate of a zone is measured from
+typedef enum
+{
+    SWRevealZoneEdgeLeft,       // <-- x is the distance from the left edge to the left side of the zone
+    SWRevealZoneEdgeRight,      // <-- x is the distance from the right edge to the right side of the zone
+
+} SWRevealZoneEdge;
+
+// Mask of positions for a zone, a zero mask applies the zone to all positions
+#define SWRevealZonePositionMask(position) (1u << (position))
+
+typedef struct
+{
+    SWRevealRect rect;          // <-- a zero width or height spans the whole view in that direction
+    SWRevealZoneType type;
+    SWRevealZoneEdge edge;
+    unsigned int positions;
+
+} SWRevealZone;
+
+#define SWRevealZonePositionCount 7
+
+typedef struct
+{
+    SWRevealZone *zones;
+    unsigned int count;
+    unsigned int capacity;
+    SWRevealZoneIndex indexes[SWRevealZonePositionCount];
+    unsigned int allowPositions;    // <-- mask of positions having allow zones
+    double width, height;
+    int compiled;
+
+} SWRevealZoneMap;
+
+// Initializes an empty map
+void SWRevealZoneMapInit( SWRevealZoneMap *map );
+
+// Adds a zone, the map must be compiled again. Returns 0 on success or -1 on allocation failure
+int SWRevealZoneMapAdd( SWRevealZoneMap *map, const SWRevealZone *zone );
+
+// Removes all zones
+void SWRevealZoneMapRemoveAll( SWRevealZoneMap *map );
+
+// Compiles the zones for a view size, this does nothing if they are already compiled for that size
+void SWRevealZoneMapCompile( SWRevealZoneMap *map, double width, double height );
+
+// Returns non zero if a gesture can begin at a point for a position. The map must be compiled
+int SWRevealZoneMapAllows( const SWRevealZoneMap *map, SWRevealPosition position, double x, double y );
+
+// Releases the memory of a map
+void SWRevealZoneMapFree( SWRevealZoneMap *map );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,199 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "SWRevealProgressStream.h"
+
+
+/* Layout */
+
+// Fields read by both sides, only written on creation, and the reference count
+typedef struct
+{
+    SWRevealProgressRecord *records;
+    unsigned int capacity;      // <-- a power of two
+    unsigned int references;
+    void *allocation;           // <-- the block holding the stream and its records
+
+} SWRevealProgressShared;
+
+// Each side keeps a cached copy of the other index, so that it only reads the shared one when the cached copy runs out
+typedef struct
+{
+    unsigned int head;          // <-- written by the producer
+    unsigned int cachedTail;
+    unsigned int sequence;
+    unsigned int pushed;
+    unsigned int dropped;
+
+} SWRevealProgressProducer;
+
+typedef struct
+{
+    unsigned int tail;          // <-- written by the consumer
+    unsigned int cachedHead;
+
+} SWRevealProgressConsumer;
+
+// Each part is padded to a full line, and the stream is allocated on a line boundary, so the producer and consumer
+// indices never share a line with each other or with the reference count
+struct SWRevealProgressStream
+{
+    SWRevealProgressShared shared;
+    char sharedPad[SWRevealProgressStreamCacheLineSize - sizeof(SWRevealProgressShared)];
+    SWRevealProgressProducer producer;
+    char producerPad[SWRevealProgressStreamCacheLineSize - sizeof(SWRevealProgressProducer)];
+    SWRevealProgressConsumer consumer;
+    char consumerPad[SWRevealProgressStreamCacheLineSize - sizeof(SWRevealProgressConsumer)];
+};
+
+
+/* Atomics */
+
+// The head is published with release semantics after the record is written, and read with acquire semantics
+// before the record is read. The tail works the other way round, so that a slot is only reused once it was copied
+#define loadAcquire( p ) __atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define loadRelaxed( p ) __atomic_load_n( (p), __ATOMIC_RELAXED )
+#define storeRelease( p, v ) __atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+
+
+/* Lifetime */
+
+SWRevealProgressStream *SWRevealProgressStreamCreate( unsigned int capacity )
+{
+    unsigned int size = 1;
+    while ( size < capacity && size < 0x80000000u ) size <<= 1;
+
+    // the records follow the stream in the same block, which is over allocated by a line to align it
+    size_t bytes = sizeof(SWRevealProgressStream) + (size_t)size*sizeof(SWRevealProgressRecord);
+    if ( (bytes - sizeof(SWRevealProgressStream))/sizeof(SWRevealProgressRecord) != size )
+        return NULL;
+
+    void *allocation = malloc( bytes + SWRevealProgressStreamCacheLineSize );
+    if ( allocation == NULL )
+        return NULL;
+
+    uintptr_t address = ((uintptr_t)allocation + SWRevealProgressStreamCacheLineSize-1) & ~(uintptr_t)(SWRevealProgressStreamCacheLineSize-1);
+    SWRevealProgressStream *stream = (SWRevealProgressStream *)address;
+
+    stream->shared.records = (SWRevealProgressRecord *)(stream + 1);
+    stream->shared.capacity = size;
+    stream->shared.references = 1;
+    stream->shared.allocation = allocation;
+    stream->producer.head = stream->producer.cachedTail = 0;
+    stream->producer.sequence = stream->producer.pushed = stream->producer.dropped = 0;
+    stream->consumer.tail = stream->consumer.cachedHead = 0;
+    return stream;
+}
+
+
+SWRevealProgressStream *SWRevealProgressStreamRetain( SWRevealProgressStream *stream )
+{
+    __atomic_add_fetch( &stream->shared.references, 1, __ATOMIC_RELAXED );
+    return stream;
+}
+
+
+void SWRevealProgressStreamRelease( SWRevealProgressStream *stream )
+{
+    if ( stream == NULL )
+        return;
+
+    // the last release must see every access made through the other references
+    if ( __atomic_sub_fetch( &stream->shared.references, 1, __ATOMIC_ACQ_REL ) == 0 )
+        free( stream->shared.allocation );
+}
+
+
+unsigned int SWRevealProgressStreamGetCapacity( const SWRevealProgressStream *stream )
+{
+    return stream->shared.capacity;
+}
+
+
+/* Producer */
+
+int SWRevealProgressStreamPush( SWRevealProgressStream *stream, const SWRevealProgressRecord *record )
+{
+    SWRevealProgressProducer *producer = &stream->producer;
+    unsigned int capacity = stream->shared.capacity;
+
+    // indices run freely and wrap around, their difference is the number of records in the ring
+    unsigned int head = producer->head;
+    unsigned int sequence = producer->sequence++;
+
+    if ( head - producer->cachedTail >= capacity )
+    {
+        producer->cachedTail = loadAcquire( &stream->consumer.tail );
+        if ( head - producer->cachedTail >= capacity )
+        {
+            __atomic_store_n( &producer->dropped, producer->dropped+1, __ATOMIC_RELAXED );
+            return 0;
+        }
+    }
+
+    SWRevealProgressRecord *slot = &stream->shared.records[head & (capacity-1)];
+    *slot = *record;
+    slot->sequence = sequence;
+
+    storeRelease( &producer->head, head+1 );
+    __atomic_store_n( &producer->pushed, producer->pushed+1, __ATOMIC_RELAXED );
+    return 1;
+}
+
+
+/* Consumer */
+
+unsigned int SWRevealProgressStreamDrain( SWRevealProgressStream *stream, SWRevealProgressRecord *records, unsigned int maxCount )
+{
+    SWRevealProgressConsumer *consumer = &stream->consumer;
+    unsigned int capacity = stream->shared.capacity;
+    unsigned int tail = consumer->tail;
+
+    unsigned int available = consumer->cachedHead - tail;
+    if ( available < maxCount )
+    {
+        consumer->cachedHead = loadAcquire( &stream->producer.head );
+        available = consumer->cachedHead - tail;
+    }
+
+    unsigned int count = available < maxCount ? available : maxCount;
+    for ( unsigned int i=0 ; i<count ; i++ )
+        records[i] = stream->shared.records[(tail+i) & (capacity-1)];
+
+    storeRelease( &consumer->tail, tail+count );
+    return count;
+}
+
+
+/* Counters */
+
+void SWRevealProgressStreamGetCounters( SWRevealProgressStream *stream, unsigned int *pPushed, unsigned int *pDropped )
+{
+    *pPushed = loadRelaxed( &stream->producer.pushed );
+    *pDropped = loadRelaxed( &stream->producer.dropped );
+}
@@ -0,0 +1,105 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+/*
+
+ SWRevealProgressStream
+
+ Portable lock free single producer, single consumer ring of reveal progress records for SWRevealViewController. The
+ controller pushes a fixed size record for every pan gesture move and animation step on the main thread, and a single
+ consumer on any thread drains them without locks or allocations. When the ring is full new records are dropped and
+ counted, so the producer never waits. Requires the gcc/clang __atomic builtins.
+
+ Streams are reference counted. The creator holds the first reference, and a consumer handed a stream on another
+ thread must retain it before use and release it when done, so the records stay allocated for as long as anyone can
+ read them. A released producer just stops pushing, the consumer can drain what is left and then let the stream go.
+
+*/
+
+#ifndef SWRevealProgressStream_h
+#define SWRevealProgressStream_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Record phases
+typedef enum
+{
+    SWRevealProgressPhaseGestureBegan,
+    SWRevealProgressPhaseGestureMoved,
+    SWRevealProgressPhaseGestureEnded,
+    SWRevealProgressPhaseAnimationTarget,   // <-- an animation started towards the recorded location
+    SWRevealProgressPhaseAnimationFrame,    // <-- a frame of a display link driven animation
+    SWRevealProgressPhaseAnimationEnded,
+
+} SWRevealProgressPhase;
+
+// Progress record, progress and overProgress are defined as in the pan gesture delegate methods
+typedef struct
+{
+    double timestamp;           // <-- in seconds, CACurrentMediaTime on iOS
+    double location;
+    double progress;
+    double overProgress;
+    unsigned int phase;
+    unsigned int sequence;      // <-- set on push, gaps show dropped records
+
+} SWRevealProgressRecord;
+
+// Ring of records, opaque. Producer and consumer indices are kept on separate cache lines
+typedef struct SWRevealProgressStream SWRevealProgressStream;
+
+// Size of the cache lines the producer and consumer sides are aligned to
+#define SWRevealProgressStreamCacheLineSize 64
+
+
+// Creates a stream holding at least 'capacity' records, with one reference. Returns NULL if it can not be allocated
+SWRevealProgressStream *SWRevealProgressStreamCreate( unsigned int capacity );
+
+// Any thread. Adds a reference to 'stream' and returns it
+SWRevealProgressStream *SWRevealProgressStreamRetain( SWRevealProgressStream *stream );
+
+// Any thread. Removes a reference, the stream is freed with the last one. Passing NULL does nothing
+void SWRevealProgressStreamRelease( SWRevealProgressStream *stream );
+
+// Any thread. Returns the number of records the ring holds, a power of two
+unsigned int SWRevealProgressStreamGetCapacity( const SWRevealProgressStream *stream );
+
+// Producer side. Pushes a copy of 'record' with the next sequence number. Returns 0 and counts a drop if the ring is full
+int SWRevealProgressStreamPush( SWRevealProgressStream *stream, const SWRevealProgressRecord *record );
+
+// Consumer side. Copies up to 'maxCount' of the oldest records to 'records' and removes them, returns the number copied
+unsigned int SWRevealProgressStreamDrain( SWRevealProgressStream *stream, SWRevealProgressRecord *records, unsigned int maxCount );
+
+// Any thread. Gets the number of records pushed and dropped so far
+void SWRevealProgressStreamGetCounters( SWRevealProgressStream *stream, unsigned int *pPushed, unsigned int *pDropped );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,214 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+#include "SWRevealShadow.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Blur */
+
+// Fills 'kernel' with 2*halfSize+1 normalized gaussian weights
+static void gaussianKernel( float *kernel, unsigned int halfSize, double sigma )
+{
+    double sum = 0.0;
+    for ( unsigned int i=0 ; i<2*halfSize+1 ; i++ )
+    {
+        double d = (double)i - halfSize;
+        double w = exp( -d*d/(2*sigma*sigma) );
+        kernel[i] = (float)w;
+        sum += w;
+    }
+
+    for ( unsigned int i=0 ; i<2*halfSize+1 ; i++ )
+        kernel[i] = (float)(kernel[i]/sum);
+}
+
+
+// dst[i] += w*src[i], the hot loop of both passes
+static void multiplyAdd( float *restrict dst, const float *restrict src, float w, unsigned int count )
+{
+    for ( unsigned int i=0 ; i<count ; i++ )
+        dst[i] += w*src[i];
+}
+
+
+static unsigned int kernelHalfSize( double sigma )
+{
+    return (unsigned int)ceil( 3*sigma );
+}
+
+
+// Horizontal pass, blurs 'rows' rows of 'src' into the zeroed 'dst'. Each kernel tap adds a shifted copy of the row
+static void blurRows( float *dst, const float *src, unsigned int width, unsigned int rows, const float *kernel, unsigned int halfSize )
+{
+    int h = (int)halfSize;
+    for ( unsigned int y=0 ; y<rows ; y++ )
+    {
+        const float *srcRow = src + (size_t)y*width;
+        float *dstRow = dst + (size_t)y*width;
+        for ( int k=-h ; k<=h ; k++ )
+        {
+            if ( (unsigned int)abs(k) >= width ) continue;
+            if ( k < 0 ) multiplyAdd( dstRow-k, srcRow, kernel[k+h], width+k );
+            else multiplyAdd( dstRow, srcRow+k, kernel[k+h], width-k );
+        }
+    }
+}
+
+
+/* Shadow image */
+
+static unsigned char componentByte( double value )
+{
+    if ( value <= 0.0 ) return 0;
+    if ( value >= 1.0 ) return 255;
+    return (unsigned char)(value*255.0 + 0.5);
+}
+
+
+int SWRevealShadowImageRender( SWRevealShadowImage *image, const SWRevealShadowConfig *config )
+{
+    memset( image, 0, sizeof *image );
+    image->config = *config;
+
+    // the layer shadow radius is taken as the standard deviation of the gaussian
+    double sigma = config->radius*config->scale;
+    unsigned int padding = sigma > 0.0 ? kernelHalfSize( sigma ) : 0;
+
+    // the rectangle is 2*padding+1 pixels wide so that the blur of its center row and column is not
+    // affected by its corners, these are the stretchable slices
+    unsigned int size = 4*padding + 1;
+    float *kernel = malloc( (2*padding+1)*sizeof *kernel );
+    float *box = calloc( 2*(size_t)size, sizeof *box );
+    unsigned char *pixels = malloc( (size_t)size*size*4 );
+    if ( kernel == NULL || box == NULL || pixels == NULL )
+    {
+        free( kernel );
+        free( box );
+        free( pixels );
+        return -1;
+    }
+
+    // the rectangle is the product of a horizontal and a vertical box, so its separable blur
+    // is the product of the blurred box profile with itself, which we compute just once
+    float *profile = box + size;
+    for ( unsigned int x=padding ; x<3*padding+1 ; x++ )
+        box[x] = 1.0f;
+
+    if ( padding > 0 )
+    {
+        gaussianKernel( kernel, padding, sigma );
+        blurRows( profile, box, size, 1, kernel, padding );
+    }
+    else
+    {
+        memcpy( profile, box, size*sizeof *box );
+    }
+
+    double alpha = config->alpha*config->opacity;
+    for ( unsigned int y=0 ; y<size ; y++ )
+    {
+        unsigned char *row = pixels + (size_t)y*size*4;
+        for ( unsigned int x=0 ; x<size ; x++ )
+        {
+            double a = alpha*profile[y]*profile[x];
+            row[4*x+0] = componentByte( config->red*a );
+            row[4*x+1] = componentByte( config->green*a );
+            row[4*x+2] = componentByte( config->blue*a );
+            row[4*x+3] = componentByte( a );
+        }
+    }
+
+    free( kernel );
+    free( box );
+    image->width = size;
+    image->height = size;
+    image->padding = padding;
+    image->capInset = 2*padding;
+    image->pixels = pixels;
+    return 0;
+}
+
+
+void SWRevealShadowImageFree( SWRevealShadowImage *image )
+{
+    free( image->pixels );
+    image->pixels = NULL;
+}
+
+
+/* Cache */
+
+static int configEqual( const SWRevealShadowConfig *a, const SWRevealShadowConfig *b )
+{
+    return a->radius == b->radius && a->red == b->red && a->green == b->green && a->blue == b->blue &&
+        a->alpha == b->alpha && a->opacity == b->opacity && a->scale == b->scale;
+}
+
+
+void SWRevealShadowCacheInit( SWRevealShadowCache *cache )
+{
+    memset( cache, 0, sizeof *cache );
+}
+
+
+const SWRevealShadowImage *SWRevealShadowCacheGetImage( SWRevealShadowCache *cache, const SWRevealShadowConfig *config )
+{
+    unsigned int slot = 0;
+    for ( unsigned int i=0 ; i<SWRevealShadowCacheSlots ; i++ )
+    {
+        SWRevealShadowImage *image = &cache->images[i];
+        if ( image->pixels != NULL && configEqual( &image->config, config ) )
+        {
+            cache->hits += 1;
+            cache->lastUse[i] = ++cache->clock;
+            return image;
+        }
+
+        // empty slots first, then the least recently used
+        if ( cache->images[slot].pixels != NULL && (image->pixels == NULL || cache->lastUse[i] < cache->lastUse[slot]) )
+            slot = i;
+    }
+
+    cache->misses += 1;
+    SWRevealShadowImage *image = &cache->images[slot];
+    SWRevealShadowImageFree( image );
+    if ( SWRevealShadowImageRender( image, config ) != 0 )
+        return NULL;
+
+    cache->lastUse[slot] = ++cache->clock;
+    return image;
+}
+
+
+void SWRevealShadowCacheFree( SWRevealShadowCache *cache )
+{
+    for ( unsigned int i=0 ; i<SWRevealShadowCacheSlots ; i++ )
+        SWRevealShadowImageFree( &cache->images[i] );
+}
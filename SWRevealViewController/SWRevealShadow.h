@@ -0,0 +1,103 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+/*
+
+ SWRevealShadow
+
+ Portable rendering of the front view shadow into a stretchable nine-slice image, as an alternative to a live
+ layer shadow. The shadow of a rectangle is rendered once per configuration with a separable gaussian blur, and
+ the image is stretched to any size by repeating its center row and column. A small cache keeps the images of the
+ most recently used configurations. Pixels are premultiplied RGBA, 8 bits per component.
+
+*/
+
+#ifndef SWRevealShadow_h
+#define SWRevealShadow_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shadow configuration. The shadow offset is not part of it, as it only affects where the image is placed
+typedef struct
+{
+    double radius;                      // <-- blur radius in points, as for a layer shadowRadius
+    double red, green, blue, alpha;     // <-- shadow color components, 0 to 1
+    double opacity;                     // <-- multiplies the color alpha
+    double scale;                       // <-- pixels per point
+
+} SWRevealShadowConfig;
+
+// Nine-slice shadow image. The shadowed rectangle starts 'padding' pixels inside each edge, the 'capInset' pixels
+// on each edge are the fixed slices, and the remaining center row and column are stretched
+typedef struct
+{
+    SWRevealShadowConfig config;
+    unsigned int width;
+    unsigned int height;
+    unsigned int padding;
+    unsigned int capInset;
+    unsigned char *pixels;              // <-- width*4 bytes per row, NULL if not rendered
+
+} SWRevealShadowImage;
+
+// Renders the shadow image for 'config', returns 0 on success or -1 if memory could not be allocated
+int SWRevealShadowImageRender( SWRevealShadowImage *image, const SWRevealShadowConfig *config );
+
+// Frees the pixels of an image
+void SWRevealShadowImageFree( SWRevealShadowImage *image );
+
+
+// Number of images kept by a cache
+#define SWRevealShadowCacheSlots 4
+
+// Cache of shadow images keyed by their configuration, the least recently used image is replaced when full
+typedef struct
+{
+    SWRevealShadowImage images[SWRevealShadowCacheSlots];
+    unsigned long lastUse[SWRevealShadowCacheSlots];
+    unsigned long clock;
+    unsigned int hits;
+    unsigned int misses;
+
+} SWRevealShadowCache;
+
+// Initializes an empty cache
+void SWRevealShadowCacheInit( SWRevealShadowCache *cache );
+
+// Returns the image for 'config', rendering it if it is not cached. The image remains valid until
+// a later call renders a different configuration or the cache is freed. Returns NULL if rendering failed
+const SWRevealShadowImage *SWRevealShadowCacheGetImage( SWRevealShadowCache *cache, const SWRevealShadowConfig *config );
+
+// Frees all cached images
+void SWRevealShadowCacheFree( SWRevealShadowCache *cache );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,188 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealSpring.h"
+
+
+/* Initialization */
+
+void SWRevealSpringInit( SWRevealSpring *spring, double dampingRatio, double angularFrequency, double distance, double velocity )
+{
+    double zeta = dampingRatio;
+    double omega = angularFrequency;
+    double x0 = -distance;      // <-- initial displacement from the target
+    double v0 = velocity;
+
+    spring->dampingRatio = dampingRatio;
+    spring->angularFrequency = angularFrequency;
+    spring->distance = distance;
+    spring->velocity = velocity;
+
+    if ( fabs(zeta-1.0) < 1e-6 )
+    {
+        spring->regime = SWRevealSpringCriticallyDamped;
+        spring->rateA = omega;
+        spring->rateB = 0.0;
+        spring->a = x0;
+        spring->b = v0 + omega*x0;
+    }
+    else if ( zeta < 1.0 )
+    {
+        double omegaD = omega*sqrt(1.0-zeta*zeta);
+        spring->regime = SWRevealSpringUnderdamped;
+        spring->rateA = zeta*omega;
+        spring->rateB = omegaD;
+        spring->a = x0;
+        spring->b = omegaD > 0.0 ? (v0 + zeta*omega*x0)/omegaD : 0.0;
+    }
+    else
+    {
+        // rateA is the slow root, closest to zero
+        double root = omega*sqrt(zeta*zeta-1.0);
+        double r1 = -zeta*omega + root;
+        double r2 = -zeta*omega - root;
+        double c2 = (v0 - r1*x0)/(r2-r1);
+        spring->regime = SWRevealSpringOverdamped;
+        spring->rateA = r1;
+        spring->rateB = r2;
+        spring->a = x0 - c2;
+        spring->b = c2;
+    }
+}
+
+
+/* Evaluation */
+
+// displacement from the target and its derivative at time t
+static void displacement( const SWRevealSpring *spring, double t, double *pX, double *pV )
+{
+    double a = spring->a, b = spring->b;
+
+    switch ( spring->regime )
+    {
+        case SWRevealSpringUnderdamped:
+        {
+            double decay = exp(-spring->rateA*t);
+            double c = cos(spring->rateB*t), s = sin(spring->rateB*t);
+            *pX = decay*(a*c + b*s);
+            *pV = decay*((b*spring->rateB - a*spring->rateA)*c - (a*spring->rateB + b*spring->rateA)*s);
+            break;
+        }
+        case SWRevealSpringCriticallyDamped:
+        {
+            double decay = exp(-spring->rateA*t);
+            *pX = decay*(a + b*t);
+            *pV = decay*(b - spring->rateA*(a + b*t));
+            break;
+        }
+        case SWRevealSpringOverdamped:
+        {
+            double ea = exp(spring->rateA*t), eb = exp(spring->rateB*t);
+            *pX = a*ea + b*eb;
+            *pV = a*spring->rateA*ea + b*spring->rateB*eb;
+            break;
+        }
+    }
+}
+
+
+double SWRevealSpringPosition( const SWRevealSpring *spring, double t )
+{
+    double x = 0.0, v = 0.0;
+    displacement( spring, t, &x, &v );
+    return spring->distance + x;
+}
+
+
+double SWRevealSpringVelocity( const SWRevealSpring *spring, double t )
+{
+    double x = 0.0, v = 0.0;
+    displacement( spring, t, &x, &v );
+    return v;
+}
+
+
+/* Settling */
+
+// Settling times are computed on the envelope of the displacement, so the result is conservative but monotonic.
+// The critically damped envelope (|a|+|b|t)*exp(-rate*t) has no closed form inverse. Past its peak, the logarithm of the
+// envelope over the tolerance is concave and decreasing, so Newton steps taken from above the root converge down onto it
+static double criticalSettlingTime( double a, double b, double rate, double tolerance )
+{
+    double lo = b > 0.0 ? fmax( 0.0, 1.0/rate - a/b ) : 0.0;
+    if ( (a + b*lo)*exp(-rate*lo) <= tolerance )
+        return 0.0;
+
+    double t = lo + 1.0/rate;
+    while ( (a + b*t)*exp(-rate*t) > tolerance ) t += (t-lo) + 1.0/rate;
+
+    double logTolerance = log(tolerance);
+    for ( int i=0 ; i<32 ; i++ )
+    {
+        double f = log(a + b*t) - rate*t - logTolerance;
+        double step = f/(b/(a + b*t) - rate);
+        t -= step;
+        if ( step < 1e-12*t ) break;
+    }
+    return t;
+}
+
+
+double SWRevealSpringSettlingTime( const SWRevealSpring *spring, double tolerance )
+{
+    if ( !(spring->dampingRatio > 0.0) || !(spring->angularFrequency > 0.0) || !(tolerance > 0.0) )
+        return HUGE_VAL;
+
+    double a = fabs(spring->a), b = fabs(spring->b);
+
+    switch ( spring->regime )
+    {
+        case SWRevealSpringUnderdamped:
+        {
+            double amplitude = sqrt(a*a + b*b);
+            return amplitude > tolerance ? log(amplitude/tolerance)/spring->rateA : 0.0;
+        }
+        case SWRevealSpringCriticallyDamped:
+            return criticalSettlingTime( a, b, spring->rateA, tolerance );
+
+        case SWRevealSpringOverdamped:
+        {
+            double amplitude = a + b;
+            return amplitude > tolerance ? log(amplitude/tolerance)/(-spring->rateA) : 0.0;
+        }
+    }
+    return 0.0;
+}
+
+
+double SWRevealSpringAngularFrequencyForSettlingTime( double dampingRatio, double settlingTime, double tolerance )
+{
+    // starting at rest, settling time scales with the inverse of the frequency
+    SWRevealSpring spring;
+    SWRevealSpringInit( &spring, dampingRatio, 1.0, 1.0, 0.0 );
+    return SWRevealSpringSettlingTime( &spring, tolerance )/settlingTime;
+}
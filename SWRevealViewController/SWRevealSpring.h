@@ -0,0 +1,94 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealSpring
+
+ Portable closed form damped spring for SWRevealViewController. Given a damping ratio, a natural frequency, the journey
+ distance and an initial velocity, it computes position, velocity and settling time at any time without integrating.
+ Underdamped, critically damped and overdamped springs are all supported. The controller uses it to turn the velocity
+ of a released pan gesture into an animation duration and an initial spring velocity.
+
+*/
+
+#ifndef SWRevealSpring_h
+#define SWRevealSpring_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default settling tolerance, relative to a unit journey
+#define SWRevealSpringDefaultTolerance 1e-3
+
+// Spring regimes
+typedef enum
+{
+    SWRevealSpringUnderdamped,
+    SWRevealSpringCriticallyDamped,
+    SWRevealSpringOverdamped,
+
+} SWRevealSpringRegime;
+
+// Damped spring moving from zero to 'distance'. Distance and velocity can be in any unit, for example points
+// and points per second, or journeys and journeys per second as used by UIKit spring animations
+typedef struct
+{
+    double dampingRatio;
+    double angularFrequency;    // <-- undamped natural frequency, in radians per second
+    double distance;
+    double velocity;            // <-- initial velocity
+
+    // resolved by SWRevealSpringInit, the displacement from the target is a*exp(rateA*t) + b*exp(rateB*t) for overdamped
+    // springs, exp(-rateA*t)*(a*cos(rateB*t) + b*sin(rateB*t)) for underdamped ones, and exp(-rateA*t)*(a + b*t) otherwise
+    SWRevealSpringRegime regime;
+    double a, b;
+    double rateA, rateB;
+
+} SWRevealSpring;
+
+
+// Initializes a spring. Damping ratios very close to 1 are treated as critically damped
+void SWRevealSpringInit( SWRevealSpring *spring, double dampingRatio, double angularFrequency, double distance, double velocity );
+
+// Returns the distance travelled from the start at time t
+double SWRevealSpringPosition( const SWRevealSpring *spring, double t );
+
+// Returns the velocity at time t
+double SWRevealSpringVelocity( const SWRevealSpring *spring, double t );
+
+// Returns the time after which the spring stays within 'tolerance' of its target. Returns HUGE_VAL if the spring never settles,
+// that is for a non positive damping ratio or frequency
+double SWRevealSpringSettlingTime( const SWRevealSpring *spring, double tolerance );
+
+// Returns the natural frequency of a spring that starting at rest settles a unit journey in 'settlingTime', within 'tolerance'
+double SWRevealSpringAngularFrequencyForSettlingTime( double dampingRatio, double settlingTime, double tolerance );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
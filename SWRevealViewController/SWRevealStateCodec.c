@@ -0,0 +1,224 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "SWRevealStateCodec.h"
+
+
+/* Format */
+
+// A blob is a header followed by the fields in layout order, all values are little endian
+//
+//  header:  'S' 'W' 'R' 'S' version(u8) fieldCount(u8)
+//  fields:  f64 for floating point values, u32 for the flags, u8 for enum values
+
+enum
+{
+    SWRevealStateHeaderSize = 6,
+};
+
+typedef enum
+{
+    SWRevealStateFieldF64,
+    SWRevealStateFieldU32,
+    SWRevealStateFieldU8,
+
+} SWRevealStateFieldType;
+
+typedef struct
+{
+    SWRevealStateFieldType type;
+    size_t offset;
+
+} SWRevealStateField;
+
+#define F64(name) { SWRevealStateFieldF64, offsetof(SWRevealState, name) }
+#define U32(name) { SWRevealStateFieldU32, offsetof(SWRevealState, name) }
+#define U8(name) { SWRevealStateFieldU8, offsetof(SWRevealState, name) }
+
+// The layout, new fields must be added at the end
+static const SWRevealStateField SWRevealStateFields[] =
+{
+    F64(rearViewRevealWidth),
+    F64(rearViewRevealOverdraw),
+    F64(rearViewRevealDisplacement),
+    F64(rightViewRevealWidth),
+    F64(rightViewRevealOverdraw),
+    F64(rightViewRevealDisplacement),
+    F64(quickFlickVelocity),
+    F64(toggleAnimationDuration),
+    F64(springDampingRatio),
+    F64(replaceViewAnimationDuration),
+    F64(frontViewShadowRadius),
+    F64(frontViewShadowOffsetWidth),
+    F64(frontViewShadowOffsetHeight),
+    F64(frontViewShadowOpacity),
+    F64(frontViewShadowRed),
+    F64(frontViewShadowGreen),
+    F64(frontViewShadowBlue),
+    F64(frontViewShadowAlpha),
+    F64(draggableBorderWidth),
+    F64(viewRetentionInterval),
+    U32(flags),
+    U8(toggleAnimationType),
+    U8(dragResistanceType),
+    U8(frontViewShadowStyle),
+    U8(viewRetentionPolicy),
+    U8(frontViewPosition),
+};
+
+#undef F64
+#undef U32
+#undef U8
+
+#define SWRevealStateFieldCount (sizeof SWRevealStateFields/sizeof SWRevealStateFields[0])
+
+
+static size_t fieldSize( SWRevealStateFieldType type )
+{
+    switch ( type )
+    {
+        case SWRevealStateFieldF64: return 8;
+        case SWRevealStateFieldU32: return 4;
+        case SWRevealStateFieldU8: return 1;
+    }
+    return 0;
+}
+
+
+/* Encoding */
+
+size_t SWRevealStateEncodedSize( void )
+{
+    size_t size = SWRevealStateHeaderSize;
+    for ( size_t i=0 ; i<SWRevealStateFieldCount ; i++ )
+        size += fieldSize( SWRevealStateFields[i].type );
+    return size;
+}
+
+
+size_t SWRevealStateEncode( const SWRevealState *state, unsigned char *bytes )
+{
+    unsigned char *p = bytes;
+    *p++ = 'S'; *p++ = 'W'; *p++ = 'R'; *p++ = 'S';
+    *p++ = SWRevealStateVersion;
+    *p++ = (unsigned char)SWRevealStateFieldCount;
+
+    const unsigned char *base = (const unsigned char *)state;
+    for ( size_t i=0 ; i<SWRevealStateFieldCount ; i++ )
+    {
+        const SWRevealStateField *field = &SWRevealStateFields[i];
+        switch ( field->type )
+        {
+            case SWRevealStateFieldF64:
+            {
+                double value;
+                uint64_t v;
+                memcpy( &value, base + field->offset, sizeof value );
+                memcpy( &v, &value, sizeof v );
+                for ( int k=0 ; k<8 ; k++ ) *p++ = (unsigned char)(v >> (8*k));
+                break;
+            }
+            case SWRevealStateFieldU32:
+            {
+                unsigned int value;
+                memcpy( &value, base + field->offset, sizeof value );
+                for ( int k=0 ; k<4 ; k++ ) *p++ = (unsigned char)(value >> (8*k));
+                break;
+            }
+            case SWRevealStateFieldU8:
+            {
+                int value;
+                memcpy( &value, base + field->offset, sizeof value );
+                *p++ = (unsigned char)(value < 0 ? 0 : value > 255 ? 255 : value);
+                break;
+            }
+        }
+    }
+
+    return (size_t)(p - bytes);
+}
+
+
+/* Decoding */
+
+int SWRevealStateDecode( const unsigned char *bytes, size_t length, SWRevealState *state )
+{
+    if ( bytes == NULL || length < SWRevealStateHeaderSize || memcmp( bytes, "SWRS", 4 ) != 0 || bytes[4] != SWRevealStateVersion )
+        return -1;
+
+    // we read the fields we know about, the blob must hold at least those it says it has
+    size_t count = bytes[5];
+    if ( count > SWRevealStateFieldCount ) count = SWRevealStateFieldCount;
+
+    size_t needed = SWRevealStateHeaderSize;
+    for ( size_t i=0 ; i<count ; i++ )
+        needed += fieldSize( SWRevealStateFields[i].type );
+
+    if ( length < needed )
+        return -1;
+
+    SWRevealState decoded = *state;
+    unsigned char *base = (unsigned char *)&decoded;
+    const unsigned char *p = bytes + SWRevealStateHeaderSize;
+    for ( size_t i=0 ; i<count ; i++ )
+    {
+        const SWRevealStateField *field = &SWRevealStateFields[i];
+        switch ( field->type )
+        {
+            case SWRevealStateFieldF64:
+            {
+                uint64_t v = 0;
+                double value;
+                for ( int k=0 ; k<8 ; k++ ) v |= (uint64_t)p[k] << (8*k);
+                memcpy( &value, &v, sizeof value );
+                if ( isfinite( value ) )
+                    memcpy( base + field->offset, &value, sizeof value );
+                break;
+            }
+            case SWRevealStateFieldU32:
+            {
+                unsigned int value = 0;
+                for ( int k=0 ; k<4 ; k++ ) value |= (unsigned int)p[k] << (8*k);
+                memcpy( base + field->offset, &value, sizeof value );
+                break;
+            }
+            case SWRevealStateFieldU8:
+            {
+                int value = p[0];
+                memcpy( base + field->offset, &value, sizeof value );
+                break;
+            }
+        }
+        p += fieldSize( field->type );
+    }
+
+    *state = decoded;
+    return 0;
+}
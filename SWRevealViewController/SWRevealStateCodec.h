@@ -0,0 +1,112 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+/*
+
+ SWRevealStateCodec
+
+ Portable fixed layout binary encoding of the SWRevealViewController configuration and position, for state
+ preservation and restoration. The whole state is encoded in a single blob and decoded in a single pass.
+
+ Fields are only ever appended to the layout. A blob records how many fields it contains, so fields missing
+ from blobs written by older versions keep the values passed in to the decoder, and fields added by newer
+ versions are ignored. The version number only changes if the layout changes in an incompatible way.
+
+*/
+
+#ifndef SWRevealStateCodec_h
+#define SWRevealStateCodec_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layout version written by the encoder, blobs with other versions are rejected
+#define SWRevealStateVersion 1
+
+// Boolean properties
+enum
+{
+    SWRevealStateBounceBackOnOverdraw = 1 << 0,
+    SWRevealStateBounceBackOnLeftOverdraw = 1 << 1,
+    SWRevealStateStableDragOnOverdraw = 1 << 2,
+    SWRevealStateStableDragOnLeftOverdraw = 1 << 3,
+    SWRevealStatePresentFrontViewHierarchically = 1 << 4,
+    SWRevealStateUserInteractionStore = 1 << 5,
+    SWRevealStateClipsViewsToBounds = 1 << 6,
+    SWRevealStateExtendsPointInsideHit = 1 << 7,
+    SWRevealStateInterruptibleAnimations = 1 << 8,
+    SWRevealStateRoutesNestedPanGestures = 1 << 9,
+};
+
+// Configuration and position of a reveal controller, enum values are those of SWRevealViewController.h
+typedef struct
+{
+    double rearViewRevealWidth;
+    double rearViewRevealOverdraw;
+    double rearViewRevealDisplacement;
+    double rightViewRevealWidth;
+    double rightViewRevealOverdraw;
+    double rightViewRevealDisplacement;
+    double quickFlickVelocity;
+    double toggleAnimationDuration;
+    double springDampingRatio;
+    double replaceViewAnimationDuration;
+    double frontViewShadowRadius;
+    double frontViewShadowOffsetWidth;
+    double frontViewShadowOffsetHeight;
+    double frontViewShadowOpacity;
+    double frontViewShadowRed, frontViewShadowGreen, frontViewShadowBlue, frontViewShadowAlpha;
+    double draggableBorderWidth;
+    double viewRetentionInterval;
+    unsigned int flags;                 // <-- SWRevealState* flags above
+    int toggleAnimationType;
+    int dragResistanceType;
+    int frontViewShadowStyle;
+    int viewRetentionPolicy;
+    int frontViewPosition;
+
+} SWRevealState;
+
+
+// Size of the blobs written by the encoder
+size_t SWRevealStateEncodedSize( void );
+
+// Writes 'state' to 'bytes', which must hold SWRevealStateEncodedSize bytes, and returns the number of bytes written
+size_t SWRevealStateEncode( const SWRevealState *state, unsigned char *bytes );
+
+// Reads a blob into 'state'. Fields not in the blob, and floating point fields that are not finite, keep their values
+// in 'state', so it should be set to the defaults. Returns 0 on success, or -1 if the blob is not valid, in which case
+// 'state' is left unchanged
+int SWRevealStateDecode( const unsigned char *bytes, size_t length, SWRevealState *state );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
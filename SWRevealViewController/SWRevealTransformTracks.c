@@ -0,0 +1,183 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SWRevealTransformTracks.h"
+
+
+/* Track management */
+
+void SWRevealTrackSetInit( SWRevealTrackSet *set )
+{
+    memset( set, 0, sizeof *set );
+}
+
+
+static int findTrack( const SWRevealTrackSet *set, SWRevealTrackLayer layer, SWRevealTrackProperty property )
+{
+    for ( unsigned int i=0 ; i<set->trackCount ; i++ )
+    {
+        if ( set->tracks[i].layer == (unsigned int)layer && set->tracks[i].property == (unsigned int)property )
+            return (int)i;
+    }
+    return -1;
+}
+
+
+void SWRevealTrackSetRemove( SWRevealTrackSet *set, SWRevealTrackLayer layer, SWRevealTrackProperty property )
+{
+    int index = findTrack( set, layer, property );
+    if ( index < 0 )
+        return;
+
+    // keyframes are kept packed, those of the following tracks move down
+    SWRevealTrack removed = set->tracks[index];
+    unsigned int tail = set->keyCount - (removed.first + removed.count);
+    memmove( set->keyProgress + removed.first, set->keyProgress + removed.first + removed.count, tail*sizeof(double) );
+    memmove( set->keyValues + removed.first, set->keyValues + removed.first + removed.count, tail*sizeof(double) );
+    set->keyCount -= removed.count;
+
+    for ( unsigned int i=index+1 ; i<set->trackCount ; i++ )
+    {
+        set->tracks[i-1] = set->tracks[i];
+        set->tracks[i-1].first -= removed.count;
+    }
+    set->trackCount -= 1;
+}
+
+
+int SWRevealTrackSetAdd( SWRevealTrackSet *set, SWRevealTrackLayer layer, SWRevealTrackProperty property,
+    const double *progress, const double *values, unsigned int count )
+{
+    if ( (unsigned int)layer >= SWRevealTrackLayerCount || (unsigned int)property >= SWRevealTrackPropertyCount || count == 0 )
+        return -1;
+
+    for ( unsigned int i=1 ; i<count ; i++ )
+    {
+        if ( !(progress[i] > progress[i-1]) )
+            return -1;
+    }
+
+    SWRevealTrackSetRemove( set, layer, property );
+
+    if ( set->keyCount + count > set->keyCapacity )
+    {
+        unsigned int capacity = set->keyCapacity ? 2*set->keyCapacity : 32;
+        while ( capacity < set->keyCount + count ) capacity *= 2;
+
+        double *keyProgress = realloc( set->keyProgress, capacity*sizeof *keyProgress );
+        if ( !keyProgress )
+            return -1;
+        set->keyProgress = keyProgress;
+
+        double *keyValues = realloc( set->keyValues, capacity*sizeof *keyValues );
+        if ( !keyValues )
+            return -1;
+        set->keyValues = keyValues;
+        set->keyCapacity = capacity;
+    }
+
+    SWRevealTrack *track = &set->tracks[set->trackCount++];
+    track->layer = layer;
+    track->property = property;
+    track->first = set->keyCount;
+    track->count = count;
+    track->segment = 0;
+
+    memcpy( set->keyProgress + set->keyCount, progress, count*sizeof(double) );
+    memcpy( set->keyValues + set->keyCount, values, count*sizeof(double) );
+    set->keyCount += count;
+    return 0;
+}
+
+
+void SWRevealTrackSetRemoveAll( SWRevealTrackSet *set )
+{
+    set->trackCount = 0;
+    set->keyCount = 0;
+}
+
+
+void SWRevealTrackSetFree( SWRevealTrackSet *set )
+{
+    free( set->keyProgress );
+    free( set->keyValues );
+    SWRevealTrackSetInit( set );
+}
+
+
+/* Evaluation */
+
+static const double identityValues[SWRevealTrackPropertyCount] = { 0.0, 0.0, 1.0, 1.0, 0.0 };
+
+// Returns the segment i such that x lies in [p[i], p[i+1]), or the ends when x is outside. The search
+// walks from the segment of the previous evaluation, which is usually the right one or next to it
+static unsigned int findSegment( const double *p, unsigned int count, unsigned int segment, double x )
+{
+    unsigned int last = count-2;
+    if ( segment > last ) segment = last;
+
+    while ( segment > 0 && x < p[segment] ) segment--;
+    while ( segment < last && x >= p[segment+1] ) segment++;
+    return segment;
+}
+
+
+void SWRevealTrackSetEvaluate( SWRevealTrackSet *set, double progress, SWRevealLayerValues *layers )
+{
+    for ( int i=0 ; i<SWRevealTrackLayerCount ; i++ )
+    {
+        memcpy( layers[i].values, identityValues, sizeof identityValues );
+        layers[i].mask = 0;
+    }
+
+    for ( unsigned int i=0 ; i<set->trackCount ; i++ )
+    {
+        SWRevealTrack *track = &set->tracks[i];
+        const double *p = set->keyProgress + track->first;
+        const double *v = set->keyValues + track->first;
+
+        double value;
+        if ( track->count == 1 || progress <= p[0] )
+        {
+            value = v[0];
+        }
+        else if ( progress >= p[track->count-1] )
+        {
+            value = v[track->count-1];
+        }
+        else
+        {
+            unsigned int s = findSegment( p, track->count, track->segment, progress );
+            track->segment = s;
+            value = v[s] + (v[s+1]-v[s])*(progress-p[s])/(p[s+1]-p[s]);
+        }
+
+        layers[track->layer].values[track->property] = value;
+        layers[track->layer].mask |= 1u << track->property;
+    }
+}
@@ -0,0 +1,125 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+
+/*
+
+ SWRevealTransformTracks
+
+ Portable keyframed tracks for SWRevealViewController, driving properties of the front, rear and right layers from the
+ reveal progress. A track maps the signed progress, positive while the rear view is revealed and negative while the right
+ view is, to a property value by linear interpolation between keyframes. All tracks are evaluated in a single pass into
+ one set of values per layer, each track remembers the keyframe segment of the last evaluation so that the small progress
+ changes between frames need no search.
+
+*/
+
+#ifndef SWRevealTransformTracks_h
+#define SWRevealTransformTracks_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layers driven by tracks
+typedef enum
+{
+    SWRevealTrackLayerFront,
+    SWRevealTrackLayerRear,
+    SWRevealTrackLayerRight,
+    SWRevealTrackLayerCount,
+
+} SWRevealTrackLayer;
+
+// Properties driven by tracks, translations and corner radius are in points
+typedef enum
+{
+    SWRevealTrackPropertyTranslationX,
+    SWRevealTrackPropertyTranslationY,
+    SWRevealTrackPropertyScale,
+    SWRevealTrackPropertyAlpha,
+    SWRevealTrackPropertyCornerRadius,
+    SWRevealTrackPropertyCount,
+
+} SWRevealTrackProperty;
+
+// Values of a layer, properties with no track keep their identity value, 0 or 1 for scale and alpha
+typedef struct
+{
+    double values[SWRevealTrackPropertyCount];
+    unsigned int mask;                  // <-- bit i is set if property i has a track
+
+} SWRevealLayerValues;
+
+// Track, its keyframes are a range of the set keyframes
+typedef struct
+{
+    unsigned int layer;
+    unsigned int property;
+    unsigned int first;
+    unsigned int count;
+    unsigned int segment;               // <-- segment of the last evaluation, relative to first
+
+} SWRevealTrack;
+
+// Set of tracks, at most one per layer and property
+typedef struct
+{
+    SWRevealTrack tracks[SWRevealTrackLayerCount*SWRevealTrackPropertyCount];
+    unsigned int trackCount;
+    double *keyProgress;
+    double *keyValues;
+    unsigned int keyCount;
+    unsigned int keyCapacity;
+
+} SWRevealTrackSet;
+
+
+// Initializes an empty set
+void SWRevealTrackSetInit( SWRevealTrackSet *set );
+
+// Adds a track with 'count' keyframes at ascending 'progress' values, replacing any track for the same layer and property.
+// The first and last values hold outside the keyframes. Returns 0 on success, or -1 if the keyframes are not ascending,
+// there are none, or they can not be allocated
+int SWRevealTrackSetAdd( SWRevealTrackSet *set, SWRevealTrackLayer layer, SWRevealTrackProperty property,
+    const double *progress, const double *values, unsigned int count );
+
+// Removes the track for a layer and property, if any
+void SWRevealTrackSetRemove( SWRevealTrackSet *set, SWRevealTrackLayer layer, SWRevealTrackProperty property );
+
+// Removes all tracks
+void SWRevealTrackSetRemoveAll( SWRevealTrackSet *set );
+
+// Evaluates all tracks at the signed 'progress' into 'layers', an array of SWRevealTrackLayerCount values
+void SWRevealTrackSetEvaluate( SWRevealTrackSet *set, double progress, SWRevealLayerValues *layers );
+
+// Releases the memory of a set
+void SWRevealTrackSetFree( SWRevealTrackSet *set );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
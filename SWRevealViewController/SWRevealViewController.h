@@ -28,7 +28,43 @@
 
  RELEASE NOTES
  
- Version 2.4.0 (Current Version)
+ Version 2.5.0 (Current Version)
+ 
+  - New portable geometry core, SWRevealGeometry, computes the front, rear and right frames for any number of locations at once.
+    See method getGeometryConfig:
+  - New properties 'dragResistanceType' and 'dragResistanceBlock'. Drag resistance curves are baked into lookup tables.
+  - Resolved reveal widths, navigation bar height and status bar inset are cached, and only resolved again on bounds or trait changes.
+  - New method 'setRearViewRevealWidth:rearViewRevealOverdraw:rightViewRevealWidth:rightViewRevealOverdraw:forHorizontalSizeClass:'
+  - Deferred requests are stored on a typed command queue that grows as needed. Obsolete requests are coalesced, see 'cancelPendingOperations'
+  - Layout passes only recompute the frames whose inputs changed, the front view shadow path is only rebuilt on size changes.
+  - New property 'interruptibleAnimations'. A pan gesture can grab the front view while it is animating.
+  - Spring animations are computed by an analytic spring, SWRevealSpring, and start with the release velocity of the pan gesture.
+  - The end position of a pan gesture is decided on the resting location projected from a fitted touch history, SWRevealFlingPredictor.
+  - New methods 'startRecordingGestureTrace' and 'stopRecordingGestureTrace'. Traces are replayed by SWRevealGestureTrace, or by the
+    Tools/SWRevealTraceReplay command line tool.
+  - New properties 'instrumentsFramePacing' and 'frameBudget', and delegate method 'revealController:didCollectFrameStats:duringGesture:'
+  - Delegate capabilities are looked up once when the delegate is set. New property 'coalescesPanGestureMoves'.
+  - New method 'prewarmChildViews' and properties 'prewarmsChildViews', 'prewarmTimeBudget'.
+  - New properties 'viewRetentionPolicy', 'viewRetentionInterval' and 'unloadsChildViewsOnMemoryWarning', closed rear and right containers can be reused.
+  - New method 'frontViewControllerForKey:provider:' providing a keyed cache of front controllers with LRU eviction.
+  - New property 'frontViewShadowStyle', the front view shadow can be a prerendered image instead of a live layer shadow.
+  - New properties 'nestingLevel' and 'routesNestedPanGestures'.
+  - State preservation encodes the configuration and position in a single versioned blob, see SWRevealStateCodec.h.
+  - Drag and release decisions of the controller and the gesture trace replay share the functions in SWRevealDrawerGeometry.h.
+  - New methods 'setRearViewDetents:' and 'setRightViewDetents:' to snap the front view to any number of stops, see SWRevealDetents.h.
+    Progress between stops is available as 'frontViewDetentProgress' and through 'revealController:movedToDetentProgress:'.
+  - Deployment rules are shared with a headless model that replays random command sequences and checks appearance invariants, see SWRevealDeployment.h and Tools/SWRevealDeploymentModel.h.
+  - Replaced controllers are only added to their container when their side is deployed.
+  - New method 'performBatchUpdates:animated:' to replace several controllers and change the position in a single transition.
+  - New method 'addPanGestureZone:type:edge:positions:' to declare where pan gestures can begin, see SWRevealGestureZones.h.
+  - Extended hit tests use an index of the child view frames, built when the frames change at rest.
+  - New property 'usesDisplayLinkAnimations' and delegate method 'revealController:animationMovedToLocation:progress:overProgress:'.
+    Curves are sampled ahead by SWRevealCurveSampler, curves too long to be sampled ahead are evaluated on each frame.
+  - New properties 'progressStreamCapacity' and 'progressStream', a lock free ring of progress records for background consumers.
+  - New method 'addTransformTrackForLayer:property:progress:values:' to drive translation, scale, alpha and corner radius of the
+    front, rear and right controller views from the reveal progress, see SWRevealTransformTracks.h.
+ 
+ Version 2.4.0
  
   - Updated behaviour of appearance method calls on child controllers
   - Removes Xcode 6.3.1 warnings
@@ -138,6 +174,9 @@
 
 
 #import <UIKit/UIKit.h>
+#import "SWRevealGeometry.h"
+#import "SWRevealFrameStats.h"
+#import "SWRevealProgressStream.h"
 
 @class SWRevealViewController;
 @protocol SWRevealViewControllerDelegate;
@@ -181,6 +220,64 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
     SWRevealToggleAnimationTypeEaseOut,   // <- produces an ease out curve animation
 };
 
+// Enum values for dragResistanceType
+typedef NS_ENUM(NSInteger, SWRevealDragResistanceType)
+{
+    SWRevealDragResistanceTypeLinearClamp,   // <- drags at half speed on the overdraw area up to a hard stop
+    SWRevealDragResistanceTypeRubberBand,    // <- progressively resists the drag, similar to a scroll view rubber band
+    SWRevealDragResistanceTypeExponential,   // <- exponentially approaches the overdraw limit
+    SWRevealDragResistanceTypeCustom,        // <- uses the curve provided by dragResistanceBlock
+};
+
+// Enum values for frontViewShadowStyle
+typedef NS_ENUM(NSInteger, SWRevealFrontViewShadowStyle)
+{
+    SWRevealFrontViewShadowStyleLayer,      // <- live layer shadow on the front view
+    SWRevealFrontViewShadowStyleImage,      // <- prerendered stretchable shadow image, see SWRevealShadow.h
+};
+
+// Enum values for viewRetentionPolicy
+typedef NS_ENUM(NSInteger, SWRevealViewRetentionPolicy)
+{
+    SWRevealViewRetentionPolicyNone,                 // <- rear and right containers are released when they are closed
+    SWRevealViewRetentionPolicyKeepAlive,            // <- containers are kept when closed, even on memory warnings
+    SWRevealViewRetentionPolicyExpire,               // <- containers are kept for viewRetentionInterval or until a memory warning
+    SWRevealViewRetentionPolicyUntilMemoryWarning,   // <- containers are kept until a memory warning
+};
+
+// Enum values for addPanGestureZone:type:edge:positions:
+typedef NS_ENUM(NSInteger, SWRevealGestureZoneType)
+{
+    SWRevealGestureZoneTypeAllow,       // <- pan gestures can begin in the zone
+    SWRevealGestureZoneTypeExclude,     // <- pan gestures never begin in the zone, this takes precedence over allow zones
+};
+
+typedef NS_ENUM(NSInteger, SWRevealGestureZoneEdge)
+{
+    SWRevealGestureZoneEdgeLeft,        // <- the zone x origin is the distance from the left edge to its left side
+    SWRevealGestureZoneEdgeRight,       // <- the zone x origin is the distance from the right edge to its right side
+};
+
+// Position masks for addPanGestureZone:type:edge:positions:, combine them with the | operator
+#define FrontViewPositionMask(position) (1u << (position))
+
+// Enum values for addTransformTrackForLayer:property:progress:values:
+typedef NS_ENUM(NSInteger, SWRevealTransformTrackLayer)
+{
+    SWRevealTransformTrackLayerFront,               // <- the layer of the frontViewController view
+    SWRevealTransformTrackLayerRear,                // <- the layer of the rearViewController view
+    SWRevealTransformTrackLayerRight,               // <- the layer of the rightViewController view
+};
+
+typedef NS_ENUM(NSInteger, SWRevealTransformTrackProperty)
+{
+    SWRevealTransformTrackPropertyTranslationX,     // <- in points, identity is 0
+    SWRevealTransformTrackPropertyTranslationY,     // <- in points, identity is 0
+    SWRevealTransformTrackPropertyScale,            // <- scale around the layer center, identity is 1
+    SWRevealTransformTrackPropertyAlpha,            // <- layer opacity, identity is 1
+    SWRevealTransformTrackPropertyCornerRadius,     // <- in points, the layer masks to bounds while it is positive
+};
+
 
 @interface SWRevealViewController : UIViewController
 
@@ -205,11 +302,56 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 // presented frontViewController to the right most possition, replacing it, and moving it back to the left position
 - (void)pushFrontViewController:(UIViewController *)frontViewController animated:(BOOL)animated;
 
+// Keyed cache of front controllers. The following method returns the controller cached for the given key, or calls the provider block
+// to create one and caches it. Use it with setFrontViewController or pushFrontViewController to switch back to recently shown
+// controllers without rebuilding them. The least recently used controllers are removed when there are more than
+// 'frontViewControllerCacheCountLimit' (default is 4), or when their loaded views are estimated to take more than
+// 'frontViewControllerCacheCostLimit' bytes (default is 0, no limit). The presented frontViewController is never removed,
+// nor is a controller just returned by the provider, so it survives until it is presented even with a limit of 1.
+// Cached controllers other than the presented one are removed on memory warnings
+- (UIViewController *)frontViewControllerForKey:(id<NSCopying>)key provider:(UIViewController *(^)(void))provider;
+- (void)removeCachedFrontViewControllerForKey:(id<NSCopying>)key;
+- (void)removeAllCachedFrontViewControllers;
+@property (nonatomic) NSUInteger frontViewControllerCacheCountLimit;
+@property (nonatomic) NSUInteger frontViewControllerCacheCostLimit;
+@property (nonatomic, readonly) NSUInteger frontViewControllerCacheHits;    // <-- number of lookups returning a cached controller
+@property (nonatomic, readonly) NSUInteger frontViewControllerCacheMisses;  // <-- number of lookups that called the provider
+
 // Sets the frontViewController position. You can call the animated version several times with different
 // positions to obtain a set of animations that will be performed in order one after the other.
 @property (nonatomic) FrontViewPosition frontViewPosition;
 - (void)setFrontViewPosition:(FrontViewPosition)frontViewPosition animated:(BOOL)animated;
 
+// Animated position changes and controller replacements requested while an animation is in progress are enqueued.
+// Consecutive position changes are collapsed into the last one, and a push is dropped if a later push supersedes it before
+// it starts. The following method removes any enqueued requests that did not start yet.
+- (void)cancelPendingOperations;
+
+// Collects the controller replacements and the position change requested in 'updates', through the setRearViewController,
+// setFrontViewController, setRightViewController and setFrontViewPosition methods, and performs them as a single request with one
+// containment pass, one layout and one animation that cross dissolves the replaced views while the front view moves. Delegate
+// willAdd and didAdd calls are still sent for each replaced controller, but animation controllers are not requested. Later calls
+// for the same controller or the position override earlier ones. The animated flags of the calls are ignored. Nested batches are
+// performed with the outermost one
+- (void)performBatchUpdates:(void (^)(void))updates animated:(BOOL)animated;
+
+// Sets stops for the front view in addition to the closed location, as ascending offsets in points from it, for example
+// @[@60, @260] for a compact rail and a full reveal. Released pan gestures on a side with stops snap to the stop the fling
+// would come to rest closest to. Drags are still resisted past the reveal width plus overdraw, so stops should not be further.
+// Pass nil to restore the default positions
+- (void)setRearViewDetents:(NSArray *)offsets;
+- (void)setRightViewDetents:(NSArray *)offsets;  // <-- simetric implementation of the above for the rightViewController
+
+// The stop the front view rests at: 0 when closed, 1 and above for rear stops, -1 and below for right stops. On a side with no
+// stops set, the preset stops of SWRevealDetentSideInitWithRevealWidth are used, stop 1 is the reveal width and stop 2, only
+// with a nonzero overdraw, the reveal width plus overdraw. On a side with stops set, it is 0 while the front view is at a
+// position set with setFrontViewPosition. The method below animates to a given stop, stops past the last one are clamped to it
+@property (nonatomic, readonly) NSInteger frontViewDetent;
+- (void)setFrontViewDetent:(NSInteger)detent animated:(BOOL)animated;
+
+// The fractional stop at the current front view location, for example 1.5 is halfway between rear stops 1 and 2
+@property (nonatomic, readonly) CGFloat frontViewDetentProgress;
+
 // The following methods are meant to be directly connected to the action method of a button
 // to perform user triggered postion change of the controller views. This is ussually added to a
 // button on top left or right of the frontViewController
@@ -235,6 +377,25 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 // Thus, you can disable user interactions on your frontViewController view without affecting the tap recognizer.
 - (UITapGestureRecognizer*)tapGestureRecognizer;
 
+// Creates the rear and right container views and loads the rear and right controller views in small slices while the main run loop
+// is idle, so that the first drag does not pay for it. Each idle slice takes about 'prewarmTimeBudget', default is 0.004 seconds, or
+// a single step if it takes longer. Prewarming is cancelled if a pan gesture begins. If 'prewarmsChildViews' is YES (default is NO)
+// this is called on viewDidAppear
+- (void)prewarmChildViews;
+@property (nonatomic) BOOL prewarmsChildViews;
+@property (nonatomic) NSTimeInterval prewarmTimeBudget;
+
+// The following methods record the configuration and the events of the pan gestures into a compact binary trace,
+// (see SWRevealGestureTrace.h). Traces can be replayed off device with SWRevealTraceReplay to reproduce how gestures were
+// resolved. The stop method returns the recorded trace, or nil if no recording was started
+- (void)startRecordingGestureTrace;
+- (NSData*)stopRecordingGestureTrace;
+
+// Fills the passed in config with the current layout state of the controller views, the config is zeroed if the view is not loaded.
+// You can use it with the functions in SWRevealGeometry.h to compute the frames of the front, rear and right views
+// for any number of front view locations at once, for example to precompute the keyframes of a custom transition.
+- (void)getGeometryConfig:(SWRevealGeometryConfig*)config;
+
 /* The following properties are provided for further customization, they are set to default values on initialization,
    you do not generally have to set them */
 
@@ -244,6 +405,13 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 @property (nonatomic) CGFloat rearViewRevealWidth;
 @property (nonatomic) CGFloat rightViewRevealWidth; // <-- simetric implementation of the above for the rightViewController
 
+// Sets reveal widths and overdraws to be used instead of the values of the above properties while the controller view has the
+// given horizontal size class. Passing UIUserInterfaceSizeClassUnspecified just sets the properties. Size classes are available on iOS8 and later.
+- (void)setRearViewRevealWidth:(CGFloat)rearViewRevealWidth rearViewRevealOverdraw:(CGFloat)rearViewRevealOverdraw
+    rightViewRevealWidth:(CGFloat)rightViewRevealWidth rightViewRevealOverdraw:(CGFloat)rightViewRevealOverdraw
+    forHorizontalSizeClass:(UIUserInterfaceSizeClass)sizeClass;
+- (void)removeRevealWidthsForHorizontalSizeClass:(UIUserInterfaceSizeClass)sizeClass;
+
 // Defines how much of an overdraw can occur when dragging further than 'rearViewRevealWidth', default is 60.
 @property (nonatomic) CGFloat rearViewRevealOverdraw;
 @property (nonatomic) CGFloat rightViewRevealOverdraw;   // <-- simetric implementation of the above for the rightViewController
@@ -252,10 +420,40 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 @property (nonatomic) CGFloat rearViewRevealDisplacement;
 @property (nonatomic) CGFloat rightViewRevealDisplacement;  // <-- simetric implementation of the above for the rightViewController
 
+// Adds a keyframed track driving a property of a child controller view layer from the reveal progress, replacing any track for the
+// same layer and property. 'progress' are ascending NSNumbers, positive while the rear view is revealed and negative while the right
+// view is, so 1 is FrontViewPositionRight and -1 is FrontViewPositionLeftSide. 'values' are NSNumbers, interpolated linearly between
+// keyframes and held outside them. All tracks are evaluated in a single pass whenever the views are laid out, and written to the
+// layers directly, inside the animation block for animated position changes. Translation and scale are applied as the sublayer
+// transform of the view containing the controller view, so the controller view keeps an identity transform and can be sized by
+// its frame. Removed tracks restore the identity transform and the alpha, corner radius and masksToBounds the layer had before,
+// which is also done when the controller view is removed from its container
+- (void)addTransformTrackForLayer:(SWRevealTransformTrackLayer)layer property:(SWRevealTransformTrackProperty)property
+    progress:(NSArray *)progress values:(NSArray *)values;
+- (void)removeAllTransformTracks;
+
 // Defines a width on the border of the view attached to the panGesturRecognizer where the gesture is allowed,
 // default is 0 which means no restriction.
 @property (nonatomic) CGFloat draggableBorderWidth;
 
+// Allow and exclude zones for pan gestures, in the coordinates of the view the panGestureRecognizer is attached to. A pan
+// gesture can not begin in an exclude zone, and if there are allow zones for the current position it can only begin in one
+// of them. A zero width or height spans the whole view, and 'positions' is a combination of FrontViewPositionMask values,
+// or 0 for all positions. Zones are compiled into an interval index when they or the view size change, so they are checked
+// with no delegate call before revealControllerPanGestureShouldBegin: and the draggableBorderWidth strips
+- (void)addPanGestureZone:(CGRect)rect type:(SWRevealGestureZoneType)type edge:(SWRevealGestureZoneEdge)edge positions:(NSUInteger)positions;
+- (void)removeAllPanGestureZones;
+
+// If YES (default is NO) the pan gestures of nested reveal controllers that set this property are arbitrated at a single point.
+// When the pan recognizers of several of them receive the same touch, the deepest one whose position, draggable border and delegate
+// allow the gesture handles it, and the others decline without running their own checks. If its recognizer fails before the
+// gesture begins, for example on a vertical move, the next level that is asked handles it instead. This lets you attach the recognizers
+// of several levels to the same views, for example to close an inner rear view or to reveal an outer one from the same navigation bar
+@property (nonatomic) BOOL routesNestedPanGestures;
+
+// Number of reveal controllers this controller is nested in, 0 for a top level reveal controller
+@property (nonatomic, readonly) NSUInteger nestingLevel;
+
 // If YES (the default) the controller will bounce to the Left position when dragging further than 'rearViewRevealWidth'
 @property (nonatomic) BOOL bounceBackOnOverdraw;
 @property (nonatomic) BOOL bounceBackOnLeftOverdraw;  // <-- simetric implementation of the above for the rightViewController
@@ -264,13 +462,22 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 @property (nonatomic) BOOL stableDragOnOverdraw;
 @property (nonatomic) BOOL stableDragOnLeftOverdraw; // <-- simetric implementation of the above for the rightViewController
 
+// Defines how the front view follows a drag on the overdraw area when it is not stable, default is SWRevealDragResistanceTypeLinearClamp
+@property (nonatomic) SWRevealDragResistanceType dragResistanceType;
+
+// Custom resistance curve for SWRevealDragResistanceTypeCustom. The block receives the drag distance into the overdraw area and must
+// return the resulting front view displacement, both relative to the overdraw width. Returned values are clamped to the [0,1] range.
+// The curve is sampled into a lookup table when the reveal widths, overdraws or bounce flags change, not on every drag
+@property (nonatomic, copy) CGFloat (^dragResistanceBlock)(CGFloat overshoot);
+
 // If YES (default is NO) the front view controller will be ofsseted vertically by the height of a navigation bar.
 // Use this on iOS7 when you add an instance of RevealViewController as a child of a UINavigationController (or another SWRevealViewController)
 // and you want the front view controller to be presented below the navigation bar of its UINavigationController grand parent.
 // The rearViewController will still appear full size and blurred behind the navigation bar of its UINavigationController grand parent
 @property (nonatomic) BOOL presentFrontViewHierarchically;
 
-// Velocity required for the controller to toggle its state based on a swipe movement, default is 250
+// Velocity above which a swipe is a quick flick, default is 250. Quick flicks are not bounced back from the overdraw area
+// and their velocity determines the animation duration. The end position is otherwise decided on the projected resting location
 @property (nonatomic) CGFloat quickFlickVelocity;
 
 // Duration for the revealToggle animation, default is 0.25
@@ -282,6 +489,44 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 // When animation type is SWRevealToggleAnimationTypeSpring determines the damping ratio, default is 1
 @property (nonatomic) CGFloat springDampingRatio;
 
+// If YES (default is NO) touching the front view while it animates to a new position stops it where it is on screen, and a pan gesture
+// continues dragging it from there. Once the pan begins, pending position changes are superseded by the position where the gesture ends.
+// If the touch does not turn into a pan the animation resumes to its target, and pending position changes run as requested
+@property (nonatomic) BOOL interruptibleAnimations;
+
+// If YES (default is NO) position animations move the front view from a display link at the screen refresh rate, along the same ease
+// out or spring curve, and 'revealController:animationMovedToLocation:progress:overProgress:' is called on every frame. Rear and right
+// views follow the front view, the animations of 'revealController:animateToPosition:' still run on UIKit. On ProMotion iPhones the
+// app Info.plist must set CADisableMinimumFrameDurationOnPhone to get 120 Hz
+@property (nonatomic) BOOL usesDisplayLinkAnimations;
+
+// If not zero (default is zero) gesture moves and animation steps are also pushed as records into 'progressStream', a ring holding at
+// least that many records. A single consumer on any thread may drain it with SWRevealProgressStreamDrain, see SWRevealProgressStream.h.
+// Records are dropped and counted when the ring is full. The stream is reference counted: get it on the main thread and retain it with
+// SWRevealProgressStreamRetain before handing it to the consumer, which releases it when done. Setting the capacity or deallocating the
+// controller drops the controller reference, a retained stream stays valid but receives no more records
+@property (nonatomic) NSUInteger progressStreamCapacity;
+@property (nonatomic,readonly) SWRevealProgressStream *progressStream;  // <-- NULL if the capacity is zero, not retained
+
+// If YES (default is NO) the controller measures frame pacing during pan gestures and position animations. Display frame intervals
+// and the time spent handling each gesture move are measured against 'frameBudget', default is 1/60 seconds. A summary is delivered
+// to the delegate when each gesture or animation ends
+@property (nonatomic) BOOL instrumentsFramePacing;
+@property (nonatomic) NSTimeInterval frameBudget;
+
+// Defines what happens to the rear and right container views when they are closed, default is SWRevealViewRetentionPolicyNone.
+// Retained containers keep their child controller view and are taken out of the view hierarchy, so appearance methods are called
+// as usual, then put back as they are on the next open. On memory warnings, policies other than None and KeepAlive release
+// retained containers
+@property (nonatomic) SWRevealViewRetentionPolicy viewRetentionPolicy;
+
+// Time a closed container is kept for SWRevealViewRetentionPolicyExpire, default is 30 seconds
+@property (nonatomic) NSTimeInterval viewRetentionInterval;
+
+// If YES (default is NO) memory warnings that release retained containers also unload the views of rear and right controllers
+// that are not displayed. Only set this if these controllers can rebuild their views from their own state
+@property (nonatomic) BOOL unloadsChildViewsOnMemoryWarning;
+
 // Duration for animated replacement of view controllers
 @property (nonatomic) NSTimeInterval replaceViewAnimationDuration;
 
@@ -297,6 +542,11 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 // Defines the front view's shadow color, default is blackColor
 @property (nonatomic) UIColor *frontViewShadowColor;
 
+// Defines how the front view's shadow is drawn, default is SWRevealFrontViewShadowStyleLayer. With SWRevealFrontViewShadowStyleImage
+// the shadow is rendered once for the current radius, opacity and color into a stretchable image placed behind the front controller
+// view, so that no live shadow is drawn while the front view moves. The color should be opaque for this style
+@property (nonatomic) SWRevealFrontViewShadowStyle frontViewShadowStyle;
+
 // Defines whether the controller should clip subviews to its view bounds. Default is NO.
 // Set this to YES when you are presenting this controller as a non full-screen child of a
 // custom container controller which does not explicitly clips its subviews.
@@ -310,9 +560,13 @@ typedef NS_ENUM(NSInteger, SWRevealToggleAnimationType)
 /* The class properly handles all the relevant calls to appearance methods on the contained controllers.
    Moreover you can assign a delegate to let the class inform you on positions and animation activity */
 
-// Delegate
+// Delegate. The optional methods it implements are looked up when it is set, so set it again if you add methods at runtime
 @property (nonatomic,weak) id<SWRevealViewControllerDelegate> delegate;
 
+// If YES (default is NO) 'revealController:panGestureMovedToLocation:progress:overProgress:' is called at most once per display frame
+// with the latest values, instead of once per touch move. A pending move is always delivered before the gesture ended methods
+@property (nonatomic) BOOL coalescesPanGestureMoves;
+
 @end
 
 
@@ -367,6 +621,20 @@ typedef enum
 - (void)revealController:(SWRevealViewController *)revealController panGestureMovedToLocation:(CGFloat)location progress:(CGFloat)progress overProgress:(CGFloat)overProgress;
 - (void)revealController:(SWRevealViewController *)revealController panGestureEndedToLocation:(CGFloat)location progress:(CGFloat)progress overProgress:(CGFloat)overProgress;
 
+// Same as above for every frame of a position animation, only if 'usesDisplayLinkAnimations' is set
+- (void)revealController:(SWRevealViewController *)revealController animationMovedToLocation:(CGFloat)location progress:(CGFloat)progress overProgress:(CGFloat)overProgress;
+
+// Called as the front view moves between stops during pan gestures and display link animations, see 'frontViewDetentProgress'
+- (void)revealController:(SWRevealViewController *)revealController movedToDetentProgress:(CGFloat)detentProgress;
+
+// Frame pacing statistics for a pan gesture or a position animation that just ended, only if 'instrumentsFramePacing' is set.
+// Work durations are only measured for gestures. The stats are only valid during the call
+- (void)revealController:(SWRevealViewController *)revealController didCollectFrameStats:(const SWRevealFrameStats *)stats duringGesture:(BOOL)duringGesture;
+
+// Called when retained rear or right views change, see 'viewRetentionPolicy'. 'bytes' is an estimate of the memory used by the
+// loaded views of the controllers whose containers are retained, assuming a 32 bit backing store the size of each view
+- (void)revealController:(SWRevealViewController *)revealController didRetainViewCount:(NSUInteger)count estimatedBytes:(NSUInteger)bytes;
+
 // Notification of child controller replacement
 - (void)revealController:(SWRevealViewController *)revealController willAddViewController:(UIViewController *)viewController
     forOperation:(SWRevealControllerOperation)operation animated:(BOOL)animated;
@@ -387,7 +655,8 @@ typedef enum
 
 #pragma mark - UIViewController(SWRevealViewController) Category
 
-// A category of UIViewController to let childViewControllers easily access their parent SWRevealViewController
+// A category of UIViewController to let childViewControllers easily access their parent SWRevealViewController.
+// The parent chain is walked up to the closest reveal controller on every call
 @interface UIViewController(SWRevealViewController)
 
 - (SWRevealViewController*)revealViewController;
@@ -25,8 +25,23 @@
 */
 
 #import <QuartzCore/QuartzCore.h>
+#import <objc/runtime.h>
 
 #import "SWRevealViewController.h"
+#import "SWRevealGeometry.h"
+#import "SWRevealDragResistance.h"
+#import "SWRevealCommandQueue.h"
+#import "SWRevealSpring.h"
+#import "SWRevealFlingPredictor.h"
+#import "SWRevealGestureTrace.h"
+#import "SWRevealShadow.h"
+#import "SWRevealStateCodec.h"
+#import "SWRevealDrawerGeometry.h"
+#import "SWRevealDetents.h"
+#import "SWRevealDeployment.h"
+#import "SWRevealGestureZones.h"
+#import "SWRevealCurveSampler.h"
+#import "SWRevealTransformTracks.h"
 
 
 #pragma mark - StatusBar Helper Function
@@ -47,17 +62,66 @@ static CGFloat statusBarAdjustment( UIView* view )
 }
 
 
+#pragma mark - Color Helper Function
+
+// Gets the RGBA components of a color, grayscale colors are converted
+static void SWGetColorComponents( UIColor *color, CGFloat *red, CGFloat *green, CGFloat *blue, CGFloat *alpha )
+{
+    *red = *green = *blue = 0.0f;
+    *alpha = 1.0f;
+    if ( color && ![color getRed:red green:green blue:blue alpha:alpha] )
+    {
+        CGFloat white = 0.0f;
+        [color getWhite:&white alpha:alpha];
+        *red = *green = *blue = white;
+    }
+}
+
+
 #pragma mark - SWRevealView Class
 
 @interface SWRevealView: UIView
 {
     __weak SWRevealViewController *_c;
+    SWRevealMetrics _metrics;
+    BOOL _metricsValid;
+    BOOL _barMetricsValid;
+    SWRevealResistanceTable _dragResistanceTables[2];
+    SWRevealDrawerConfig _drawerConfig;     // <-- baked with the tables, sides are filled on each request
+    BOOL _dragResistanceValid;
+    SWRevealLayoutState _layoutState;
+    SWRevealLayoutDirtyFlags _layoutDirty;
+    CGFloat _layoutLocation;
+    CGFloat _placedLocation;
+    CGFloat _layoutFrontOffset;
+    BOOL _layoutStateValid;
+    UIImageView *_shadowImageView;
+    SWRevealZoneIndex _hitIndex;
+    BOOL _hitIndexValid;
+    UIView *_retainedRearView;
+    UIView *_retainedRightView;
 }
 
 @property (nonatomic, readonly) UIView *rearView;
 @property (nonatomic, readonly) UIView *rightView;
 @property (nonatomic, readonly) UIView *frontView;
 @property (nonatomic, assign) BOOL disableLayout;
+@property (nonatomic, assign) BOOL drivesLocation;
+@property (nonatomic, readonly) BOOL hasLayout;
+
+- (void)getGeometryConfig:(SWRevealGeometryConfig*)config;
+- (CGFloat)hierarchycalFrontOffset;
+- (const SWRevealMetrics*)metrics;
+- (void)invalidateMetrics;
+- (void)loadRearView;
+- (void)loadRightView;
+- (void)retainRearView;
+- (void)retainRightView;
+- (CGFloat)stopAnimations;
+- (void)placeFrontViewAtXLocation:(CGFloat)xLocation;
+- (void)invalidateLocation;
+- (void)invalidateRearFrames;
+- (void)getDrawerConfig:(SWRevealDrawerConfig*)config;
 
 @end
 
@@ -65,20 +129,21 @@ static CGFloat statusBarAdjustment( UIView* view )
 @interface SWRevealViewController()
 - (void)_getRevealWidth:(CGFloat*)pRevealWidth revealOverDraw:(CGFloat*)pRevealOverdraw forSymetry:(int)symetry;
 - (void)_getBounceBack:(BOOL*)pBounceBack pStableDrag:(BOOL*)pStableDrag forSymetry:(int)symetry;
-- (void)_getAdjustedFrontViewPosition:(FrontViewPosition*)frontViewPosition forSymetry:(int)symetry;
+- (void)_getDragResistanceCurve:(SWRevealResistanceCurve*)curve;
+- (void)_getWidthProfile:(SWRevealWidthProfile*)profile forHorizontalSizeClass:(NSInteger)sizeClass;
+- (BOOL)_panGestureCanBegin;
+- (BOOL)_getDetentLocation:(CGFloat*)pLocation forPosition:(FrontViewPosition)position;
+- (void)_compilePanGestureZones;
+- (void)_applyTransformTracksForLocation:(CGFloat)xLocation;
 @end
 
 
 @implementation SWRevealView
 
 
-static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1, CGFloat max1)
+static CGRect CGRectFromRevealRect( SWRevealRect rect )
 {
-    CGFloat result = min2 + (v1-min1)*((max2-min2)/(max1-min1));
-    if ( result != result ) return min2;  // nan
-    if ( result < min2 ) return min2;
-    if ( result > max2 ) return max2;
-    return result;
+    return CGRectMake( rect.x, rect.y, rect.width, rect.height );
 }
 
 
@@ -95,14 +160,45 @@ static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1
         [self reloadShadow];
 
         [self addSubview:_frontView];
+        
+        // the status bar inset is part of the cached metrics
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(_statusBarFrameDidChange:)
+            name:UIApplicationDidChangeStatusBarFrameNotification object:nil];
     }
     return self;
 }
 
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationDidChangeStatusBarFrameNotification object:nil];
+    SWRevealZoneIndexFree( &_hitIndex );
+}
+
+
 - (void)reloadShadow
 {
     CALayer *frontViewLayer = _frontView.layer;
+    BOOL useImage = (_c.frontViewShadowStyle == SWRevealFrontViewShadowStyleImage);
+    
+    // the shadow path or the shadow image visibility are set on the next layout pass
+    if ( useImage != (_shadowImageView != nil) )
+    {
+        _layoutDirty |= SWRevealLayoutDirtyShadowPath;
+        [self setNeedsLayout];
+    }
+    
+    if ( useImage )
+    {
+        frontViewLayer.shadowOpacity = 0.0f;
+        frontViewLayer.shadowPath = NULL;
+        [self _reloadShadowImage];
+        return;
+    }
+    
+    [_shadowImageView removeFromSuperview];
+    _shadowImageView = nil;
+    
     frontViewLayer.shadowColor = [_c.frontViewShadowColor CGColor];
     frontViewLayer.shadowOpacity = _c.frontViewShadowOpacity;
     frontViewLayer.shadowOffset = _c.frontViewShadowOffset;
@@ -110,29 +206,187 @@ static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1
 }
 
 
-- (CGRect)hierarchycalFrameAdjustment:(CGRect)frame
+// Shadow images are shared by all reveal controllers, only used on the main thread
+static SWRevealShadowCache SWSharedShadowCache;
+
+
+static UIImage *SWResizableImageFromShadowImage( const SWRevealShadowImage *image )
+{
+    NSData *data = [NSData dataWithBytes:image->pixels length:image->width*image->height*4];
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData( (__bridge CFDataRef)data );
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGImageRef cgImage = CGImageCreate( image->width, image->height, 8, 32, image->width*4, colorSpace,
+        kCGBitmapByteOrderDefault|kCGImageAlphaPremultipliedLast, provider, NULL, false, kCGRenderingIntentDefault );
+    CGColorSpaceRelease( colorSpace );
+    CGDataProviderRelease( provider );
+    
+    CGFloat scale = image->config.scale;
+    UIImage *uiImage = [UIImage imageWithCGImage:cgImage scale:scale orientation:UIImageOrientationUp];
+    CGImageRelease( cgImage );
+    
+    CGFloat cap = image->capInset/scale;
+    return [uiImage resizableImageWithCapInsets:UIEdgeInsetsMake(cap, cap, cap, cap) resizingMode:UIImageResizingModeStretch];
+}
+
+
+- (void)_reloadShadowImage
+{
+    CGFloat red, green, blue, alpha;
+    SWGetColorComponents( _c.frontViewShadowColor, &red, &green, &blue, &alpha );
+    
+    UIScreen *screen = self.window ? self.window.screen : [UIScreen mainScreen];
+    
+    SWRevealShadowConfig config;
+    config.radius = _c.frontViewShadowRadius;
+    config.red = red, config.green = green, config.blue = blue, config.alpha = alpha;
+    config.opacity = _c.frontViewShadowOpacity;
+    config.scale = screen.scale;
+    
+    const SWRevealShadowImage *image = SWRevealShadowCacheGetImage( &SWSharedShadowCache, &config );
+    if ( image == NULL )
+        return;
+    
+    if ( _shadowImageView == nil )
+    {
+        // placed behind the front controller view, and sized along with the front view
+        _shadowImageView = [[UIImageView alloc] init];
+        _shadowImageView.userInteractionEnabled = NO;
+        _shadowImageView.autoresizingMask = UIViewAutoresizingFlexibleWidth|UIViewAutoresizingFlexibleHeight;
+        [_frontView insertSubview:_shadowImageView atIndex:0];
+    }
+    
+    CGFloat padding = image->padding/config.scale;
+    CGSize offset = _c.frontViewShadowOffset;
+    _shadowImageView.image = SWResizableImageFromShadowImage( image );
+    _shadowImageView.frame = CGRectOffset( CGRectInset(_frontView.bounds, -padding, -padding), offset.width, offset.height );
+}
+
+
+- (CGFloat)hierarchycalFrontOffset
 {
+    CGFloat offset = 0.0f;
     if ( _c.presentFrontViewHierarchically )
     {
-        UINavigationBar *dummyBar = [[UINavigationBar alloc] init];
-        CGFloat barHeight = [dummyBar sizeThatFits:CGSizeMake(100,100)].height;
-        CGFloat offset = barHeight + statusBarAdjustment(self);
-        frame.origin.y += offset;
-        frame.size.height -= offset;
+        const SWRevealMetrics *metrics = [self metrics];
+        if ( !_barMetricsValid )
+        {
+            UINavigationBar *dummyBar = [[UINavigationBar alloc] init];
+            _metrics.barHeight = [dummyBar sizeThatFits:CGSizeMake(100,100)].height;
+            _barMetricsValid = YES;
+        }
+        offset = metrics->barHeight + metrics->statusBarInset;
     }
-    return frame;
+    return offset;
 }
 
 
-- (void)prepareRearViewForPosition:(FrontViewPosition)newPosition
+// Returns the cached layout metrics, they are resolved again only after a bounds or traits change, or after the
+// controller invalidated them because a reveal width related property changed
+- (const SWRevealMetrics*)metrics
 {
-    if ( _rearView == nil )
+    CGSize size = self.bounds.size;
+    if ( !_metricsValid || _metrics.boundsWidth != size.width || _metrics.boundsHeight != size.height )
+    {
+        SWRevealWidthProfile profile;
+        [_c _getWidthProfile:&profile forHorizontalSizeClass:[self _horizontalSizeClass]];
+        SWRevealMetricsResolveWidths( &_metrics, &profile, size.width, size.height );
+        _metrics.statusBarInset = statusBarAdjustment(self);
+        _barMetricsValid = NO;
+        _metricsValid = YES;
+        
+        // things depending on metrics must be computed again
+        _dragResistanceValid = NO;
+        _layoutDirty |= SWRevealLayoutDirtyFrontOffset;
+    }
+    return &_metrics;
+}
+
+
+- (void)invalidateMetrics
+{
+    _metricsValid = NO;
+}
+
+
+// Fills the passed in geometry config with the current metrics and controller properties. The front view offset
+// is left to zero, callers laying out the front view must set it from hierarchycalFrontOffset
+- (void)getGeometryConfig:(SWRevealGeometryConfig*)config
+{
+    const SWRevealMetrics *metrics = [self metrics];
+    config->boundsWidth = metrics->boundsWidth;
+    config->boundsHeight = metrics->boundsHeight;
+    config->rearRevealWidth = metrics->rearRevealWidth;
+    config->rearRevealOverdraw = metrics->rearRevealOverdraw;
+    config->rearRevealDisplacement = _c.rearViewRevealDisplacement;
+    config->rightRevealWidth = metrics->rightRevealWidth;
+    config->rightRevealOverdraw = metrics->rightRevealOverdraw;
+    config->rightRevealDisplacement = _c.rightViewRevealDisplacement;
+    config->frontOffsetY = 0.0;
+}
+
+
+// Creates the rear container, unless a closed one is retained
+- (void)loadRearView
+{
+    if ( _rearView == nil && _retainedRearView == nil )
     {
         _rearView = [[UIView alloc] initWithFrame:self.bounds];
         _rearView.autoresizingMask = /*UIViewAutoresizingFlexibleWidth|*/UIViewAutoresizingFlexibleHeight;
         [self insertSubview:_rearView belowSubview:_frontView];
+        _hitIndexValid = NO;
+    }
+}
+
+
+- (void)loadRightView
+{
+    if ( _rightView == nil && _retainedRightView == nil )
+    {
+        _rightView = [[UIView alloc] initWithFrame:self.bounds];
+        _rightView.autoresizingMask = /*UIViewAutoresizingFlexibleWidth|*/UIViewAutoresizingFlexibleHeight;
+        [self insertSubview:_rightView belowSubview:_frontView];
+        _hitIndexValid = NO;
+    }
+}
+
+
+// Takes a closed rear container out of the view hierarchy along with its controller view, which gets the usual
+// appearance calls, so that both are put back as they are on the next open
+- (void)retainRearView
+{
+    if ( _rearView == nil )
+        return;
+    
+    [_rearView removeFromSuperview];
+    _retainedRearView = _rearView;
+    _rearView = nil;
+    _hitIndexValid = NO;
+}
+
+
+- (void)retainRightView
+{
+    if ( _rightView == nil )
+        return;
+    
+    [_rightView removeFromSuperview];
+    _retainedRightView = _rightView;
+    _rightView = nil;
+    _hitIndexValid = NO;
+}
+
+
+- (void)prepareRearViewForPosition:(FrontViewPosition)newPosition
+{
+    if ( _retainedRearView )
+    {
+        _rearView = _retainedRearView;
+        _retainedRearView = nil;
+        [self insertSubview:_rearView belowSubview:_frontView];
     }
     
+    [self loadRearView];
+    
     CGFloat xLocation = [self frontLocationForPosition:_c.frontViewPosition];
     [self _layoutRearViewsForLocation:xLocation];
     [self _prepareForNewPosition:newPosition];
@@ -141,13 +395,15 @@ static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1
 
 - (void)prepareRightViewForPosition:(FrontViewPosition)newPosition
 {
-    if ( _rightView == nil )
+    if ( _retainedRightView )
     {
-        _rightView = [[UIView alloc] initWithFrame:self.bounds];
-        _rightView.autoresizingMask = /*UIViewAutoresizingFlexibleWidth|*/UIViewAutoresizingFlexibleHeight;
+        _rightView = _retainedRightView;
+        _retainedRightView = nil;
         [self insertSubview:_rightView belowSubview:_frontView];
     }
     
+    [self loadRightView];
+    
     CGFloat xLocation = [self frontLocationForPosition:_c.frontViewPosition];
     [self _layoutRearViewsForLocation:xLocation];
     [self _prepareForNewPosition:newPosition];
@@ -156,104 +412,187 @@ static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1
 
 - (void)unloadRearView
 {
+    [_retainedRearView.subviews makeObjectsPerformSelector:@selector(removeFromSuperview)];
+    _retainedRearView = nil;
     [_rearView removeFromSuperview];
     _rearView = nil;
+    _hitIndexValid = NO;
 }
 
 
 - (void)unloadRightView
 {
+    [_retainedRightView.subviews makeObjectsPerformSelector:@selector(removeFromSuperview)];
+    _retainedRightView = nil;
     [_rightView removeFromSuperview];
     _rightView = nil;
+    _hitIndexValid = NO;
 }
 
 
 - (CGFloat)frontLocationForPosition:(FrontViewPosition)frontViewPosition
 {
-    CGFloat revealWidth;
-    CGFloat revealOverdraw;
-    
-    CGFloat location = 0.0f;
-    
-    int symetry = frontViewPosition<FrontViewPositionLeft? -1 : 1;
-    [_c _getRevealWidth:&revealWidth revealOverDraw:&revealOverdraw forSymetry:symetry];
-    [_c _getAdjustedFrontViewPosition:&frontViewPosition forSymetry:symetry];
-    
-    if ( frontViewPosition == FrontViewPositionRight )
-        location = revealWidth;
+    // the front view may rest at a custom detent instead
+    CGFloat location;
+    if ( [_c _getDetentLocation:&location forPosition:frontViewPosition] )
+        return location;
+    
+    SWRevealGeometryConfig config;
+    [self getGeometryConfig:&config];
+    return SWRevealFrontLocationForPosition( &config, (SWRevealPosition)frontViewPosition );
+}
+
+
+- (void)dragFrontViewToXLocation:(CGFloat)xLocation
+{
+    xLocation = [self _adjustedDragLocationForLocation:xLocation];
+    [self placeFrontViewAtXLocation:xLocation];
+}
+
+
+- (void)placeFrontViewAtXLocation:(CGFloat)xLocation
+{
+    [self _layoutViewsForLocation:xLocation];
+    _placedLocation = xLocation;
     
-    else if ( frontViewPosition > FrontViewPositionRight )
-        location = revealWidth + revealOverdraw;
+    // views are no longer at the location of the last layout pass
+    [self invalidateLocation];
+}
 
-    return location*symetry;
+
+- (void)invalidateLocation
+{
+    _layoutDirty |= SWRevealLayoutDirtyLocation;
 }
 
 
-- (void)dragFrontViewToXLocation:(CGFloat)xLocation
+// Rear and right containers loaded outside of a layout pass get their frames on the next one
+- (void)invalidateRearFrames
+{
+    _layoutDirty |= SWRevealLayoutDirtyRearFrames;
+    [self setNeedsLayout];
+}
+
+
+- (BOOL)hasLayout
+{
+    return _layoutStateValid;
+}
+
+
+// Removes running animations from the front, rear and right views and returns the x location the front view was
+// displayed at. Callers must place the views at the returned location, as their frames are still the animation targets
+- (CGFloat)stopAnimations
 {
-    CGRect bounds = self.bounds;
+    CALayer *presentationLayer = _frontView.layer.presentationLayer;
+    CGFloat xLocation = presentationLayer ? presentationLayer.frame.origin.x : _frontView.frame.origin.x;
     
-    xLocation = [self _adjustedDragLocationForLocation:xLocation];
-    [self _layoutRearViewsForLocation:xLocation];
+    [_frontView.layer removeAllAnimations];
+    [_rearView.layer removeAllAnimations];
+    [_rightView.layer removeAllAnimations];
     
-    CGRect frame = CGRectMake(xLocation, 0.0f, bounds.size.width, bounds.size.height);
-    _frontView.frame = [self hierarchycalFrameAdjustment:frame];
+    return xLocation;
 }
 
 
 # pragma mark - overrides
 
+- (void)traitCollectionDidChange:(UITraitCollection *)previousTraitCollection
+{
+    // this is only called on iOS8 and later, size class profiles and the status bar inset may change
+    [super traitCollectionDidChange:previousTraitCollection];
+    [self invalidateMetrics];
+    [self setNeedsLayout];
+}
+
+
+- (void)_statusBarFrameDidChange:(NSNotification *)notification
+{
+    [self invalidateMetrics];
+    [self setNeedsLayout];
+}
+
+
+- (void)didMoveToWindow
+{
+    // the status bar inset depends on our location on the window
+    [super didMoveToWindow];
+    [self invalidateMetrics];
+    
+    // the shadow image depends on the screen scale
+    if ( _shadowImageView && self.window )
+        [self _reloadShadowImage];
+}
+
+
 - (void)layoutSubviews
 {
     if ( _disableLayout ) return;
 
-    CGRect bounds = self.bounds;
+    // take a snapshot of the layout inputs and find out which parts of the layout must be recomputed
+    SWRevealLayoutState state;
+    [self _getLayoutState:&state];
     
-    FrontViewPosition position = _c.frontViewPosition;
-    CGFloat xLocation = [self frontLocationForPosition:position];
+    SWRevealLayoutDirtyFlags dirty = _layoutStateValid ? SWRevealLayoutStateDiff(&_layoutState, &state) : SWRevealLayoutDirtyAll;
+    dirty = SWRevealLayoutDirtyClosure( dirty | _layoutDirty );
+    BOOL sizeChanged = !_layoutStateValid || _layoutState.boundsWidth != state.boundsWidth || _layoutState.boundsHeight != state.boundsHeight;
     
-    // set rear view frames
-    [self _layoutRearViewsForLocation:xLocation];
+    _layoutState = state;
+    _layoutStateValid = YES;
+    _layoutDirty = SWRevealLayoutDirtyNone;
     
-    // set front view frame
-    CGRect frame = CGRectMake(xLocation, 0.0f, bounds.size.width, bounds.size.height);
-    _frontView.frame = [self hierarchycalFrameAdjustment:frame];
+    // while an animation places the front view on each frame, layout passes keep it where it was last placed
+    if ( dirty & SWRevealLayoutDirtyLocation )
+        _layoutLocation = _drivesLocation ? _placedLocation : [self frontLocationForPosition:(FrontViewPosition)state.position];
     
-    // setup front view shadow path if needed (front view loaded and not removed)
-    UIViewController *frontViewController = _c.frontViewController;
-    BOOL viewLoaded = frontViewController != nil && frontViewController.isViewLoaded;
-    BOOL viewNotRemoved = position > FrontViewPositionLeftSideMostRemoved && position < FrontViewPositionRightMostRemoved;
-    CGRect shadowBounds = viewLoaded && viewNotRemoved  ? _frontView.bounds : CGRectZero;
+    if ( dirty & SWRevealLayoutDirtyFrontOffset )
+        _layoutFrontOffset = [self hierarchycalFrontOffset];
     
-    UIBezierPath *shadowPath = [UIBezierPath bezierPathWithRect:shadowBounds];
-    _frontView.layer.shadowPath = shadowPath.CGPath;
-}
-
-
-- (BOOL)pointInsideD:(CGPoint)point withEvent:(UIEvent *)event
-{
-    BOOL isInside = [super pointInside:point withEvent:event];
-    if ( _c.extendsPointInsideHit )
+    // set rear and front view frames
+    if ( dirty & (SWRevealLayoutDirtyRearFrames|SWRevealLayoutDirtyFrontFrame) )
     {
-        if ( !isInside  && _rearView && [_c.rearViewController isViewLoaded] )
+        SWRevealGeometryConfig config;
+        [self getGeometryConfig:&config];
+        config.frontOffsetY = _layoutFrontOffset;
+        
+        SWRevealLayoutFrames frames;
+        SWRevealGetLayoutFrames( &config, _layoutLocation, &frames );
+        
+        if ( dirty & SWRevealLayoutDirtyRearFrames )
         {
-            CGPoint pt = [self convertPoint:point toView:_rearView];
-            isInside = [_rearView pointInside:pt withEvent:event];
+            _rearView.frame = CGRectFromRevealRect( frames.rear );
+            _rightView.frame = CGRectFromRevealRect( frames.right );
         }
         
-        if ( !isInside && _frontView && [_c.frontViewController isViewLoaded] )
+        if ( dirty & SWRevealLayoutDirtyFrontFrame )
+            _frontView.frame = CGRectFromRevealRect( frames.front );
+        
+        // the hit index is rebuilt on the next hit test
+        _hitIndexValid = NO;
+    }
+    
+    // pan gesture zones only depend on our size
+    if ( sizeChanged )
+        [_c _compilePanGestureZones];
+    
+    // child controller views may have been replaced since the last pass, so transform tracks are always applied
+    [_c _applyTransformTracksForLocation:_layoutLocation];
+    
+    // setup front view shadow path if needed (front view loaded and not removed), we only
+    // need to do so when the front view size or visibility changed
+    if ( dirty & SWRevealLayoutDirtyShadowPath )
+    {
+        if ( _shadowImageView )
         {
-            CGPoint pt = [self convertPoint:point toView:_frontView];
-            isInside = [_frontView pointInside:pt withEvent:event];
+            _shadowImageView.hidden = !state.frontShadowVisible;
         }
-        
-        if ( !isInside && _rightView && [_c.rightViewController isViewLoaded] )
+        else
         {
-            CGPoint pt = [self convertPoint:point toView:_rightView];
-            isInside = [_rightView pointInside:pt withEvent:event];
+            CGRect shadowBounds = state.frontShadowVisible ? _frontView.bounds : CGRectZero;
+            UIBezierPath *shadowPath = [UIBezierPath bezierPathWithRect:shadowBounds];
+            _frontView.layer.shadowPath = shadowPath.CGPath;
         }
     }
-    return isInside;
 }
 
 
@@ -262,44 +601,128 @@ static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1
     BOOL isInside = [super pointInside:point withEvent:event];
     if ( !isInside && _c.extendsPointInsideHit )
     {
-        UIView *testViews[] = { _rearView, _frontView, _rightView };
+        // the frames of the rear, front and right views are indexed at rest, bit i of the mask is set for view i. While the
+        // front view is dragged or animated frame by frame the frames are tested directly rather than indexed on every frame
+        unsigned int mask;
+        if ( _layoutDirty & SWRevealLayoutDirtyLocation )
+        {
+            mask = [self _hitMaskForPoint:point];
+        }
+        else
+        {
+            if ( !_hitIndexValid )
+                [self _buildHitIndex];
+            
+            mask = SWRevealZoneIndexLookup( &_hitIndex, point.x, point.y );
+        }
+        
         UIViewController *testControllers[] = { _c.rearViewController, _c.frontViewController, _c.rightViewController };
         
         for ( NSInteger i=0 ; i<3 && !isInside ; i++ )
-        {
-            if ( testViews[i] && [testControllers[i] isViewLoaded] )
-            {
-                CGPoint pt = [self convertPoint:point toView:testViews[i]];
-                isInside = [testViews[i] pointInside:pt withEvent:event];
-            }
-        }
+            isInside = (mask & (1u << i)) && [testControllers[i] isViewLoaded];
     }
     return isInside;
 }
 
 
+- (unsigned int)_hitMaskForPoint:(CGPoint)point
+{
+    UIView *testViews[] = { _rearView, _frontView, _rightView };
+    unsigned int mask = 0;
+    
+    for ( NSInteger i=0 ; i<3 ; i++ )
+    {
+        if ( testViews[i] != nil && CGRectContainsPoint( testViews[i].frame, point ) )
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
+
+- (void)_buildHitIndex
+{
+    UIView *testViews[] = { _rearView, _frontView, _rightView };
+    SWRevealIndexedRect rects[3];
+    unsigned int count = 0;
+    
+    for ( NSInteger i=0 ; i<3 ; i++ )
+    {
+        if ( testViews[i] == nil ) continue;
+        CGRect frame = testViews[i].frame;
+        rects[count].rect = (SWRevealRect){ frame.origin.x, frame.origin.y, frame.size.width, frame.size.height };
+        rects[count].mask = 1u << i;
+        count += 1;
+    }
+    
+    SWRevealZoneIndexBuild( &_hitIndex, rects, count );
+    _hitIndexValid = YES;
+}
+
+
 # pragma mark - private
 
 
-- (void)_layoutRearViewsForLocation:(CGFloat)xLocation
+- (NSInteger)_horizontalSizeClass
+{
+    // traitCollection is only available on iOS8 and later
+    if ( [self respondsToSelector:@selector(traitCollection)] )
+        return self.traitCollection.horizontalSizeClass;
+    
+    return 0;  // UIUserInterfaceSizeClassUnspecified
+}
+
+
+- (void)_getLayoutState:(SWRevealLayoutState*)state
 {
-    CGRect bounds = self.bounds;
+    const SWRevealMetrics *metrics = [self metrics];
+    FrontViewPosition position = _c.frontViewPosition;
     
-    CGFloat rearRevealWidth = _c.rearViewRevealWidth;
-    if ( rearRevealWidth < 0) rearRevealWidth = bounds.size.width + _c.rearViewRevealWidth;
+    UIViewController *frontViewController = _c.frontViewController;
+    BOOL viewLoaded = frontViewController != nil && frontViewController.isViewLoaded;
+    BOOL viewNotRemoved = position > FrontViewPositionLeftSideMostRemoved && position < FrontViewPositionRightMostRemoved;
+    
+    state->boundsWidth = metrics->boundsWidth;
+    state->boundsHeight = metrics->boundsHeight;
+    state->position = (SWRevealPosition)position;
+    state->rearRevealWidth = metrics->rearRevealWidth;
+    state->rearRevealOverdraw = metrics->rearRevealOverdraw;
+    state->rearRevealDisplacement = _c.rearViewRevealDisplacement;
+    state->rightRevealWidth = metrics->rightRevealWidth;
+    state->rightRevealOverdraw = metrics->rightRevealOverdraw;
+    state->rightRevealDisplacement = _c.rightViewRevealDisplacement;
+    state->presentFrontViewHierarchically = _c.presentFrontViewHierarchically;
+    state->frontShadowVisible = viewLoaded && viewNotRemoved;
+}
+
+
+- (void)_layoutRearViewsForLocation:(CGFloat)xLocation
+{
+    SWRevealGeometryConfig config;
+    [self getGeometryConfig:&config];
     
-    CGFloat rearXLocation = scaledValue(xLocation, -_c.rearViewRevealDisplacement, 0, 0, rearRevealWidth);
+    SWRevealLayoutFrames frames;
+    SWRevealGetLayoutFrames( &config, xLocation, &frames );
     
-    CGFloat rearWidth = rearRevealWidth + _c.rearViewRevealOverdraw;
-    _rearView.frame = CGRectMake(rearXLocation, 0.0, rearWidth, bounds.size.height);
+    _rearView.frame = CGRectFromRevealRect( frames.rear );
+    _rightView.frame = CGRectFromRevealRect( frames.right );
+    _hitIndexValid = NO;
+}
+
+
+- (void)_layoutViewsForLocation:(CGFloat)xLocation
+{
+    SWRevealGeometryConfig config;
+    [self getGeometryConfig:&config];
+    config.frontOffsetY = [self hierarchycalFrontOffset];
     
-    CGFloat rightRevealWidth = _c.rightViewRevealWidth;
-    if ( rightRevealWidth < 0) rightRevealWidth = bounds.size.width + _c.rightViewRevealWidth;
+    SWRevealLayoutFrames frames;
+    SWRevealGetLayoutFrames( &config, xLocation, &frames );
     
-    CGFloat rightXLocation = scaledValue(xLocation, 0, _c.rightViewRevealDisplacement, -rightRevealWidth, 0);
+    _rearView.frame = CGRectFromRevealRect( frames.rear );
+    _rightView.frame = CGRectFromRevealRect( frames.right );
+    _frontView.frame = CGRectFromRevealRect( frames.front );
     
-    CGFloat rightWidth = rightRevealWidth + _c.rightViewRevealOverdraw;
-    _rightView.frame = CGRectMake(bounds.size.width-rightWidth+rightXLocation, 0.0f, rightWidth, bounds.size.height);
+    [_c _applyTransformTracksForLocation:xLocation];
 }
 
 
@@ -321,38 +744,56 @@ static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1
 
 - (CGFloat)_adjustedDragLocationForLocation:(CGFloat)x
 {
-    CGFloat result;
-    
-    CGFloat revealWidth;
-    CGFloat revealOverdraw;
-    BOOL bounceBack;
-    BOOL stableDrag;
     FrontViewPosition position = _c.frontViewPosition;
     
-    int symetry = x<0 ? -1 : 1;
-    
-    [_c _getRevealWidth:&revealWidth revealOverDraw:&revealOverdraw forSymetry:symetry];
-    [_c _getBounceBack:&bounceBack pStableDrag:&stableDrag forSymetry:symetry];
-    
-    BOOL stableTrack = !bounceBack || stableDrag || position==FrontViewPositionRightMost || position==FrontViewPositionLeftSideMost;
-    if ( stableTrack )
-    {
-        revealWidth += revealOverdraw;
-        revealOverdraw = 0.0f;
-    }
+    // dragging from the most positions is always tracked linearly up to the most location
+    BOOL stableTrack = position==FrontViewPositionRightMost || position==FrontViewPositionLeftSideMost;
     
-    x = x * symetry;
-    
-    if (x <= revealWidth)
-        result = x;         // Translate linearly.
+    SWRevealDrawerConfig drawer;
+    [self getDrawerConfig:&drawer];
+    return SWRevealDrawerDragLocation( &drawer, x, stableTrack );
+}
 
-    else if (x <= revealWidth+2*revealOverdraw)
-        result = revealWidth + (x-revealWidth)/2;   // slow down translation by halph the movement.
 
-    else
-        result = revealWidth+revealOverdraw;        // keep at the rightMost location.
+// Fills the drawer configuration for the sides in use, baking the drag resistance tables first if they were invalidated
+- (void)getDrawerConfig:(SWRevealDrawerConfig*)config
+{
+    [self metrics];  // <-- revalidates metrics, which invalidates the tables if needed
+    if ( !_dragResistanceValid )
+    {
+        SWRevealResistanceCurve curve;
+        [_c _getDragResistanceCurve:&curve];
+        
+        for ( int i=0 ; i<2 ; i++ )
+        {
+            CGFloat revealWidth, revealOverdraw;
+            BOOL bounceBack, stableDrag;
+            int tableSymetry = i==0 ? -1 : 1;
+            
+            [_c _getRevealWidth:&revealWidth revealOverDraw:&revealOverdraw forSymetry:tableSymetry];
+            [_c _getBounceBack:&bounceBack pStableDrag:&stableDrag forSymetry:tableSymetry];
+            SWRevealResistanceTableBake( &_dragResistanceTables[i], &curve, revealWidth, revealOverdraw, !bounceBack || stableDrag );
+            
+            SWRevealOverdrawPolicy policy = SWRevealOverdrawFree;
+            if ( bounceBack ) policy |= SWRevealOverdrawBounceBack;
+            if ( stableDrag ) policy |= SWRevealOverdrawStableDrag;
+            if ( i == 0 ) _drawerConfig.rightPolicy = policy;
+            else _drawerConfig.rearPolicy = policy;
+            
+            _drawerConfig.revealWidth[i] = revealWidth;
+            _drawerConfig.revealOverdraw[i] = revealOverdraw;
+            _drawerConfig.resistanceTables[i] = &_dragResistanceTables[i];
+        }
+        
+        _drawerConfig.decelerationRate = SWRevealFlingDefaultDecelerationRate;
+        _dragResistanceValid = YES;
+    }
     
-    return result * symetry;
+    *config = _drawerConfig;
+    config->sides = SWRevealDrawerSidesNone;
+    if ( _c.rearViewController ) config->sides |= SWRevealDrawerSidesRear;
+    if ( _c.rightViewController ) config->sides |= SWRevealDrawerSidesRight;
+    config->quickFlickVelocity = _c.quickFlickVelocity;
 }
 
 @end
@@ -538,371 +979,1495 @@ static CGFloat scaledValue( CGFloat v1, CGFloat min2, CGFloat max2, CGFloat min1
 @end
 
 
-#pragma mark - SWRevealViewControllerPanGestureRecognizer
-
-#import <UIKit/UIGestureRecognizerSubclass.h>
+#pragma mark - SWRevealIdleScheduler Class
 
-@interface SWRevealViewControllerPanGestureRecognizer : UIPanGestureRecognizer
+// Runs tasks on the main run loop when it is about to wait for events, as many as fit in the time budget on each pass.
+// A task that was started is always completed, so tasks should be small
+@interface SWRevealIdleScheduler : NSObject
+- (id)initWithTimeBudget:(NSTimeInterval)budget;
+- (void)addTask:(void (^)(void))task;
+- (void)cancel;
 @end
 
-@implementation SWRevealViewControllerPanGestureRecognizer
+
+@implementation SWRevealIdleScheduler
 {
-    BOOL _dragging;
-    CGPoint _beginPoint;
+    NSMutableArray *_tasks;
+    NSTimeInterval _budget;
+    CFRunLoopObserverRef _observer;
 }
 
-- (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event
+
+- (id)initWithTimeBudget:(NSTimeInterval)budget
 {
-    [super touchesBegan:touches withEvent:event];
-   
-    UITouch *touch = [touches anyObject];
-    _beginPoint = [touch locationInView:self.view];
-    _dragging = NO;
+    self = [super init];
+    if ( self )
+    {
+        _budget = budget;
+        _tasks = [NSMutableArray array];
+    }
+    return self;
 }
 
 
-- (void)touchesMoved:(NSSet *)touches withEvent:(UIEvent *)event
+- (void)dealloc
 {
-    [super touchesMoved:touches withEvent:event];
-    
-    if ( _dragging || self.state == UIGestureRecognizerStateFailed)
-        return;
-    
-    const CGFloat kDirectionPanThreshold = 5;
-    
-    UITouch *touch = [touches anyObject];
-    CGPoint nowPoint = [touch locationInView:self.view];
-    
-    if (ABS(nowPoint.x - _beginPoint.x) > kDirectionPanThreshold) _dragging = YES;
-    else if (ABS(nowPoint.y - _beginPoint.y) > kDirectionPanThreshold) self.state = UIGestureRecognizerStateFailed;
+    [self cancel];
 }
 
-@end
-
-
-#pragma mark - SWRevealViewController Class
 
-@interface SWRevealViewController()<UIGestureRecognizerDelegate>
+- (void)addTask:(void (^)(void))task
 {
-    SWRevealView *_contentView;
-    UIPanGestureRecognizer *_panGestureRecognizer;
-    UITapGestureRecognizer *_tapGestureRecognizer;
-    FrontViewPosition _frontViewPosition;
-    FrontViewPosition _rearViewPosition;
-    FrontViewPosition _rightViewPosition;
-    SWContextTransitionObject *_rearTransitioningController;
-    SWContextTransitionObject *_frontTransitioningController;
-    SWContextTransitionObject *_rightTransitioningController;
+    [_tasks addObject:[task copy]];
+    
+    if ( _observer == NULL )
+    {
+        // only the default mode is considered idle, we stay away while the user is tracking
+        __weak SWRevealIdleScheduler *weakSelf = self;
+        _observer = CFRunLoopObserverCreateWithHandler( kCFAllocatorDefault, kCFRunLoopBeforeWaiting, true, 0,
+            ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) { [weakSelf _runSlice]; } );
+        CFRunLoopAddObserver( CFRunLoopGetMain(), _observer, kCFRunLoopDefaultMode );
+    }
 }
-@end
 
 
-@implementation SWRevealViewController
+- (void)_runSlice
 {
-    FrontViewPosition _panInitialFrontPosition;
-    NSMutableArray *_animationQueue;
-    BOOL _userInteractionStore;
+    CFTimeInterval deadline = CACurrentMediaTime() + _budget;
+    
+    while ( _tasks.count > 0 )
+    {
+        void (^task)(void) = [_tasks objectAtIndex:0];
+        [_tasks removeObjectAtIndex:0];
+        task();
+        
+        if ( CACurrentMediaTime() >= deadline )
+            break;
+    }
+    
+    // wake the run loop so that it processes pending events and comes back for the next slice
+    if ( _tasks.count > 0 ) CFRunLoopWakeUp( CFRunLoopGetMain() );
+    else [self cancel];
 }
 
-const int FrontViewPositionNone = 0xff;
-
 
-#pragma mark - Init
-
-- (id)initWithCoder:(NSCoder *)aDecoder
+- (void)cancel
 {
-    self = [super initWithCoder:aDecoder];
-    if ( self )
+    [_tasks removeAllObjects];
+    
+    if ( _observer != NULL )
     {
-        [self _initDefaultProperties];
-    }    
-    return self;
+        CFRunLoopObserverInvalidate( _observer );
+        CFRelease( _observer );
+        _observer = NULL;
+    }
 }
 
+@end
 
-- (id)init
+
+#pragma mark - SWRevealControllerCache Class
+
+// Keyed cache of view controllers with least recently used eviction. The cost of a controller is an estimate
+// of the backing store of its view if loaded, it is evaluated each time the limits are enforced as views may load later
+@interface SWRevealControllerCache : NSObject
+@property (nonatomic) NSUInteger countLimit;
+@property (nonatomic) NSUInteger costLimit;
+@property (nonatomic, readonly) NSUInteger hits;
+@property (nonatomic, readonly) NSUInteger misses;
+- (UIViewController *)controllerForKey:(id<NSCopying>)key;
+- (void)setController:(UIViewController *)controller forKey:(id<NSCopying>)key;
+- (void)removeControllerForKey:(id<NSCopying>)key;
+- (void)evictExceptController:(UIViewController *)inUse;
+- (void)evictExceptController:(UIViewController *)inUse keepingController:(UIViewController *)inserted;
+- (void)removeAllExceptController:(UIViewController *)inUse;
+@end
+
+
+@implementation SWRevealControllerCache
 {
-    return [self initWithRearViewController:nil frontViewController:nil];
+    NSMutableDictionary *_controllers;
+    NSMutableArray *_keys;   // <-- least recently used first, lookups and reordering are linear but the cache is meant to
+                             //     hold a handful of controllers (4 by default) so an array is cheaper than an ordered set
 }
 
 
-- (id)initWithRearViewController:(UIViewController *)rearViewController frontViewController:(UIViewController *)frontViewController;
+- (id)init
 {
     self = [super init];
     if ( self )
     {
-        [self _initDefaultProperties];
-        [self _performTransitionOperation:SWRevealControllerOperationReplaceRearController withViewController:rearViewController animated:NO];
-        [self _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:NO];
+        _controllers = [NSMutableDictionary dictionary];
+        _keys = [NSMutableArray array];
     }
     return self;
 }
 
 
-- (void)_initDefaultProperties
-{
-    _frontViewPosition = FrontViewPositionLeft;
-    _rearViewPosition = FrontViewPositionLeft;
-    _rightViewPosition = FrontViewPositionLeft;
-    _rearViewRevealWidth = 260.0f;
-    _rearViewRevealOverdraw = 60.0f;
-    _rearViewRevealDisplacement = 40.0f;
-    _rightViewRevealWidth = 260.0f;
-    _rightViewRevealOverdraw = 60.0f;
-    _rightViewRevealDisplacement = 40.0f;
-    _bounceBackOnOverdraw = YES;
-    _bounceBackOnLeftOverdraw = YES;
-    _stableDragOnOverdraw = NO;
-    _stableDragOnLeftOverdraw = NO;
-    _presentFrontViewHierarchically = NO;
-    _quickFlickVelocity = 250.0f;
-    _toggleAnimationDuration = 0.3;
-    _toggleAnimationType = SWRevealToggleAnimationTypeSpring;
-    _springDampingRatio = 1;
-    _replaceViewAnimationDuration = 0.25;
-    _frontViewShadowRadius = 2.5f;
-    _frontViewShadowOffset = CGSizeMake(0.0f, 2.5f);
-    _frontViewShadowOpacity = 1.0f;
-    _frontViewShadowColor = [UIColor blackColor];
-    _userInteractionStore = YES;
-    _animationQueue = [NSMutableArray array];
-    _draggableBorderWidth = 0.0f;
-    _clipsViewsToBounds = NO;
-    _extendsPointInsideHit = NO;
-}
-
-
-#pragma mark - StatusBar
-
-- (UIViewController *)childViewControllerForStatusBarStyle
+- (UIViewController *)controllerForKey:(id<NSCopying>)key
 {
-    int positionDif =  _frontViewPosition - FrontViewPositionLeft;
-    
-    UIViewController *controller = _frontViewController;
-    if ( positionDif > 0 ) controller = _rearViewController;
-    else if ( positionDif < 0 ) controller = _rightViewController;
+    UIViewController *controller = [_controllers objectForKey:key];
+    if ( controller == nil )
+    {
+        _misses += 1;
+        return nil;
+    }
     
+    _hits += 1;
+    [_keys removeObject:key];
+    [_keys addObject:key];
     return controller;
 }
 
-- (UIViewController *)childViewControllerForStatusBarHidden
-{
-    UIViewController *controller = [self childViewControllerForStatusBarStyle];
-    return controller;
-}
-
-
-#pragma mark - View lifecycle
 
-- (void)loadView
+- (void)setController:(UIViewController *)controller forKey:(id<NSCopying>)key
 {
-    // Do not call super, to prevent the apis from unfruitful looking for inexistent xibs!
-    //[super loadView];
-    
-    // load any defined front/rear controllers from the storyboard before
-    [self loadStoryboardControllers];
-    
-    // This is what Apple used to tell us to set as the initial frame, which is of course totally irrelevant
-    // with view controller containment patterns, let's leave it for the sake of it!
-    // CGRect frame = [[UIScreen mainScreen] applicationFrame];
-    
-    // On iOS7 the applicationFrame does not return the whole screen. This is possibly a bug.
-    // As a workaround we use the screen bounds, this still works on iOS6, any zero based frame would work anyway!
-    CGRect frame = [[UIScreen mainScreen] bounds];
-
-    // create a custom content view for the controller
-    _contentView = [[SWRevealView alloc] initWithFrame:frame controller:self];
-    
-    // set the content view to resize along with its superview
-    [_contentView setAutoresizingMask:UIViewAutoresizingFlexibleWidth|UIViewAutoresizingFlexibleHeight];
-    
-    // set the content view to clip its bounds if requested
-    [_contentView setClipsToBounds:_clipsViewsToBounds];
-
-    // set our contentView to the controllers view
-    self.view = _contentView;
-    
-    // Apple also tells us to do this:
-    _contentView.backgroundColor = [UIColor blackColor];
-    
-    // we set the current frontViewPosition to none before seting the
-    // desired initial position, this will force proper controller reload
-    FrontViewPosition initialPosition = _frontViewPosition;
-    _frontViewPosition = FrontViewPositionNone;
-    _rearViewPosition = FrontViewPositionNone;
-    _rightViewPosition = FrontViewPositionNone;
+    if ( controller == nil )
+    {
+        [self removeControllerForKey:key];
+        return;
+    }
     
-    // now set the desired initial position
-    [self _setFrontViewPosition:initialPosition withDuration:0.0];
+    [_keys removeObject:key];
+    [_keys addObject:key];
+    [_controllers setObject:controller forKey:key];
 }
 
 
-- (void)viewDidAppear:(BOOL)animated
+- (void)removeControllerForKey:(id<NSCopying>)key
 {
-    [super viewDidAppear:animated];
-
-    // Uncomment the following code if you want the child controllers
-    // to be loaded at this point.
-    //
-    // We leave this commented out because we think loading childs here is conceptually wrong.
-    // Instead, we refrain view loads until necesary, for example we may never load
-    // the rear controller view -or the front controller view- if it is never displayed.
-    //
-    // If you need to manipulate views of any of your child controllers in an override
-    // of this method, you can load yourself the views explicitly on your overriden method.
-    // However we discourage it as an app following the MVC principles should never need to do so
-        
-//  [_frontViewController view];
-//  [_rearViewController view];
-
-    // we store at this point the view's user interaction state as we may temporarily disable it
-    // and resume it back to the previous state, it is possible to override this behaviour by
-    // intercepting it on the panGestureBegan and panGestureEnded delegates
-    _userInteractionStore = _contentView.userInteractionEnabled;
+    [_keys removeObject:key];
+    [_controllers removeObjectForKey:key];
 }
 
 
-- (NSUInteger)supportedInterfaceOrientations
+- (NSUInteger)_costForController:(UIViewController *)controller
 {
-    // we could have simply not implemented this, but we choose to call super to make explicit that we
-    // want the default behavior.
-    return [super supportedInterfaceOrientations];
+    if ( ![controller isViewLoaded] )
+        return 0;
+    
+    UIView *view = controller.view;
+    CGFloat scale = view.contentScaleFactor;
+    return (NSUInteger)(view.bounds.size.width*scale * view.bounds.size.height*scale * 4);
 }
 
 
-#pragma mark - Public methods and property accessors
-
-- (void)setFrontViewController:(UIViewController *)frontViewController
+- (void)evictExceptController:(UIViewController *)inUse
 {
-    [self setFrontViewController:frontViewController animated:NO];
+    [self evictExceptController:inUse keepingController:nil];
 }
 
 
-- (void)setFrontViewController:(UIViewController *)frontViewController animated:(BOOL)animated
+// evicts least recently used controllers until the limits are met, 'inUse' and 'inserted' are never evicted
+- (void)evictExceptController:(UIViewController *)inUse keepingController:(UIViewController *)inserted
 {
-    if ( ![self isViewLoaded])
+    NSUInteger totalCost = 0;
+    if ( _costLimit > 0 )
     {
-        [self _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:NO];
-        return;
+        for ( UIViewController *controller in [_controllers objectEnumerator] )
+            totalCost += [self _costForController:controller];
     }
     
-    [self _dispatchTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:animated];
+    NSUInteger index = 0;
+    while ( index < _keys.count && ((_countLimit > 0 && _keys.count > _countLimit) || (_costLimit > 0 && totalCost > _costLimit)) )
+    {
+        id key = [_keys objectAtIndex:index];
+        UIViewController *controller = [_controllers objectForKey:key];
+        if ( controller == inUse || controller == inserted )
+        {
+            index += 1;
+            continue;
+        }
+        
+        totalCost -= MIN( totalCost, [self _costForController:controller] );
+        [self removeControllerForKey:key];
+    }
 }
 
 
-- (void)pushFrontViewController:(UIViewController *)frontViewController animated:(BOOL)animated
+- (void)removeAllExceptController:(UIViewController *)inUse
 {
-    if ( ![self isViewLoaded])
+    for ( id key in [_keys copy] )
     {
-        [self _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:NO];
-        return;
+        if ( [_controllers objectForKey:key] != inUse )
+            [self removeControllerForKey:key];
     }
-    
-    [self _dispatchPushFrontViewController:frontViewController animated:animated];
 }
 
+@end
+
 
-- (void)setRearViewController:(UIViewController *)rearViewController
+#pragma mark - SWRevealTransaction Class
+
+// Changes collected by performBatchUpdates:animated:, at most one controller per operation and one position
+@interface SWRevealTransaction : NSObject
+@property (nonatomic) BOOL animated;
+@property (nonatomic) FrontViewPosition position;
+@property (nonatomic) BOOL hasPosition;
+@property (nonatomic, readonly) NSArray *operations;    // <-- replacement operations in rear, front, right order
+- (void)setViewController:(UIViewController *)controller forOperation:(SWRevealControllerOperation)operation;
+- (UIViewController *)viewControllerForOperation:(SWRevealControllerOperation)operation;
+- (BOOL)isEmpty;
+@end
+
+
+@implementation SWRevealTransaction
 {
-    [self setRearViewController:rearViewController animated:NO];
+    NSMutableDictionary *_controllers;
 }
 
-
-- (void)setRearViewController:(UIViewController *)rearViewController animated:(BOOL)animated
+- (id)init
 {
-    if ( ![self isViewLoaded])
+    self = [super init];
+    if ( self )
     {
-        [self _performTransitionOperation:SWRevealControllerOperationReplaceRearController withViewController:rearViewController animated:NO];
-        return;
+        _controllers = [NSMutableDictionary dictionary];
     }
-
-    [self _dispatchTransitionOperation:SWRevealControllerOperationReplaceRearController withViewController:rearViewController animated:animated];
+    return self;
 }
 
 
-- (void)setRightViewController:(UIViewController *)rightViewController
+- (void)setPosition:(FrontViewPosition)position
 {
-    [self setRightViewController:rightViewController animated:NO];
+    _position = position;
+    _hasPosition = YES;
 }
 
 
-- (void)setRightViewController:(UIViewController *)rightViewController animated:(BOOL)animated
+- (void)setViewController:(UIViewController *)controller forOperation:(SWRevealControllerOperation)operation
 {
-    if ( ![self isViewLoaded])
-    {
-        [self _performTransitionOperation:SWRevealControllerOperationReplaceRightController withViewController:rightViewController animated:NO];
-        return;
-    }
-
-    [self _dispatchTransitionOperation:SWRevealControllerOperationReplaceRightController withViewController:rightViewController animated:animated];
+    [_controllers setObject:(controller ?: [NSNull null]) forKey:@(operation)];
 }
 
 
-- (void)revealToggleAnimated:(BOOL)animated
+- (UIViewController *)viewControllerForOperation:(SWRevealControllerOperation)operation
 {
-    FrontViewPosition toggledFrontViewPosition = FrontViewPositionLeft;
-    if (_frontViewPosition <= FrontViewPositionLeft)
-        toggledFrontViewPosition = FrontViewPositionRight;
-    
-    [self setFrontViewPosition:toggledFrontViewPosition animated:animated];
+    id controller = [_controllers objectForKey:@(operation)];
+    return controller == [NSNull null] ? nil : controller;
 }
 
 
-- (void)rightRevealToggleAnimated:(BOOL)animated
+- (NSArray *)operations
 {
-    FrontViewPosition toggledFrontViewPosition = FrontViewPositionLeft;
-    if (_frontViewPosition >= FrontViewPositionLeft)
-        toggledFrontViewPosition = FrontViewPositionLeftSide;
-    
-    [self setFrontViewPosition:toggledFrontViewPosition animated:animated];
+    return [[_controllers allKeys] sortedArrayUsingSelector:@selector(compare:)];
 }
 
 
-- (void)setFrontViewPosition:(FrontViewPosition)frontViewPosition
+- (BOOL)isEmpty
 {
-    [self setFrontViewPosition:frontViewPosition animated:NO];
+    return _controllers.count == 0 && !_hasPosition;
 }
 
+@end
 
-- (void)setFrontViewPosition:(FrontViewPosition)frontViewPosition animated:(BOOL)animated
-{
-    if ( ![self isViewLoaded] )
-    {
-        _frontViewPosition = frontViewPosition;
-        _rearViewPosition = frontViewPosition;
-        _rightViewPosition = frontViewPosition;
-        return;
-    }
-    
-    [self _dispatchSetFrontViewPosition:frontViewPosition animated:animated];
-}
 
+#pragma mark - SWRevealAnimationDriver Class
 
-- (void)setFrontViewShadowRadius:(CGFloat)frontViewShadowRadius
+// Moves the front view along a timing curve from a display link, instead of handing the animation to Core Animation.
+// The curve is sampled ahead at the display refresh rate, and each frame gets the location for the time it will be displayed
+@interface SWRevealAnimationDriver : NSObject
+- (id)initWithCurve:(const SWRevealCurve *)curve fromLocation:(CGFloat)fromLocation toLocation:(CGFloat)toLocation;
+- (void)runWithFrameHandler:(void (^)(CGFloat xLocation))frameHandler completion:(void (^)(void))completion;
+- (void)stop;
+@end
+
+
+@implementation SWRevealAnimationDriver
 {
-    _frontViewShadowRadius = frontViewShadowRadius;
-    [_contentView reloadShadow];
+    CADisplayLink *_link;
+    SWRevealCurve _curve;
+    double *_samples;
+    int _sampleCount;
+    NSInteger _framesPerSecond;
+    CFTimeInterval _startTime;
+    CGFloat _fromLocation;
+    CGFloat _toLocation;
+    void (^_frameHandler)(CGFloat xLocation);
+    void (^_completion)(void);
 }
 
 
-- (void)setFrontViewShadowOffset:(CGSize)frontViewShadowOffset
+static NSInteger SWRevealMaximumFramesPerSecond( void )
 {
-    _frontViewShadowOffset = frontViewShadowOffset;
-    [_contentView reloadShadow];
+    UIScreen *screen = [UIScreen mainScreen];
+    if ( [screen respondsToSelector:@selector(maximumFramesPerSecond)] && screen.maximumFramesPerSecond > 0 )
+        return screen.maximumFramesPerSecond;
+    
+    return 60;
 }
 
 
-- (void)setFrontViewShadowOpacity:(CGFloat)frontViewShadowOpacity
+- (id)initWithCurve:(const SWRevealCurve *)curve fromLocation:(CGFloat)fromLocation toLocation:(CGFloat)toLocation
 {
-    _frontViewShadowOpacity = frontViewShadowOpacity;
+    self = [super init];
+    if ( self )
+    {
+        _fromLocation = fromLocation;
+        _toLocation = toLocation;
+        _framesPerSecond = SWRevealMaximumFramesPerSecond();
+        _curve = *curve;
+        
+        // curves too long to be sampled ahead, or for which samples can not be allocated, are evaluated on each frame
+        double frameInterval = 1.0/_framesPerSecond;
+        if ( SWRevealCurveFitsSamples( curve, frameInterval ) )
+        {
+            int sampleCount = SWRevealCurveSampleCount( curve, frameInterval );
+            _samples = malloc( sampleCount*sizeof *_samples );
+            if ( _samples )
+            {
+                SWRevealCurveSample( curve, frameInterval, _samples, sampleCount );
+                _sampleCount = sampleCount;
+            }
+        }
+    }
+    return self;
+}
+
+
+- (void)dealloc
+{
+    [self stop];
+    free( _samples );
+}
+
+
+- (void)runWithFrameHandler:(void (^)(CGFloat xLocation))frameHandler completion:(void (^)(void))completion
+{
+    _frameHandler = [frameHandler copy];
+    _completion = [completion copy];
+    
+    // the display link retains us until we stop
+    _link = [CADisplayLink displayLinkWithTarget:self selector:@selector(_linkFired:)];
+    if ( [_link respondsToSelector:@selector(setPreferredFramesPerSecond:)] )
+        _link.preferredFramesPerSecond = _framesPerSecond;
+    
+    [_link addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    _startTime = CACurrentMediaTime();
+}
+
+
+- (void)_linkFired:(CADisplayLink *)link
+{
+    // frames may be skipped or paced at a lower rate, so samples are interpolated at the frame display time
+    CFTimeInterval frameTime = [link respondsToSelector:@selector(targetTimestamp)] ? link.targetTimestamp : link.timestamp + link.duration;
+    
+    BOOL finished;
+    double progress = 1.0;
+    if ( _samples )
+    {
+        double index = (frameTime - _startTime)*_framesPerSecond;
+        finished = !(index < _sampleCount-1);
+        if ( !finished )
+        {
+            if ( index < 0.0 ) index = 0.0;
+            int i = (int)index;
+            progress = _samples[i] + (_samples[i+1]-_samples[i])*(index-i);
+        }
+    }
+    else
+    {
+        double t = frameTime - _startTime;
+        finished = !(t < _curve.duration);
+        progress = SWRevealCurveValue( &_curve, t );
+    }
+    
+    _frameHandler( _fromLocation + (_toLocation-_fromLocation)*progress );
+    
+    if ( finished )
+    {
+        void (^completion)(void) = _completion;
+        [self stop];
+        completion();
+    }
+}
+
+
+- (void)stop
+{
+    [_link invalidate];
+    _link = nil;
+    _frameHandler = nil;
+    _completion = nil;
+}
+
+@end
+
+
+#pragma mark - SWRevealPanArbiter Class
+
+// Single arbitration point for the pan gestures of nested reveal controllers that route them. The controllers whose pan
+// recognizers receive a touch are the candidates, the first time one of them is asked to begin the owner of the gesture
+// is picked as the deepest candidate allowing it. Later requests for the same touch just compare against the owner, unless
+// the owner recognizer failed, in which case the owner is picked again among the remaining candidates
+@interface SWRevealPanArbiter : NSObject
++ (SWRevealPanArbiter *)sharedArbiter;
+- (void)addCandidate:(SWRevealViewController *)controller forTouch:(UITouch *)touch;
+- (void)removeCandidate:(SWRevealViewController *)controller;
+- (BOOL)shouldBeginForController:(SWRevealViewController *)controller;
+@end
+
+
+@implementation SWRevealPanArbiter
+{
+    __weak UITouch *_touch;
+    NSHashTable *_candidates;
+    __weak SWRevealViewController *_owner;
+    BOOL _decided;
+}
+
+
++ (SWRevealPanArbiter *)sharedArbiter
+{
+    static SWRevealPanArbiter *arbiter = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once( &onceToken, ^{ arbiter = [[SWRevealPanArbiter alloc] init]; } );
+    return arbiter;
+}
+
+
+- (id)init
+{
+    self = [super init];
+    if ( self )
+    {
+        _candidates = [NSHashTable weakObjectsHashTable];
+    }
+    return self;
+}
+
+
+- (void)addCandidate:(SWRevealViewController *)controller forTouch:(UITouch *)touch
+{
+    if ( touch != _touch )
+    {
+        _touch = touch;
+        [_candidates removeAllObjects];
+        _owner = nil;
+        _decided = NO;
+    }
+    
+    [_candidates addObject:controller];
+}
+
+
+// Called when the pan recognizer of a candidate resets, that is after it failed or its gesture ended
+- (void)removeCandidate:(SWRevealViewController *)controller
+{
+    [_candidates removeObject:controller];
+    if ( controller == _owner )
+    {
+        _owner = nil;
+        _decided = NO;
+    }
+}
+
+
+- (BOOL)shouldBeginForController:(SWRevealViewController *)controller
+{
+    // not part of the current arbitration, let it decide on its own
+    if ( ![_candidates containsObject:controller] )
+        return [controller _panGestureCanBegin];
+    
+    // the owner went away or its recognizer failed before the gesture began, the next level gets a chance
+    SWRevealViewController *owner = _owner;
+    if ( _decided && (owner == nil || owner.panGestureRecognizer.state == UIGestureRecognizerStateFailed) )
+    {
+        if ( owner ) [_candidates removeObject:owner];
+        _owner = nil;
+        _decided = NO;
+    }
+    
+    if ( !_decided )
+    {
+        _decided = YES;
+        NSArray *candidates = [[_candidates allObjects] sortedArrayUsingComparator:^NSComparisonResult(id a, id b)
+        {
+            NSUInteger levelA = [a nestingLevel], levelB = [b nestingLevel];
+            return levelA > levelB ? NSOrderedAscending : (levelA < levelB ? NSOrderedDescending : NSOrderedSame);
+        }];
+        
+        for ( SWRevealViewController *candidate in candidates )
+        {
+            if ( candidate.panGestureRecognizer.state == UIGestureRecognizerStateFailed )
+                continue;
+            
+            if ( [candidate _panGestureCanBegin] )
+            {
+                _owner = candidate;
+                break;
+            }
+        }
+    }
+    
+    return _owner == controller;
+}
+
+@end
+
+
+#pragma mark - SWRevealViewControllerPanGestureRecognizer
+
+#import <UIKit/UIGestureRecognizerSubclass.h>
+
+@interface SWRevealViewControllerPanGestureRecognizer : UIPanGestureRecognizer
+@property (nonatomic, readonly) NSTimeInterval touchTimestamp;  // <-- time of the last touch event, 0 if none
+@end
+
+@interface SWRevealViewController()
+- (void)_panGestureRecognizerDidReset:(UIPanGestureRecognizer *)recognizer;
+@end
+
+@implementation SWRevealViewControllerPanGestureRecognizer
+{
+    BOOL _dragging;
+    CGPoint _beginPoint;
+}
+
+- (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    [super touchesBegan:touches withEvent:event];
+   
+    UITouch *touch = [touches anyObject];
+    _beginPoint = [touch locationInView:self.view];
+    _touchTimestamp = touch.timestamp;
+    _dragging = NO;
+}
+
+
+- (void)touchesMoved:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    _touchTimestamp = [[touches anyObject] timestamp];
+    [super touchesMoved:touches withEvent:event];
+    
+    if ( _dragging || self.state == UIGestureRecognizerStateFailed)
+        return;
+    
+    const CGFloat kDirectionPanThreshold = 5;
+    
+    UITouch *touch = [touches anyObject];
+    CGPoint nowPoint = [touch locationInView:self.view];
+    
+    if (ABS(nowPoint.x - _beginPoint.x) > kDirectionPanThreshold) _dragging = YES;
+    else if (ABS(nowPoint.y - _beginPoint.y) > kDirectionPanThreshold) self.state = UIGestureRecognizerStateFailed;
+}
+
+
+- (void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    _touchTimestamp = [[touches anyObject] timestamp];
+    [super touchesEnded:touches withEvent:event];
+}
+
+
+- (void)reset
+{
+    [super reset];
+    _touchTimestamp = 0;
+    
+    id delegate = self.delegate;
+    if ( [delegate isKindOfClass:[SWRevealViewController class]] )
+        [delegate _panGestureRecognizerDidReset:self];
+}
+
+@end
+
+
+#pragma mark - Reveal controller lookup
+
+// Returns the closest SWRevealViewController above 'controller' and the number of reveal controllers above it in 'pDepth'.
+// Parent chains are short, so this walks them on every call rather than remembering results that any container could
+// invalidate without telling us
+static SWRevealViewController *SWRevealControllerAbove( UIViewController *controller, NSUInteger *pDepth )
+{
+    Class revealClass = [SWRevealViewController class];
+    SWRevealViewController *revealController = nil;
+    NSUInteger depth = 0;
+    
+    UIViewController *parent = controller;
+    while ( nil != (parent = [parent parentViewController]) )
+    {
+        if ( ![parent isKindOfClass:revealClass] ) continue;
+        if ( revealController == nil ) revealController = (id)parent;
+        if ( pDepth == NULL ) break;
+        depth += 1;
+    }
+    
+    if ( pDepth ) *pDepth = depth;
+    return revealController;
+}
+
+
+#pragma mark - SWRevealViewController Class
+
+// Optional delegate methods implemented by the delegate, in the order of the selectors in setDelegate:
+enum
+{
+    SWRevealDelegateWillMoveToPosition = 1 << 0,
+    SWRevealDelegateDidMoveToPosition = 1 << 1,
+    SWRevealDelegateAnimateToPosition = 1 << 2,
+    SWRevealDelegatePanGestureShouldBegin = 1 << 3,
+    SWRevealDelegateTapGestureShouldBegin = 1 << 4,
+    SWRevealDelegatePanGestureSimultaneous = 1 << 5,
+    SWRevealDelegateTapGestureSimultaneous = 1 << 6,
+    SWRevealDelegatePanGestureBegan = 1 << 7,
+    SWRevealDelegatePanGestureEnded = 1 << 8,
+    SWRevealDelegatePanBeganFromLocation = 1 << 9,
+    SWRevealDelegatePanMovedToLocation = 1 << 10,
+    SWRevealDelegatePanEndedToLocation = 1 << 11,
+    SWRevealDelegatePanBeganFromLocationDeprecated = 1 << 12,
+    SWRevealDelegatePanMovedToLocationDeprecated = 1 << 13,
+    SWRevealDelegatePanEndedToLocationDeprecated = 1 << 14,
+    SWRevealDelegateWillAddViewController = 1 << 15,
+    SWRevealDelegateDidAddViewController = 1 << 16,
+    SWRevealDelegateAnimationController = 1 << 17,
+    SWRevealDelegateFrameStats = 1 << 18,
+    SWRevealDelegateRetainedViews = 1 << 19,
+    SWRevealDelegateAnimationMovedToLocation = 1 << 20,
+    SWRevealDelegateMovedToDetentProgress = 1 << 21,
+};
+typedef NSUInteger SWRevealDelegateCapabilities;
+
+// Values of a controller view layer that transform tracks overwrite, restored when the tracks no longer drive it
+typedef struct
+{
+    float opacity;
+    CGFloat cornerRadius;
+    BOOL masksToBounds;
+
+} SWRevealSavedLayerValues;
+
+
+@interface SWRevealViewController()<UIGestureRecognizerDelegate>
+{
+    SWRevealView *_contentView;
+    UIPanGestureRecognizer *_panGestureRecognizer;
+    UITapGestureRecognizer *_tapGestureRecognizer;
+    FrontViewPosition _frontViewPosition;
+    FrontViewPosition _rearViewPosition;
+    FrontViewPosition _rightViewPosition;
+    SWContextTransitionObject *_rearTransitioningController;
+    SWContextTransitionObject *_frontTransitioningController;
+    SWContextTransitionObject *_rightTransitioningController;
+}
+@end
+
+
+@implementation SWRevealViewController
+{
+    CGFloat _panInitialLocation;
+    BOOL _panInterruptPending;
+    void (^_interruptedDeploymentCompletion)(void);  // <-- deployment completion held while an interrupting touch is undecided
+    SWRevealFlingPredictor _flingPredictor;
+    SWRevealTraceRecorder _traceRecorder;
+    BOOL _traceRecording;
+    SWRevealProgressStream *_progressStream;    // <-- our reference, NULL while the capacity is zero
+    SWRevealTrackSet _transformTracks;
+    unsigned int _transformTrackMasks[SWRevealTrackLayerCount];    // <-- properties written on the last evaluation
+    CALayer *_transformTrackLayers[SWRevealTrackLayerCount];        // <-- controller view layers with saved values
+    SWRevealSavedLayerValues _transformTrackSavedValues[SWRevealTrackLayerCount];
+    SWRevealDelegateCapabilities _delegateCapabilities;
+    CADisplayLink *_panMovedLink;
+    BOOL _panMovedPending;
+    SWRevealFrameStats _frameStats;
+    CADisplayLink *_frameStatsLink;
+    BOOL _frameStatsDuringGesture;
+    SWRevealIdleScheduler *_prewarmScheduler;
+    SWRevealControllerCache *_frontControllerCache;
+    BOOL _containerRetained[2];             // <-- right (0) and rear (1) containers kept after closing
+    NSUInteger _containerGeneration[2];     // <-- invalidates pending expirations
+    SWRevealCommandQueue _commandQueue;
+    NSUInteger _animationSerial;
+    void (^_runningDeploymentCompletion)(void);
+    SWRevealAnimationDriver *_animationDriver;
+    UIViewPropertyAnimator *_springAnimator;
+    BOOL _userInteractionStore;
+    SWRevealWidthProfile _sizeClassWidthProfiles[3];
+    BOOL _sizeClassWidthProfileSet[3];
+    SWRevealDetents _detents;               // <-- custom stops, a side with no stops uses the default positions
+    SWRevealTransaction *_openTransaction;  // <-- collects the changes requested in performBatchUpdates:animated:
+    SWRevealZoneMap _panGestureZones;
+    NSUInteger _transactionDepth;
+    NSInteger _frontViewDetent;             // <-- custom stop the front view rests at, 0 for the default location of its position
+}
+
+const int FrontViewPositionNone = 0xff;
+
+
+#pragma mark - Init
+
+static void releaseCommandObject( void *object )
+{
+    CFBridgingRelease( object );
+}
+
+
+- (id)initWithCoder:(NSCoder *)aDecoder
+{
+    self = [super initWithCoder:aDecoder];
+    if ( self )
+    {
+        [self _initDefaultProperties];
+    }    
+    return self;
+}
+
+
+- (id)init
+{
+    return [self initWithRearViewController:nil frontViewController:nil];
+}
+
+
+- (id)initWithRearViewController:(UIViewController *)rearViewController frontViewController:(UIViewController *)frontViewController;
+{
+    self = [super init];
+    if ( self )
+    {
+        [self _initDefaultProperties];
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceRearController withViewController:rearViewController animated:NO];
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:NO];
+    }
+    return self;
+}
+
+
+- (void)dealloc
+{
+    SWRevealCommandQueueFree( &_commandQueue );
+    if ( _traceRecording ) SWRevealTraceRecorderFree( &_traceRecorder );
+    SWRevealZoneMapFree( &_panGestureZones );
+    SWRevealProgressStreamRelease( _progressStream );
+    SWRevealTrackSetFree( &_transformTracks );
+}
+
+
+- (void)_initDefaultProperties
+{
+    _frontViewPosition = FrontViewPositionLeft;
+    _rearViewPosition = FrontViewPositionLeft;
+    _rightViewPosition = FrontViewPositionLeft;
+    _rearViewRevealWidth = 260.0f;
+    _rearViewRevealOverdraw = 60.0f;
+    _rearViewRevealDisplacement = 40.0f;
+    _rightViewRevealWidth = 260.0f;
+    _rightViewRevealOverdraw = 60.0f;
+    _rightViewRevealDisplacement = 40.0f;
+    _bounceBackOnOverdraw = YES;
+    _bounceBackOnLeftOverdraw = YES;
+    _stableDragOnOverdraw = NO;
+    _stableDragOnLeftOverdraw = NO;
+    _presentFrontViewHierarchically = NO;
+    _quickFlickVelocity = 250.0f;
+    _toggleAnimationDuration = 0.3;
+    _toggleAnimationType = SWRevealToggleAnimationTypeSpring;
+    _springDampingRatio = 1;
+    _replaceViewAnimationDuration = 0.25;
+    _frontViewShadowRadius = 2.5f;
+    _frontViewShadowOffset = CGSizeMake(0.0f, 2.5f);
+    _frontViewShadowOpacity = 1.0f;
+    _frontViewShadowColor = [UIColor blackColor];
+    _userInteractionStore = YES;
+    SWRevealCommandQueueInit( &_commandQueue, releaseCommandObject );
+    SWRevealTrackSetInit( &_transformTracks );
+    _draggableBorderWidth = 0.0f;
+    _clipsViewsToBounds = NO;
+    _extendsPointInsideHit = NO;
+    _dragResistanceType = SWRevealDragResistanceTypeLinearClamp;
+    _frameBudget = 1.0/60.0;
+    _prewarmTimeBudget = 0.004;
+    _viewRetentionInterval = 30.0;
+    _unloadsChildViewsOnMemoryWarning = NO;
+    _frontControllerCache = [[SWRevealControllerCache alloc] init];
+    _frontControllerCache.countLimit = 4;
+}
+
+
+#pragma mark - StatusBar
+
+- (UIViewController *)childViewControllerForStatusBarStyle
+{
+    int positionDif =  _frontViewPosition - FrontViewPositionLeft;
+    
+    UIViewController *controller = _frontViewController;
+    if ( positionDif > 0 ) controller = _rearViewController;
+    else if ( positionDif < 0 ) controller = _rightViewController;
+    
+    return controller;
+}
+
+- (UIViewController *)childViewControllerForStatusBarHidden
+{
+    UIViewController *controller = [self childViewControllerForStatusBarStyle];
+    return controller;
+}
+
+
+#pragma mark - View lifecycle
+
+- (void)loadView
+{
+    // Do not call super, to prevent the apis from unfruitful looking for inexistent xibs!
+    //[super loadView];
+    
+    // load any defined front/rear controllers from the storyboard before
+    [self loadStoryboardControllers];
+    
+    // This is what Apple used to tell us to set as the initial frame, which is of course totally irrelevant
+    // with view controller containment patterns, let's leave it for the sake of it!
+    // CGRect frame = [[UIScreen mainScreen] applicationFrame];
+    
+    // On iOS7 the applicationFrame does not return the whole screen. This is possibly a bug.
+    // As a workaround we use the screen bounds, this still works on iOS6, any zero based frame would work anyway!
+    CGRect frame = [[UIScreen mainScreen] bounds];
+
+    // create a custom content view for the controller
+    _contentView = [[SWRevealView alloc] initWithFrame:frame controller:self];
+    
+    // set the content view to resize along with its superview
+    [_contentView setAutoresizingMask:UIViewAutoresizingFlexibleWidth|UIViewAutoresizingFlexibleHeight];
+    
+    // set the content view to clip its bounds if requested
+    [_contentView setClipsToBounds:_clipsViewsToBounds];
+
+    // set our contentView to the controllers view
+    self.view = _contentView;
+    
+    // Apple also tells us to do this:
+    _contentView.backgroundColor = [UIColor blackColor];
+    
+    // we set the current frontViewPosition to none before seting the
+    // desired initial position, this will force proper controller reload
+    FrontViewPosition initialPosition = _frontViewPosition;
+    _frontViewPosition = FrontViewPositionNone;
+    _rearViewPosition = FrontViewPositionNone;
+    _rightViewPosition = FrontViewPositionNone;
+    
+    // now set the desired initial position
+    [self _setFrontViewPosition:initialPosition withDuration:0.0];
+}
+
+
+- (void)viewDidAppear:(BOOL)animated
+{
+    [super viewDidAppear:animated];
+
+    // Uncomment the following code if you want the child controllers
+    // to be loaded at this point.
+    //
+    // We leave this commented out because we think loading childs here is conceptually wrong.
+    // Instead, we refrain view loads until necesary, for example we may never load
+    // the rear controller view -or the front controller view- if it is never displayed.
+    //
+    // If you need to manipulate views of any of your child controllers in an override
+    // of this method, you can load yourself the views explicitly on your overriden method.
+    // However we discourage it as an app following the MVC principles should never need to do so
+        
+//  [_frontViewController view];
+//  [_rearViewController view];
+
+    // we store at this point the view's user interaction state as we may temporarily disable it
+    // and resume it back to the previous state, it is possible to override this behaviour by
+    // intercepting it on the panGestureBegan and panGestureEnded delegates
+    _userInteractionStore = _contentView.userInteractionEnabled;
+    
+    // if requested, we load child views anyway but only when the app is idle
+    if ( _prewarmsChildViews )
+        [self prewarmChildViews];
+}
+
+
+- (void)didReceiveMemoryWarning
+{
+    [super didReceiveMemoryWarning];
+    
+    [_frontControllerCache removeAllExceptController:_frontViewController];
+    
+    if ( _viewRetentionPolicy != SWRevealViewRetentionPolicyNone && _viewRetentionPolicy != SWRevealViewRetentionPolicyKeepAlive )
+    {
+        for ( int symetry=-1 ; symetry<=1 ; symetry+=2 )
+        {
+            if ( _containerRetained[symetry<0 ? 0 : 1] )
+                [self _unloadContainerForSymetry:symetry];
+            
+            // views of controllers that are not displayed are reloaded when needed, only if requested
+            UIViewController *controller = symetry > 0 ? _rearViewController : _rightViewController;
+            if ( _unloadsChildViewsOnMemoryWarning && [controller isViewLoaded] && controller.view.window == nil )
+                controller.view = nil;
+        }
+    }
+}
+
+
+- (NSUInteger)supportedInterfaceOrientations
+{
+    // we could have simply not implemented this, but we choose to call super to make explicit that we
+    // want the default behavior.
+    return [super supportedInterfaceOrientations];
+}
+
+
+#pragma mark - Public methods and property accessors
+
+- (void)setFrontViewController:(UIViewController *)frontViewController
+{
+    [self setFrontViewController:frontViewController animated:NO];
+}
+
+
+- (void)setFrontViewController:(UIViewController *)frontViewController animated:(BOOL)animated
+{
+    if ( _openTransaction )
+    {
+        [_openTransaction setViewController:frontViewController forOperation:SWRevealControllerOperationReplaceFrontController];
+        return;
+    }
+    
+    if ( ![self isViewLoaded])
+    {
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:NO];
+        return;
+    }
+    
+    [self _dispatchTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:animated];
+}
+
+
+- (void)pushFrontViewController:(UIViewController *)frontViewController animated:(BOOL)animated
+{
+    if ( ![self isViewLoaded])
+    {
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:NO];
+        return;
+    }
+    
+    [self _dispatchPushFrontViewController:frontViewController animated:animated];
+}
+
+
+- (UIViewController *)frontViewControllerForKey:(id<NSCopying>)key provider:(UIViewController *(^)(void))provider
+{
+    UIViewController *controller = [_frontControllerCache controllerForKey:key];
+    if ( controller == nil && provider )
+    {
+        controller = provider();
+        [_frontControllerCache setController:controller forKey:key];
+        [_frontControllerCache evictExceptController:_frontViewController keepingController:controller];
+    }
+    return controller;
+}
+
+
+- (void)removeCachedFrontViewControllerForKey:(id<NSCopying>)key
+{
+    [_frontControllerCache removeControllerForKey:key];
+}
+
+
+- (void)removeAllCachedFrontViewControllers
+{
+    [_frontControllerCache removeAllExceptController:nil];
+}
+
+
+- (void)setFrontViewControllerCacheCountLimit:(NSUInteger)countLimit
+{
+    _frontControllerCache.countLimit = countLimit;
+    [_frontControllerCache evictExceptController:_frontViewController];
+}
+
+
+- (NSUInteger)frontViewControllerCacheCountLimit
+{
+    return _frontControllerCache.countLimit;
+}
+
+
+- (void)setFrontViewControllerCacheCostLimit:(NSUInteger)costLimit
+{
+    _frontControllerCache.costLimit = costLimit;
+    [_frontControllerCache evictExceptController:_frontViewController];
+}
+
+
+- (NSUInteger)frontViewControllerCacheCostLimit
+{
+    return _frontControllerCache.costLimit;
+}
+
+
+- (NSUInteger)frontViewControllerCacheHits
+{
+    return _frontControllerCache.hits;
+}
+
+
+- (NSUInteger)frontViewControllerCacheMisses
+{
+    return _frontControllerCache.misses;
+}
+
+
+- (void)setRearViewController:(UIViewController *)rearViewController
+{
+    [self setRearViewController:rearViewController animated:NO];
+}
+
+
+- (void)setRearViewController:(UIViewController *)rearViewController animated:(BOOL)animated
+{
+    if ( _openTransaction )
+    {
+        [_openTransaction setViewController:rearViewController forOperation:SWRevealControllerOperationReplaceRearController];
+        return;
+    }
+    
+    if ( ![self isViewLoaded])
+    {
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceRearController withViewController:rearViewController animated:NO];
+        return;
+    }
+
+    [self _dispatchTransitionOperation:SWRevealControllerOperationReplaceRearController withViewController:rearViewController animated:animated];
+}
+
+
+- (void)setRightViewController:(UIViewController *)rightViewController
+{
+    [self setRightViewController:rightViewController animated:NO];
+}
+
+
+- (void)setRightViewController:(UIViewController *)rightViewController animated:(BOOL)animated
+{
+    if ( _openTransaction )
+    {
+        [_openTransaction setViewController:rightViewController forOperation:SWRevealControllerOperationReplaceRightController];
+        return;
+    }
+    
+    if ( ![self isViewLoaded])
+    {
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceRightController withViewController:rightViewController animated:NO];
+        return;
+    }
+
+    [self _dispatchTransitionOperation:SWRevealControllerOperationReplaceRightController withViewController:rightViewController animated:animated];
+}
+
+
+- (void)revealToggleAnimated:(BOOL)animated
+{
+    FrontViewPosition toggledFrontViewPosition = FrontViewPositionLeft;
+    if (_frontViewPosition <= FrontViewPositionLeft)
+        toggledFrontViewPosition = FrontViewPositionRight;
+    
+    [self setFrontViewPosition:toggledFrontViewPosition animated:animated];
+}
+
+
+- (void)rightRevealToggleAnimated:(BOOL)animated
+{
+    FrontViewPosition toggledFrontViewPosition = FrontViewPositionLeft;
+    if (_frontViewPosition >= FrontViewPositionLeft)
+        toggledFrontViewPosition = FrontViewPositionLeftSide;
+    
+    [self setFrontViewPosition:toggledFrontViewPosition animated:animated];
+}
+
+
+- (void)setFrontViewPosition:(FrontViewPosition)frontViewPosition
+{
+    [self setFrontViewPosition:frontViewPosition animated:NO];
+}
+
+
+- (void)setFrontViewPosition:(FrontViewPosition)frontViewPosition animated:(BOOL)animated
+{
+    if ( _openTransaction )
+    {
+        _openTransaction.position = frontViewPosition;
+        return;
+    }
+    
+    if ( ![self isViewLoaded] )
+    {
+        _frontViewPosition = frontViewPosition;
+        _rearViewPosition = frontViewPosition;
+        _rightViewPosition = frontViewPosition;
+        return;
+    }
+    
+    [self _dispatchSetFrontViewPosition:frontViewPosition animated:animated];
+}
+
+
+- (void)cancelPendingOperations
+{
+    SWRevealCommandQueueCancelPending( &_commandQueue );
+}
+
+
+- (void)addPanGestureZone:(CGRect)rect type:(SWRevealGestureZoneType)type edge:(SWRevealGestureZoneEdge)edge positions:(NSUInteger)positions
+{
+    SWRevealZone zone;
+    zone.rect = (SWRevealRect){ rect.origin.x, rect.origin.y, rect.size.width, rect.size.height };
+    zone.type = type == SWRevealGestureZoneTypeExclude ? SWRevealZoneExclude : SWRevealZoneAllow;
+    zone.edge = edge == SWRevealGestureZoneEdgeRight ? SWRevealZoneEdgeRight : SWRevealZoneEdgeLeft;
+    zone.positions = (unsigned int)positions;
+    SWRevealZoneMapAdd( &_panGestureZones, &zone );
+    
+    [self _compilePanGestureZones];
+}
+
+
+- (void)removeAllPanGestureZones
+{
+    SWRevealZoneMapRemoveAll( &_panGestureZones );
+}
+
+
+- (void)addTransformTrackForLayer:(SWRevealTransformTrackLayer)layer property:(SWRevealTransformTrackProperty)property
+    progress:(NSArray *)progress values:(NSArray *)values
+{
+    NSUInteger count = MIN( progress.count, values.count );
+    double *keyframes = malloc( 2*MAX(count, 1u)*sizeof *keyframes );
+    if ( keyframes == NULL )
+        return;
+    
+    for ( NSUInteger i=0 ; i<count ; i++ )
+    {
+        keyframes[i] = [progress[i] doubleValue];
+        keyframes[count+i] = [values[i] doubleValue];
+    }
+    
+    int result = SWRevealTrackSetAdd( &_transformTracks, (SWRevealTrackLayer)layer, (SWRevealTrackProperty)property,
+        keyframes, keyframes+count, (unsigned int)count );
+    free( keyframes );
+    
+    NSAssert( result == 0, @"SWRevealViewController: transform tracks need at least one keyframe, at ascending progress values" );
+    (void)result;
+    
+    [self _applyTransformTracks];
+}
+
+
+- (void)removeAllTransformTracks
+{
+    SWRevealTrackSetRemoveAll( &_transformTracks );
+    [self _applyTransformTracks];
+}
+
+
+- (void)performBatchUpdates:(void (^)(void))updates animated:(BOOL)animated
+{
+    if ( _transactionDepth++ == 0 )
+        _openTransaction = [[SWRevealTransaction alloc] init];
+    
+    if ( updates )
+        updates();
+    
+    if ( --_transactionDepth > 0 )
+        return;
+    
+    SWRevealTransaction *transaction = _openTransaction;
+    _openTransaction = nil;
+    transaction.animated = animated;
+    
+    if ( [transaction isEmpty] )
+        return;
+    
+    // before the view is loaded there is nothing to animate, the changes just apply
+    if ( ![self isViewLoaded] )
+    {
+        for ( NSNumber *operation in transaction.operations )
+        {
+            SWRevealControllerOperation op = [operation integerValue];
+            [self _performTransitionOperation:op withViewController:[transaction viewControllerForOperation:op] animated:NO];
+        }
+        
+        if ( transaction.hasPosition )
+            [self setFrontViewPosition:transaction.position animated:NO];
+        return;
+    }
+    
+    SWRevealCommand command = { SWRevealCommandBatch, 0, 0, 0.0, 0, animated, (void*)CFBridgingRetain(transaction), 0 };
+    [self _enqueueCommand:command];
+}
+
+
+- (void)setRearViewDetents:(NSArray *)offsets
+{
+    [self _setDetentOffsets:offsets forSymetry:1];
+}
+
+
+- (void)setRightViewDetents:(NSArray *)offsets
+{
+    [self _setDetentOffsets:offsets forSymetry:-1];
+}
+
+
+- (NSInteger)frontViewDetent
+{
+    if ( _frontViewDetent != 0 )
+        return _frontViewDetent;
+    
+    int symetry = _frontViewPosition<FrontViewPositionLeft ? -1 : 1;
+    if ( _detents.sides[symetry<0 ? 0 : 1].count > 0 )
+        return 0;
+    
+    // sides with no stops report the preset stop of the position, the removed positions rest at the last one
+    SWRevealDetents detents;
+    [self _getDetents:&detents];
+    CGFloat revealWidth, revealOverdraw;
+    [self _getRevealWidth:&revealWidth revealOverDraw:&revealOverdraw forSymetry:symetry];
+    
+    CGFloat offset = 0;
+    FrontViewPosition position = (FrontViewPosition)SWRevealAdjustedPosition( (SWRevealPosition)_frontViewPosition, symetry );
+    if ( position == FrontViewPositionRight ) offset = revealWidth;
+    if ( position >= FrontViewPositionRightMost ) offset = revealWidth + revealOverdraw;
+    
+    return (NSInteger)SWRevealDetentSideIndexForOffset( &detents.sides[symetry<0 ? 0 : 1], offset )*symetry;
+}
+
+
+- (CGFloat)frontViewDetentProgress
+{
+    if ( ![self isViewLoaded] )
+        return [self frontViewDetent];
+    
+    SWRevealDetents detents;
+    [self _getDetents:&detents];
+    return SWRevealDetentsProgress( &detents, _contentView.frontView.frame.origin.x );
+}
+
+
+- (void)setFrontViewDetent:(NSInteger)detent animated:(BOOL)animated
+{
+    int symetry = detent<0 ? -1 : 1;
+    
+    // sides with no stops use the preset stops of the default positions, detents past the last stop are clamped to it
+    SWRevealDetents detents;
+    [self _getDetents:&detents];
+    const SWRevealDetentSide *side = &detents.sides[symetry<0 ? 0 : 1];
+    if ( detent*symetry > (NSInteger)side->count-1 ) detent = (NSInteger)(side->count-1)*symetry;
+    
+    FrontViewPosition frontViewPosition;
+    if ( _detents.sides[symetry<0 ? 0 : 1].count == 0 )
+    {
+        frontViewPosition = (FrontViewPosition)SWRevealDetentsPresetPosition( (int)detent );
+        detent = 0;
+    }
+    else
+    {
+        frontViewPosition = detent > 0 ? FrontViewPositionRight : detent < 0 ? FrontViewPositionLeftSide : FrontViewPositionLeft;
+    }
+    
+    if ( ![self isViewLoaded] )
+    {
+        _frontViewPosition = frontViewPosition;
+        _rearViewPosition = frontViewPosition;
+        _rightViewPosition = frontViewPosition;
+        _frontViewDetent = detent;
+        return;
+    }
+    
+    NSTimeInterval duration = animated?_toggleAnimationDuration:0.0;
+    SWRevealCommand command = { SWRevealCommandSetPosition, 0, (int)frontViewPosition, duration, 0, NO, NULL, (int)detent };
+    [self _enqueueCommand:command];
+}
+
+
+- (void)prewarmChildViews
+{
+    if ( ![self isViewLoaded] )
+        return;
+    
+    [_prewarmScheduler cancel];
+    _prewarmScheduler = [[SWRevealIdleScheduler alloc] initWithTimeBudget:_prewarmTimeBudget];
+    
+    __weak SWRevealViewController *weakSelf = self;
+    [_prewarmScheduler addTask:^{ [weakSelf _prewarmContainerForSymetry:1]; }];
+    [_prewarmScheduler addTask:^{ [weakSelf _prewarmControllerViewForSymetry:1]; }];
+    [_prewarmScheduler addTask:^{ [weakSelf _prewarmContainerForSymetry:-1]; }];
+    [_prewarmScheduler addTask:^{ [weakSelf _prewarmControllerViewForSymetry:-1]; }];
+}
+
+
+- (void)startRecordingGestureTrace
+{
+    if ( _traceRecording )
+        SWRevealTraceRecorderFree( &_traceRecorder );
+    
+    _traceRecording = SWRevealTraceRecorderInit( &_traceRecorder, 4096 );
+}
+
+
+- (NSData*)stopRecordingGestureTrace
+{
+    if ( !_traceRecording )
+        return nil;
+    
+    NSData *trace = [NSData dataWithBytes:_traceRecorder.bytes length:_traceRecorder.length];
+    SWRevealTraceRecorderFree( &_traceRecorder );
+    _traceRecording = NO;
+    return trace;
+}
+
+
+// Consumers holding a reference to the previous stream can still drain it, it is freed with their last release
+- (void)setProgressStreamCapacity:(NSUInteger)progressStreamCapacity
+{
+    SWRevealProgressStreamRelease( _progressStream );
+    _progressStream = NULL;
+    _progressStreamCapacity = progressStreamCapacity;
+    
+    if ( progressStreamCapacity > 0 )
+        _progressStream = SWRevealProgressStreamCreate( (unsigned int)MIN(progressStreamCapacity, UINT_MAX) );
+}
+
+
+- (SWRevealProgressStream *)progressStream
+{
+    return _progressStream;
+}
+
+
+- (void)setFrontViewShadowRadius:(CGFloat)frontViewShadowRadius
+{
+    _frontViewShadowRadius = frontViewShadowRadius;
+    [_contentView reloadShadow];
+}
+
+
+- (void)setFrontViewShadowOffset:(CGSize)frontViewShadowOffset
+{
+    _frontViewShadowOffset = frontViewShadowOffset;
+    [_contentView reloadShadow];
+}
+
+
+- (void)setFrontViewShadowOpacity:(CGFloat)frontViewShadowOpacity
+{
+    _frontViewShadowOpacity = frontViewShadowOpacity;
+    [_contentView reloadShadow];
+}
+
+
+- (void)setFrontViewShadowColor:(UIColor *)frontViewShadowColor
+{
+    _frontViewShadowColor = frontViewShadowColor;
+    [_contentView reloadShadow];
+}
+
+
+- (void)setFrontViewShadowStyle:(SWRevealFrontViewShadowStyle)frontViewShadowStyle
+{
+    _frontViewShadowStyle = frontViewShadowStyle;
     [_contentView reloadShadow];
 }
 
 
-- (void)setFrontViewShadowColor:(UIColor *)frontViewShadowColor
+- (void)setRearViewRevealWidth:(CGFloat)rearViewRevealWidth
+{
+    _rearViewRevealWidth = rearViewRevealWidth;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setRightViewRevealWidth:(CGFloat)rightViewRevealWidth
+{
+    _rightViewRevealWidth = rightViewRevealWidth;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setRearViewRevealOverdraw:(CGFloat)rearViewRevealOverdraw
+{
+    _rearViewRevealOverdraw = rearViewRevealOverdraw;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setRightViewRevealOverdraw:(CGFloat)rightViewRevealOverdraw
+{
+    _rightViewRevealOverdraw = rightViewRevealOverdraw;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setBounceBackOnOverdraw:(BOOL)bounceBackOnOverdraw
 {
-    _frontViewShadowColor = frontViewShadowColor;
-    [_contentView reloadShadow];
+    _bounceBackOnOverdraw = bounceBackOnOverdraw;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setBounceBackOnLeftOverdraw:(BOOL)bounceBackOnLeftOverdraw
+{
+    _bounceBackOnLeftOverdraw = bounceBackOnLeftOverdraw;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setStableDragOnOverdraw:(BOOL)stableDragOnOverdraw
+{
+    _stableDragOnOverdraw = stableDragOnOverdraw;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setStableDragOnLeftOverdraw:(BOOL)stableDragOnLeftOverdraw
+{
+    _stableDragOnLeftOverdraw = stableDragOnLeftOverdraw;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setRearViewRevealWidth:(CGFloat)rearViewRevealWidth rearViewRevealOverdraw:(CGFloat)rearViewRevealOverdraw
+    rightViewRevealWidth:(CGFloat)rightViewRevealWidth rightViewRevealOverdraw:(CGFloat)rightViewRevealOverdraw
+    forHorizontalSizeClass:(UIUserInterfaceSizeClass)sizeClass
+{
+    if ( sizeClass <= 0 || sizeClass >= 3 )
+    {
+        _rearViewRevealWidth = rearViewRevealWidth;
+        _rearViewRevealOverdraw = rearViewRevealOverdraw;
+        _rightViewRevealWidth = rightViewRevealWidth;
+        _rightViewRevealOverdraw = rightViewRevealOverdraw;
+    }
+    else
+    {
+        SWRevealWidthProfile *profile = &_sizeClassWidthProfiles[sizeClass];
+        profile->rearRevealWidth = rearViewRevealWidth;
+        profile->rearRevealOverdraw = rearViewRevealOverdraw;
+        profile->rightRevealWidth = rightViewRevealWidth;
+        profile->rightRevealOverdraw = rightViewRevealOverdraw;
+        _sizeClassWidthProfileSet[sizeClass] = YES;
+    }
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)removeRevealWidthsForHorizontalSizeClass:(UIUserInterfaceSizeClass)sizeClass
+{
+    if ( sizeClass > 0 && sizeClass < 3 )
+        _sizeClassWidthProfileSet[sizeClass] = NO;
+    
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setDragResistanceType:(SWRevealDragResistanceType)dragResistanceType
+{
+    _dragResistanceType = dragResistanceType;
+    [_contentView invalidateMetrics];
+}
+
+
+- (void)setDragResistanceBlock:(CGFloat (^)(CGFloat))dragResistanceBlock
+{
+    _dragResistanceBlock = [dragResistanceBlock copy];
+    [_contentView invalidateMetrics];
 }
 
 
@@ -933,171 +2498,633 @@ const int FrontViewPositionNone = 0xff;
 }
 
 
-- (void)setClipsViewsToBounds:(BOOL)clipsViewsToBounds
+- (void)setClipsViewsToBounds:(BOOL)clipsViewsToBounds
+{
+    _clipsViewsToBounds = clipsViewsToBounds;
+    [_contentView setClipsToBounds:clipsViewsToBounds];
+}
+
+
+
+- (void)getGeometryConfig:(SWRevealGeometryConfig*)config
+{
+    *config = (SWRevealGeometryConfig){0};
+    [_contentView getGeometryConfig:config];
+    config->frontOffsetY = [_contentView hierarchycalFrontOffset];
+}
+
+
+// Delegate capabilities are looked up once here, rather than on every notification
+- (void)setDelegate:(id<SWRevealViewControllerDelegate>)delegate
+{
+    _delegate = delegate;
+    
+    SEL selectors[] =
+    {
+        @selector(revealController:willMoveToPosition:),
+        @selector(revealController:didMoveToPosition:),
+        @selector(revealController:animateToPosition:),
+        @selector(revealControllerPanGestureShouldBegin:),
+        @selector(revealControllerTapGestureShouldBegin:),
+        @selector(revealController:panGestureRecognizerShouldRecognizeSimultaneouslyWithGestureRecognizer:),
+        @selector(revealController:tapGestureRecognizerShouldRecognizeSimultaneouslyWithGestureRecognizer:),
+        @selector(revealControllerPanGestureBegan:),
+        @selector(revealControllerPanGestureEnded:),
+        @selector(revealController:panGestureBeganFromLocation:progress:overProgress:),
+        @selector(revealController:panGestureMovedToLocation:progress:overProgress:),
+        @selector(revealController:panGestureEndedToLocation:progress:overProgress:),
+        @selector(revealController:panGestureBeganFromLocation:progress:),
+        @selector(revealController:panGestureMovedToLocation:progress:),
+        @selector(revealController:panGestureEndedToLocation:progress:),
+        @selector(revealController:willAddViewController:forOperation:animated:),
+        @selector(revealController:didAddViewController:forOperation:animated:),
+        @selector(revealController:animationControllerForOperation:fromViewController:toViewController:),
+        @selector(revealController:didCollectFrameStats:duringGesture:),
+        @selector(revealController:didRetainViewCount:estimatedBytes:),
+        @selector(revealController:animationMovedToLocation:progress:overProgress:),
+        @selector(revealController:movedToDetentProgress:),
+    };
+    
+    _delegateCapabilities = 0;
+    for ( NSUInteger i=0 ; i<sizeof(selectors)/sizeof(selectors[0]) ; i++ )
+        if ( [delegate respondsToSelector:selectors[i]] ) _delegateCapabilities |= (SWRevealDelegateCapabilities)1 << i;
+}
+
+
+#pragma mark - Provided acction methods
+
+- (IBAction)revealToggle:(id)sender
+{    
+    [self revealToggleAnimated:YES];
+}
+
+
+- (IBAction)rightRevealToggle:(id)sender
+{    
+    [self rightRevealToggleAnimated:YES];
+}
+
+
+#pragma mark - Prewarming
+
+- (void)_prewarmContainerForSymetry:(int)symetry
+{
+    if ( symetry > 0 && _rearViewController ) [_contentView loadRearView];
+    if ( symetry < 0 && _rightViewController ) [_contentView loadRightView];
+    [_contentView invalidateRearFrames];
+}
+
+
+// Loads and lays out the rear (symetry > 0) or right (symetry < 0) controller view, unless it is already deployed
+- (void)_prewarmControllerViewForSymetry:(int)symetry
+{
+    UIViewController *controller = symetry > 0 ? _rearViewController : _rightViewController;
+    UIView *container = symetry > 0 ? _contentView.rearView : _contentView.rightView;
+    if ( controller == nil || container == nil )
+        return;
+    
+    UIView *controllerView = controller.view;
+    
+    // the container only has its final frame after a layout pass, otherwise the view is just loaded and laid out when deployed
+    [_contentView layoutIfNeeded];
+    if ( !_contentView.hasLayout || _contentView.disableLayout || CGRectIsEmpty( container.bounds ) )
+        return;
+    
+    if ( controllerView.superview == nil )
+    {
+        controllerView.frame = container.bounds;
+        [controllerView layoutIfNeeded];
+    }
+}
+
+
+#pragma mark - UserInteractionEnabling
+
+// disable userInteraction on the entire control
+- (void)_disableUserInteraction
+{
+    [_contentView setUserInteractionEnabled:NO];
+    [_contentView setDisableLayout:YES];
+}
+
+// restore userInteraction on the control
+- (void)_restoreUserInteraction
+{
+    // we use the stored userInteraction state just in case a developer decided
+    // to have our view interaction disabled beforehand
+    [_contentView setUserInteractionEnabled:_userInteractionStore];
+    [_contentView setDisableLayout:NO];
+}
+
+
+#pragma mark - PanGesture progress notification
+
+- (void)_notifyPanGestureBegan
+{
+    [self _pushProgressPhase:SWRevealProgressPhaseGestureBegan];
+    
+    if ( _delegateCapabilities & SWRevealDelegatePanGestureBegan )
+        [_delegate revealControllerPanGestureBegan:self];
+    
+    CGFloat xLocation, dragProgress, overProgress;
+    [self _getDragLocation:&xLocation progress:&dragProgress overdrawProgress:&overProgress];
+    
+    if ( _delegateCapabilities & SWRevealDelegatePanBeganFromLocation )
+        [_delegate revealController:self panGestureBeganFromLocation:xLocation progress:dragProgress overProgress:overProgress];
+    
+    else if ( _delegateCapabilities & SWRevealDelegatePanBeganFromLocationDeprecated )
+        [_delegate revealController:self panGestureBeganFromLocation:xLocation progress:dragProgress];
+}
+
+- (void)_notifyPanGestureMoved
+{
+    // the stream gets every move, coalesced or not
+    [self _pushProgressPhase:SWRevealProgressPhaseGestureMoved];
+    
+    SWRevealDelegateCapabilities movedCapabilities = SWRevealDelegatePanMovedToLocation|SWRevealDelegatePanMovedToLocationDeprecated|
+        SWRevealDelegateMovedToDetentProgress;
+    if ( !(_delegateCapabilities & movedCapabilities) )
+        return;
+    
+    // coalesced moves are delivered once per display frame with the latest values
+    if ( _coalescesPanGestureMoves )
+    {
+        if ( _panMovedLink == nil )
+        {
+            _panMovedLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(_panMovedLinkFired:)];
+            [_panMovedLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+        }
+        _panMovedPending = YES;
+        return;
+    }
+    
+    [self _deliverPanGestureMoved];
+}
+
+
+- (void)_panMovedLinkFired:(CADisplayLink *)link
+{
+    if ( _panMovedPending )
+        [self _deliverPanGestureMoved];
+}
+
+
+// Delivers a pending coalesced move and stops the display link
+- (void)_flushPanGestureMoved
+{
+    if ( _panMovedPending )
+        [self _deliverPanGestureMoved];
+    
+    [_panMovedLink invalidate];
+    _panMovedLink = nil;
+}
+
+
+- (void)_deliverPanGestureMoved
+{
+    _panMovedPending = NO;
+    
+    CGFloat xLocation, dragProgress, overProgress;
+    [self _getDragLocation:&xLocation progress:&dragProgress overdrawProgress:&overProgress];
+    
+    if ( _delegateCapabilities & SWRevealDelegatePanMovedToLocation )
+        [_delegate revealController:self panGestureMovedToLocation:xLocation progress:dragProgress overProgress:overProgress];
+    
+    else if ( _delegateCapabilities & SWRevealDelegatePanMovedToLocationDeprecated )
+        [_delegate revealController:self panGestureMovedToLocation:xLocation progress:dragProgress];
+    
+    [self _notifyDetentProgress];
+}
+
+- (void)_notifyPanGestureEnded
+{
+    [self _flushPanGestureMoved];
+    [self _pushProgressPhase:SWRevealProgressPhaseGestureEnded];
+    
+    CGFloat xLocation, dragProgress, overProgress;
+    [self _getDragLocation:&xLocation progress:&dragProgress overdrawProgress:&overProgress];
+    
+    if ( _delegateCapabilities & SWRevealDelegatePanEndedToLocation )
+        [_delegate revealController:self panGestureEndedToLocation:xLocation progress:dragProgress overProgress:overProgress];
+    
+    else if ( _delegateCapabilities & SWRevealDelegatePanEndedToLocationDeprecated )
+        [_delegate revealController:self panGestureEndedToLocation:xLocation progress:dragProgress];
+    
+    if ( _delegateCapabilities & SWRevealDelegatePanGestureEnded )
+        [_delegate revealControllerPanGestureEnded:self];
+}
+
+
+#pragma mark - Symetry
+
+// Returns the content view metrics, or if the view is not loaded yet, metrics resolved from the properties into 'fallback'
+- (const SWRevealMetrics*)_metricsWithFallback:(SWRevealMetrics*)fallback
+{
+    if ( _contentView != nil )
+        return [_contentView metrics];
+    
+    NSInteger sizeClass = 0;
+    if ( [self respondsToSelector:@selector(traitCollection)] )
+        sizeClass = self.traitCollection.horizontalSizeClass;
+    
+    SWRevealWidthProfile profile;
+    [self _getWidthProfile:&profile forHorizontalSizeClass:sizeClass];
+    memset( fallback, 0, sizeof *fallback );
+    SWRevealMetricsResolveWidths( fallback, &profile, 0.0, 0.0 );
+    return fallback;
+}
+
+- (void)_getRevealWidth:(CGFloat*)pRevealWidth revealOverDraw:(CGFloat*)pRevealOverdraw forSymetry:(int)symetry
+{
+    SWRevealMetrics fallback;
+    const SWRevealMetrics *metrics = [self _metricsWithFallback:&fallback];
+    if ( symetry < 0 ) *pRevealWidth = metrics->rightRevealWidth, *pRevealOverdraw = metrics->rightRevealOverdraw;
+    else *pRevealWidth = metrics->rearRevealWidth, *pRevealOverdraw = metrics->rearRevealOverdraw;
+}
+
+- (void)_getBounceBack:(BOOL*)pBounceBack pStableDrag:(BOOL*)pStableDrag forSymetry:(int)symetry
+{
+    if ( symetry < 0 ) *pBounceBack = _bounceBackOnLeftOverdraw, *pStableDrag = _stableDragOnLeftOverdraw;
+    else *pBounceBack = _bounceBackOnOverdraw, *pStableDrag = _stableDragOnOverdraw;
+}
+
+static double dragResistanceBlockFunction( double overshoot, void *context )
+{
+    CGFloat (^block)(CGFloat) = (__bridge CGFloat (^)(CGFloat))context;
+    return block( overshoot );
+}
+
+- (void)_getWidthProfile:(SWRevealWidthProfile*)profile forHorizontalSizeClass:(NSInteger)sizeClass
+{
+    if ( sizeClass > 0 && sizeClass < 3 && _sizeClassWidthProfileSet[sizeClass] )
+    {
+        *profile = _sizeClassWidthProfiles[sizeClass];
+        return;
+    }
+    
+    profile->rearRevealWidth = _rearViewRevealWidth;
+    profile->rearRevealOverdraw = _rearViewRevealOverdraw;
+    profile->rightRevealWidth = _rightViewRevealWidth;
+    profile->rightRevealOverdraw = _rightViewRevealOverdraw;
+}
+
+- (void)_getDragResistanceCurve:(SWRevealResistanceCurve*)curve
+{
+    curve->type = (SWRevealResistanceCurveType)_dragResistanceType;
+    curve->parameter = 0.0;
+    curve->function = _dragResistanceBlock ? dragResistanceBlockFunction : NULL;
+    curve->context = (__bridge void*)_dragResistanceBlock;
+}
+
+
+#pragma mark Detents
+
+- (void)_setDetentOffsets:(NSArray *)offsets forSymetry:(int)symetry
+{
+    SWRevealDetentSide *side = &_detents.sides[symetry<0 ? 0 : 1];
+    side->count = 0;
+    
+    // no offsets means no stops at all, not just the closed one
+    if ( offsets.count > 0 )
+    {
+        double values[SWRevealDetentCapacity];
+        NSUInteger count = MIN( offsets.count, (NSUInteger)SWRevealDetentCapacity );
+        for ( NSUInteger i=0 ; i<count ; i++ )
+            values[i] = [offsets[i] doubleValue];
+    
+        int result = SWRevealDetentSideInit( side, values, (unsigned int)count, 0.5 );
+        NSAssert( result == 0, @"SWRevealViewController: detents must be at most %d ascending positive offsets", SWRevealDetentCapacity-1 );
+        (void)result;
+    }
+    
+    // the front view may rest at a stop that no longer exists
+    if ( _frontViewDetent*symetry > 0 )
+    {
+        NSInteger last = side->count > 0 ? side->count-1 : 0;
+        [self _setFrontViewDetent:MIN( _frontViewDetent*symetry, last )*symetry];
+        [_contentView setNeedsLayout];
+    }
+}
+
+// Fills the stops in use, sides with no stops get the preset stops of the default positions
+- (void)_getDetents:(SWRevealDetents*)detents
+{
+    *detents = _detents;
+    for ( int i=0 ; i<2 ; i++ )
+    {
+        if ( detents->sides[i].count > 0 )
+            continue;
+        
+        CGFloat revealWidth, revealOverdraw;
+        [self _getRevealWidth:&revealWidth revealOverDraw:&revealOverdraw forSymetry:i==0 ? -1 : 1];
+        SWRevealDetentSideInitWithRevealWidth( &detents->sides[i], revealWidth, revealOverdraw );
+    }
+}
+
+- (void)_notifyDetentProgress
+{
+    if ( !(_delegateCapabilities & SWRevealDelegateMovedToDetentProgress) )
+        return;
+    
+    [_delegate revealController:self movedToDetentProgress:[self frontViewDetentProgress]];
+}
+
+- (void)_setFrontViewDetent:(NSInteger)detent
+{
+    if ( detent == _frontViewDetent )
+        return;
+    
+    _frontViewDetent = detent;
+    [_contentView invalidateLocation];
+}
+
+- (BOOL)_getDetentLocation:(CGFloat*)pLocation forPosition:(FrontViewPosition)position
+{
+    if ( (_frontViewDetent > 0 && position == FrontViewPositionRight) || (_frontViewDetent < 0 && position == FrontViewPositionLeftSide) )
+    {
+        *pLocation = SWRevealDetentsLocation( &_detents, (int)_frontViewDetent );
+        return YES;
+    }
+    return NO;
+}
+
+- (void)_getDragLocationx:(CGFloat*)xLocation progress:(CGFloat*)progress
+{
+    UIView *frontView = _contentView.frontView;
+    *xLocation = frontView.frame.origin.x;
+
+    int symetry = *xLocation<0 ? -1 : 1;
+    
+    CGFloat xWidth, xOverWidth;
+    [self _getRevealWidth:&xWidth revealOverDraw:&xOverWidth forSymetry:symetry];
+    
+    *progress = *xLocation/xWidth * symetry;
+}
+
+- (void)_getDragLocation:(CGFloat*)xLocation progress:(CGFloat*)progress overdrawProgress:(CGFloat*)overProgress
+{
+    UIView *frontView = _contentView.frontView;
+    *xLocation = frontView.frame.origin.x;
+    [self _getProgress:progress overdrawProgress:overProgress forLocation:*xLocation];
+}
+
+- (void)_getProgress:(CGFloat*)progress overdrawProgress:(CGFloat*)overProgress forLocation:(CGFloat)xLocation
+{
+    int symetry = xLocation<0 ? -1 : 1;
+    
+    CGFloat xWidth, xOverWidth;
+    [self _getRevealWidth:&xWidth revealOverDraw:&xOverWidth forSymetry:symetry];
+    
+    *progress = xLocation*symetry/xWidth;
+    *overProgress = (xLocation*symetry-xWidth)/xOverWidth;
+}
+
+
+#pragma mark Progress stream
+
+- (void)_pushProgressPhase:(SWRevealProgressPhase)phase
 {
-    _clipsViewsToBounds = clipsViewsToBounds;
-    [_contentView setClipsToBounds:clipsViewsToBounds];
+    if ( _progressStream == NULL )
+        return;
+    
+    [self _pushProgressPhase:phase forLocation:_contentView.frontView.frame.origin.x];
 }
 
 
-
-#pragma mark - Provided acction methods
-
-- (IBAction)revealToggle:(id)sender
-{    
-    [self revealToggleAnimated:YES];
+- (void)_pushProgressPhase:(SWRevealProgressPhase)phase forLocation:(CGFloat)xLocation
+{
+    if ( _progressStream == NULL )
+        return;
+    
+    CGFloat progress, overProgress;
+    [self _getProgress:&progress overdrawProgress:&overProgress forLocation:xLocation];
+    
+    SWRevealProgressRecord record = { CACurrentMediaTime(), xLocation, progress, overProgress, phase, 0 };
+    SWRevealProgressStreamPush( _progressStream, &record );
 }
 
 
-- (IBAction)rightRevealToggle:(id)sender
-{    
-    [self rightRevealToggleAnimated:YES];
-}
+#pragma mark Transform tracks
 
+static const unsigned int SWRevealTrackTransformMask = (1u << SWRevealTrackPropertyTranslationX) |
+    (1u << SWRevealTrackPropertyTranslationY) | (1u << SWRevealTrackPropertyScale);
 
-#pragma mark - UserInteractionEnabling
+static const unsigned int SWRevealTrackLayerMask = (1u << SWRevealTrackPropertyAlpha) | (1u << SWRevealTrackPropertyCornerRadius);
 
-// disable userInteraction on the entire control
-- (void)_disableUserInteraction
+static void SWSaveLayerValues( CALayer *layer, SWRevealSavedLayerValues *saved )
 {
-    [_contentView setUserInteractionEnabled:NO];
-    [_contentView setDisableLayout:YES];
+    saved->opacity = layer.opacity;
+    saved->cornerRadius = layer.cornerRadius;
+    saved->masksToBounds = layer.masksToBounds;
 }
 
-// restore userInteraction on the control
-- (void)_restoreUserInteraction
+static void SWRestoreLayerValues( CALayer *layer, const SWRevealSavedLayerValues *saved )
 {
-    // we use the stored userInteraction state just in case a developer decided
-    // to have our view interaction disabled beforehand
-    [_contentView setUserInteractionEnabled:_userInteractionStore];
-    [_contentView setDisableLayout:NO];
+    layer.opacity = saved->opacity;
+    layer.cornerRadius = saved->cornerRadius;
+    layer.masksToBounds = saved->masksToBounds;
 }
 
-
-#pragma mark - PanGesture progress notification
-
-- (void)_notifyPanGestureBegan
+// Writes the values of the properties in 'mask'. Translation and scale go to the container sublayer transform, so that frames
+// and autoresizing of the controller view stay valid. Properties in 'mask' with no track get back their identity or saved values
+static void SWApplyLayerValues( CALayer *container, CALayer *layer, const SWRevealLayerValues *layerValues, unsigned int mask,
+    const SWRevealSavedLayerValues *saved )
 {
-    if ( [_delegate respondsToSelector:@selector(revealControllerPanGestureBegan:)] )
-        [_delegate revealControllerPanGestureBegan:self];
+    const double *values = layerValues->values;
+    unsigned int tracked = layerValues->mask;
     
-    CGFloat xLocation, dragProgress, overProgress;
-    [self _getDragLocation:&xLocation progress:&dragProgress overdrawProgress:&overProgress];
+    if ( mask & SWRevealTrackTransformMask )
+    {
+        CGFloat scale = values[SWRevealTrackPropertyScale];
+        CATransform3D transform = CATransform3DMakeTranslation( values[SWRevealTrackPropertyTranslationX], values[SWRevealTrackPropertyTranslationY], 0 );
+        container.sublayerTransform = CATransform3DScale( transform, scale, scale, 1 );
+    }
     
-    if ( [_delegate respondsToSelector:@selector(revealController:panGestureBeganFromLocation:progress:overProgress:)] )
-        [_delegate revealController:self panGestureBeganFromLocation:xLocation progress:dragProgress overProgress:overProgress];
+    if ( layer == nil )
+        return;
     
-    else if ( [_delegate respondsToSelector:@selector(revealController:panGestureBeganFromLocation:progress:)] )
-        [_delegate revealController:self panGestureBeganFromLocation:xLocation progress:dragProgress];
+    if ( mask & (1u << SWRevealTrackPropertyAlpha) )
+        layer.opacity = tracked & (1u << SWRevealTrackPropertyAlpha) ? values[SWRevealTrackPropertyAlpha] : saved->opacity;
+    
+    if ( mask & (1u << SWRevealTrackPropertyCornerRadius) )
+    {
+        if ( tracked & (1u << SWRevealTrackPropertyCornerRadius) )
+        {
+            CGFloat cornerRadius = values[SWRevealTrackPropertyCornerRadius];
+            layer.cornerRadius = cornerRadius;
+            layer.masksToBounds = saved->masksToBounds || cornerRadius > 0;
+        }
+        else
+        {
+            layer.cornerRadius = saved->cornerRadius;
+            layer.masksToBounds = saved->masksToBounds;
+        }
+    }
 }
 
-- (void)_notifyPanGestureMoved
+
+- (void)_applyTransformTracks
 {
-    CGFloat xLocation, dragProgress, overProgress;
-    [self _getDragLocation:&xLocation progress:&dragProgress overdrawProgress:&overProgress];
-    
-    if ( [_delegate respondsToSelector:@selector(revealController:panGestureMovedToLocation:progress:overProgress:)] )
-        [_delegate revealController:self panGestureMovedToLocation:xLocation progress:dragProgress overProgress:overProgress];
+    if ( _contentView == nil )
+        return;
     
-    else if ( [_delegate respondsToSelector:@selector(revealController:panGestureMovedToLocation:progress:)] )
-        [_delegate revealController:self panGestureMovedToLocation:xLocation progress:dragProgress];
+    [self _applyTransformTracksForLocation:_contentView.frontView.frame.origin.x];
 }
 
-- (void)_notifyPanGestureEnded
+
+// Evaluates all tracks for a front view location and writes the results to the child controller view layers. Called on
+// every layout, when laid out in an animation block the layer changes are animated along
+- (void)_applyTransformTracksForLocation:(CGFloat)xLocation
 {
-    CGFloat xLocation, dragProgress, overProgress;
-    [self _getDragLocation:&xLocation progress:&dragProgress overdrawProgress:&overProgress];
+    unsigned int appliedMask = _transformTrackMasks[0] | _transformTrackMasks[1] | _transformTrackMasks[2];
+    if ( _transformTracks.trackCount == 0 && appliedMask == 0 )
+        return;
     
-    if ( [_delegate respondsToSelector:@selector(revealController:panGestureEndedToLocation:progress:overProgress:)] )
-        [_delegate revealController:self panGestureEndedToLocation:xLocation progress:dragProgress overProgress:overProgress];
+    CGFloat progress, overProgress;
+    [self _getProgress:&progress overdrawProgress:&overProgress forLocation:xLocation];
     
-    else if ( [_delegate respondsToSelector:@selector(revealController:panGestureEndedToLocation:progress:)] )
-        [_delegate revealController:self panGestureEndedToLocation:xLocation progress:dragProgress];
+    SWRevealLayerValues layers[SWRevealTrackLayerCount];
+    SWRevealTrackSetEvaluate( &_transformTracks, xLocation<0 ? -progress : progress, layers );
     
-    if ( [_delegate respondsToSelector:@selector(revealControllerPanGestureEnded:)] )
-        [_delegate revealControllerPanGestureEnded:self];
+    UIViewController *controllers[SWRevealTrackLayerCount] = { _frontViewController, _rearViewController, _rightViewController };
+    UIView *containers[SWRevealTrackLayerCount] = { _contentView.frontView, _contentView.rearView, _contentView.rightView };
+    for ( NSInteger i=0 ; i<SWRevealTrackLayerCount ; i++ )
+    {
+        // properties whose track was removed are written once more, with their identity or saved value
+        unsigned int mask = layers[i].mask | _transformTrackMasks[i];
+        _transformTrackMasks[i] = layers[i].mask;
+        if ( mask == 0 || containers[i] == nil )
+            continue;
+        
+        // the app values of a controller view layer are saved before the tracks first write to it
+        BOOL deployed = [controllers[i] isViewLoaded] && controllers[i].view.superview == containers[i];
+        CALayer *layer = deployed ? controllers[i].view.layer : nil;
+        if ( layer != _transformTrackLayers[i] )
+        {
+            [self _restoreTransformTrackLayerAtIndex:i];
+            if ( layer && (layers[i].mask & SWRevealTrackLayerMask) )
+            {
+                SWSaveLayerValues( layer, &_transformTrackSavedValues[i] );
+                _transformTrackLayers[i] = layer;
+            }
+        }
+        
+        SWApplyLayerValues( containers[i].layer, _transformTrackLayers[i], &layers[i], mask, &_transformTrackSavedValues[i] );
+        if ( !(layers[i].mask & SWRevealTrackLayerMask) )
+            _transformTrackLayers[i] = nil;
+    }
 }
 
 
-#pragma mark - Symetry
-
-- (void)_getRevealWidth:(CGFloat*)pRevealWidth revealOverDraw:(CGFloat*)pRevealOverdraw forSymetry:(int)symetry
+- (void)_restoreTransformTrackLayerAtIndex:(NSInteger)index
 {
-    if ( symetry < 0 ) *pRevealWidth = _rightViewRevealWidth, *pRevealOverdraw = _rightViewRevealOverdraw;
-    else *pRevealWidth = _rearViewRevealWidth, *pRevealOverdraw = _rearViewRevealOverdraw;
+    if ( _transformTrackLayers[index] == nil )
+        return;
     
-    if (*pRevealWidth < 0) *pRevealWidth = _contentView.bounds.size.width + *pRevealWidth;
+    SWRestoreLayerValues( _transformTrackLayers[index], &_transformTrackSavedValues[index] );
+    _transformTrackLayers[index] = nil;
 }
 
-- (void)_getBounceBack:(BOOL*)pBounceBack pStableDrag:(BOOL*)pStableDrag forSymetry:(int)symetry
-{
-    if ( symetry < 0 ) *pBounceBack = _bounceBackOnLeftOverdraw, *pStableDrag = _stableDragOnLeftOverdraw;
-    else *pBounceBack = _bounceBackOnOverdraw, *pStableDrag = _stableDragOnOverdraw;
-}
 
-- (void)_getAdjustedFrontViewPosition:(FrontViewPosition*)frontViewPosition forSymetry:(int)symetry
+// Gives back its own alpha, corner radius and masksToBounds to the view of a controller that is removed from its container
+- (void)_restoreTransformTrackLayerForController:(UIViewController*)controller
 {
-    if ( symetry < 0 ) *frontViewPosition = FrontViewPositionLeft + symetry*(*frontViewPosition-FrontViewPositionLeft);
+    if ( ![controller isViewLoaded] )
+        return;
+    
+    CALayer *layer = controller.view.layer;
+    for ( NSInteger i=0 ; i<SWRevealTrackLayerCount ; i++ )
+    {
+        if ( _transformTrackLayers[i] == layer )
+            [self _restoreTransformTrackLayerAtIndex:i];
+    }
 }
 
-- (void)_getDragLocationx:(CGFloat*)xLocation progress:(CGFloat*)progress
-{
-    UIView *frontView = _contentView.frontView;
-    *xLocation = frontView.frame.origin.x;
 
-    int symetry = *xLocation<0 ? -1 : 1;
-    
-    CGFloat xWidth = symetry < 0 ? _rightViewRevealWidth : _rearViewRevealWidth;
-    if ( xWidth < 0 ) xWidth = _contentView.bounds.size.width + xWidth;
-    
-    *progress = *xLocation/xWidth * symetry;
-}
+#pragma mark - Deferred command execution queue
 
-- (void)_getDragLocation:(CGFloat*)xLocation progress:(CGFloat*)progress overdrawProgress:(CGFloat*)overProgress
+// Defers the execution of the passed in command until a paired _dequeue call is received,
+// or executes the command right away if no pending requests are present. Pending commands made obsolete
+// by this one are coalesced, see SWRevealCommandQueue.h
+- (void)_enqueueCommand:(SWRevealCommand)command
 {
-    UIView *frontView = _contentView.frontView;
-    *xLocation = frontView.frame.origin.x;
-
-    int symetry = *xLocation<0 ? -1 : 1;
+    // the queue releases the object of a command it can not take, we keep it for the fallbacks below
+    id object = (__bridge id)command.object;
     
-    CGFloat xWidth = symetry < 0 ? _rightViewRevealWidth : _rearViewRevealWidth;
-    CGFloat xOverWidth = symetry < 0 ? _rightViewRevealOverdraw : _rearViewRevealOverdraw;
+    SWRevealCommandEnqueueResult result = SWRevealCommandQueueEnqueue( &_commandQueue, &command );
+    if ( result != SWRevealCommandOverflow )
+    {
+        if ( result == SWRevealCommandExecuteNow )
+            [self _executeCommand:*SWRevealCommandQueueFront( &_commandQueue )];
+        return;
+    }
     
-    if ( xWidth < 0 ) xWidth = _contentView.bounds.size.width + xWidth;
+    // the queue could not grow. With nothing in progress the command is performed right away, the paired _dequeue
+    // finds the queue empty and does nothing
+    if ( SWRevealCommandQueueFront( &_commandQueue ) == NULL )
+    {
+        NSLog( @"SWRevealViewController: could not allocate the command queue, performing the command right away" );
+        [self _executeCommand:command];
+        return;
+    }
     
-    *progress = *xLocation*symetry/xWidth;
-    *overProgress = (*xLocation*symetry-xWidth)/xOverWidth;
+    // otherwise the command supersedes the pending ones, which makes room for it unless they all belong to the running group
+    NSLog( @"SWRevealViewController: could not allocate the pending command, cancelling the pending ones" );
+    SWRevealCommandQueueCancelPending( &_commandQueue );
+    command.object = object ? (void*)CFBridgingRetain(object) : NULL;
+    if ( SWRevealCommandQueueEnqueue( &_commandQueue, &command ) == SWRevealCommandOverflow )
+        NSLog( @"SWRevealViewController: could not allocate the pending command, the command was dropped" );
 }
 
+// Removes the command being executed from the queue and executes the following one if any.
+// Calls to this method must be paired with calls to _enqueueCommand, particularly it is called
+// by the primitive methods executing a command to remove it when done with animations.
+- (void)_dequeue
+{
+    const SWRevealCommand *next = SWRevealCommandQueueDequeue( &_commandQueue );
+    if ( next )
+        [self _executeCommand:*next];
+}
 
-#pragma mark - Deferred block execution queue
-
-// Define a convenience macro to enqueue single statements
-#define _enqueue(code) [self _enqueueBlock:^{code;}];
-
-// Defers the execution of the passed in block until a paired _dequeue call is received,
-// or executes the block right away if no pending requests are present.
-- (void)_enqueueBlock:(void (^)(void))block
+// Executes the passed in command, the command is passed by value because executing it may dequeue it
+- (void)_executeCommand:(SWRevealCommand)command
 {
-    [_animationQueue insertObject:block atIndex:0];
-    if ( _animationQueue.count == 1)
+    switch ( command.type )
     {
-        block();
+        case SWRevealCommandSetPosition:
+            [self _setFrontViewDetent:command.detent];
+            [self _setFrontViewPosition:command.position withDuration:command.duration];
+            break;
+            
+        case SWRevealCommandTransition:
+        {
+            UIViewController *controller = (__bridge UIViewController*)command.object;
+            [self _performTransitionOperation:command.operation withViewController:controller animated:command.animated];
+            break;
+        }
+            
+        case SWRevealCommandGesture:
+            // nothing to do, the gesture will dequeue it when it ends
+            break;
+            
+        case SWRevealCommandBatch:
+            [self _performBatch:(__bridge SWRevealTransaction*)command.object];
+            break;
     }
 }
 
-// Removes the top most block in the queue and executes the following one if any.
-// Calls to this method must be paired with calls to _enqueueBlock, particularly it may be called
-// from within a block passed to _enqueueBlock to remove itself when done with animations.  
-- (void)_dequeue
+- (void)_enqueueSetFrontViewPosition:(FrontViewPosition)frontViewPosition withDuration:(NSTimeInterval)duration group:(unsigned int)group
 {
-    [_animationQueue removeLastObject];
+    SWRevealCommand command = { SWRevealCommandSetPosition, group, (int)frontViewPosition, duration, 0, NO, NULL, 0 };
+    [self _enqueueCommand:command];
+}
 
-    if ( _animationQueue.count > 0 )
-    {
-        void (^block)(void) = [_animationQueue lastObject];
-        block();
-    }
+- (void)_enqueueTransitionOperation:(SWRevealControllerOperation)operation withViewController:(UIViewController *)newViewController
+    animated:(BOOL)animated group:(unsigned int)group
+{
+    void *object = newViewController ? (void*)CFBridgingRetain(newViewController) : NULL;
+    SWRevealCommand command = { SWRevealCommandTransition, group, 0, 0.0, operation, animated, object, 0 };
+    [self _enqueueCommand:command];
 }
 
 
@@ -1105,31 +3132,81 @@ const int FrontViewPositionNone = 0xff;
 
 - (BOOL)gestureRecognizerShouldBegin:(UIGestureRecognizer *)recognizer
 {
-    // only allow gesture if no previous request is in process
-    if ( _animationQueue.count == 0 )
+    if ( recognizer == _panGestureRecognizer )
     {
-        if ( recognizer == _panGestureRecognizer )
-            return [self _panGestureShouldBegin];
+        if ( _routesNestedPanGestures )
+            return [[SWRevealPanArbiter sharedArbiter] shouldBeginForController:self];
         
-        if ( recognizer == _tapGestureRecognizer )
-            return [self _tapGestureShouldBegin];
+        return [self _panGestureCanBegin];
     }
+    
+    // only allow gesture if no previous request is in process
+    if ( recognizer == _tapGestureRecognizer && SWRevealCommandQueueCount( &_commandQueue ) == 0 )
+        return [self _tapGestureShouldBegin];
+
+    return NO;
+}
 
+
+- (BOOL)_panGestureCanBegin
+{
+    // only allow gesture if no previous request is in process, or if the pan gesture is grabbing an interrupted animation
+    if ( SWRevealCommandQueueCount( &_commandQueue ) == 0 || _panInterruptPending )
+        return [self _panGestureShouldBegin];
+    
     return NO;
 }
 
 
+- (BOOL)gestureRecognizer:(UIGestureRecognizer *)recognizer shouldReceiveTouch:(UITouch *)touch
+{
+    if ( recognizer == _panGestureRecognizer && _routesNestedPanGestures )
+        [[SWRevealPanArbiter sharedArbiter] addCandidate:self forTouch:touch];
+    
+    // a touch down on a moving front view stops it, the pan gesture will then continue from there. Pending commands are kept
+    // until the pan actually begins, so they still run if the touch turns out to be a tap or the recognizer fails
+    if ( recognizer == _panGestureRecognizer && _interruptibleAnimations && !_panInterruptPending )
+    {
+        CGFloat xLocation = [touch locationInView:recognizer.view].x;
+        if ( [self _draggableBorderAllowsLocation:xLocation] )
+            [self _interruptFrontViewAnimation];
+    }
+    
+    return YES;
+}
+
+
+- (void)_panGestureRecognizerDidReset:(UIPanGestureRecognizer *)recognizer
+{
+    if ( _routesNestedPanGestures )
+        [[SWRevealPanArbiter sharedArbiter] removeCandidate:self];
+    
+    // the touch that interrupted an animation did not turn into a pan, so we resume the animation to its target. The
+    // interrupted command is still the one being executed, it is dequeued on completion and pending commands follow. The
+    // deployment was not changed, its held completion runs when the resumed animation ends
+    if ( _panInterruptPending )
+    {
+        _panInterruptPending = NO;
+        void (^deploymentCompletion)(void) = _interruptedDeploymentCompletion;
+        _interruptedDeploymentCompletion = nil;
+        [_contentView setDisableLayout:NO];
+        [self _setFrontViewPosition:_frontViewPosition withDuration:_toggleAnimationDuration velocity:0.0f
+            alongsideAnimations:nil completion:deploymentCompletion];
+    }
+}
+
+
 - (BOOL)gestureRecognizer:(UIGestureRecognizer *)gestureRecognizer shouldRecognizeSimultaneouslyWithGestureRecognizer:(UIGestureRecognizer *)otherGestureRecognizer
 {
     if ( gestureRecognizer == _panGestureRecognizer )
     {
-        if ( [_delegate respondsToSelector:@selector(revealController:panGestureRecognizerShouldRecognizeSimultaneouslyWithGestureRecognizer:)] )
+        if ( _delegateCapabilities & SWRevealDelegatePanGestureSimultaneous )
             if ( [_delegate revealController:self panGestureRecognizerShouldRecognizeSimultaneouslyWithGestureRecognizer:otherGestureRecognizer] != NO )
                 return YES;
     }
     if ( gestureRecognizer == _tapGestureRecognizer )
     {
-        if ( [_delegate respondsToSelector:@selector(revealController:tapGestureRecognizerShouldRecognizeSimultaneouslyWithGestureRecognizer:)] )
+        if ( _delegateCapabilities & SWRevealDelegateTapGestureSimultaneous )
             if ( [_delegate revealController:self tapGestureRecognizerShouldRecognizeSimultaneouslyWithGestureRecognizer:otherGestureRecognizer] != NO )
                 return YES;
     }
@@ -1145,9 +3222,10 @@ const int FrontViewPositionNone = 0xff;
         _frontViewPosition == FrontViewPositionLeftSideMostRemoved )
             return NO;
     
-    // forbid gesture if the following delegate is implemented and returns NO
-    if ( [_delegate respondsToSelector:@selector(revealControllerTapGestureShouldBegin:)] )
-        if ( [_delegate revealControllerTapGestureShouldBegin:self] == NO )
+    // forbid gesture if the following delegate is implemented and returns NO, (a released delegate returns nothing)
+    id<SWRevealViewControllerDelegate> delegate = _delegate;
+    if ( delegate && (_delegateCapabilities & SWRevealDelegateTapGestureShouldBegin) )
+        if ( [delegate revealControllerTapGestureShouldBegin:self] == NO )
             return NO;
     
     return YES;
@@ -1163,19 +3241,19 @@ const int FrontViewPositionNone = 0xff;
 //    if ( fabs(translation.y/translation.x) > 1 )
 //        return NO;
 
-    // forbid gesture if the following delegate is implemented and returns NO
-    if ( [_delegate respondsToSelector:@selector(revealControllerPanGestureShouldBegin:)] )
-        if ( [_delegate revealControllerPanGestureShouldBegin:self] == NO )
+    // forbid gesture outside the declared zones, this needs no delegate call
+    CGPoint location = [_panGestureRecognizer locationInView:recognizerView];
+    if ( ![self _panGestureZonesAllowLocation:location] )
+        return NO;
+
+    // forbid gesture if the following delegate is implemented and returns NO, (a released delegate returns nothing)
+    id<SWRevealViewControllerDelegate> delegate = _delegate;
+    if ( delegate && (_delegateCapabilities & SWRevealDelegatePanGestureShouldBegin) )
+        if ( [delegate revealControllerPanGestureShouldBegin:self] == NO )
             return NO;
 
-    CGFloat xLocation = [_panGestureRecognizer locationInView:recognizerView].x;
-    CGFloat width = recognizerView.bounds.size.width;
-    
-    BOOL draggableBorderAllowing = (
-         /*_frontViewPosition != FrontViewPositionLeft ||*/ _draggableBorderWidth == 0.0f ||
-         (_rearViewController && xLocation <= _draggableBorderWidth) ||
-         (_rightViewController && xLocation >= (width - _draggableBorderWidth)) );
-    
+    CGFloat xLocation = location.x;
+    BOOL draggableBorderAllowing = [self _draggableBorderAllowsLocation:xLocation];
     
     BOOL translationForbidding = ( _frontViewPosition == FrontViewPositionLeft &&
         ((_rearViewController == nil && translation.x > 0) || (_rightViewController == nil && translation.x < 0)) );
@@ -1185,6 +3263,39 @@ const int FrontViewPositionNone = 0xff;
 }
 
 
+// Compiles the pan gesture zones for the size of the recognizer view, this does nothing if the size did not change
+- (void)_compilePanGestureZones
+{
+    UIView *recognizerView = _panGestureRecognizer.view;
+    if ( _panGestureZones.count == 0 || recognizerView == nil )
+        return;
+    
+    CGSize size = recognizerView.bounds.size;
+    SWRevealZoneMapCompile( &_panGestureZones, size.width, size.height );
+}
+
+
+- (BOOL)_panGestureZonesAllowLocation:(CGPoint)location
+{
+    if ( _panGestureZones.count == 0 )
+        return YES;
+    
+    // the recognizer view may have been resized without a layout of ours
+    [self _compilePanGestureZones];
+    return SWRevealZoneMapAllows( &_panGestureZones, (SWRevealPosition)_frontViewPosition, location.x, location.y );
+}
+
+
+- (BOOL)_draggableBorderAllowsLocation:(CGFloat)xLocation
+{
+    CGFloat width = _panGestureRecognizer.view.bounds.size.width;
+    
+    return ( /*_frontViewPosition != FrontViewPositionLeft ||*/ _draggableBorderWidth == 0.0f ||
+         (_rearViewController && xLocation <= _draggableBorderWidth) ||
+         (_rightViewController && xLocation >= (width - _draggableBorderWidth)) );
+}
+
+
 #pragma mark - Gesture Based Reveal
 
 - (void)_handleTapGesture:(UITapGestureRecognizer *)recognizer
@@ -1223,14 +3334,38 @@ const int FrontViewPositionNone = 0xff;
 
 - (void)_handleRevealGestureStateBeganWithRecognizer:(UIPanGestureRecognizer *)recognizer
 {
-    // we know that we will not get here unless the animationQueue is empty because the recognizer
-    // delegate prevents it, however we do not want any forthcoming programatic actions to disturb
-    // the gesture, so we just enqueue a dummy block to ensure any programatic acctions will be
-    // scheduled after the gesture is completed
-    [self _enqueueBlock:^{}]; // <-- dummy block
-
-    // we store the initial position and initialize a target position
-    _panInitialFrontPosition = _frontViewPosition;
+    // we know that we will not get here unless the animationQueue is empty or an interrupted animation was
+    // replaced by a gesture command, because the recognizer delegate prevents it. However we do not want any
+    // forthcoming programatic actions to disturb the gesture, so we just enqueue a gesture command to ensure
+    // any programatic acctions will be scheduled after the gesture is completed
+    if ( _panInterruptPending )
+    {
+        // the initial location was already set where the animation was interrupted. The interrupted command is now
+        // replaced by a gesture command, pending position changes are dropped because the position where the gesture
+        // ends supersedes them
+        _panInterruptPending = NO;
+        [self _finishInterruptedDeployment];
+        SWRevealCommand command = { SWRevealCommandGesture, 0, 0, 0.0, 0, NO, NULL, 0 };
+        SWRevealCommandQueueInterrupt( &_commandQueue, &command );
+    }
+    else
+    {
+        SWRevealCommand command = { SWRevealCommandGesture, 0, 0, 0.0, 0, NO, NULL, 0 };
+        [self _enqueueCommand:command];
+        
+        // we store the initial location
+        _panInitialLocation = [_contentView frontLocationForPosition:_frontViewPosition];
+    }
+    
+    // start a new touch history
+    SWRevealFlingPredictorReset( &_flingPredictor );
+    [self _addFlingSampleWithRecognizer:recognizer];
+    [self _recordTracePhase:SWRevealTracePhaseBegan withRecognizer:recognizer];
+    [self _beginFrameStatsDuringGesture:YES];
+    
+    // prewarming gives way to the gesture, whatever is not loaded yet will be loaded as usual
+    [_prewarmScheduler cancel];
+    _prewarmScheduler = nil;
 
     // we disable user interactions on the views, however programatic accions will still be
     // enqueued to be performed after the gesture completes
@@ -1240,12 +3375,92 @@ const int FrontViewPositionNone = 0xff;
 
 
 - (void)_handleRevealGestureStateChangedWithRecognizer:(UIPanGestureRecognizer *)recognizer
+{
+    CFTimeInterval startTime = _frameStatsLink ? CACurrentMediaTime() : 0;
+    
+    CGFloat translation = [recognizer translationInView:_contentView].x;
+    [self _addFlingSampleWithRecognizer:recognizer];
+    [self _recordTracePhase:SWRevealTracePhaseMoved withRecognizer:recognizer];
+    
+    CGFloat xLocation = [self _deployViewsForDragLocation:_panInitialLocation + translation];
+    
+    [_contentView dragFrontViewToXLocation:xLocation];
+    [self _notifyPanGestureMoved];
+    
+    if ( _frameStatsLink )
+        SWRevealFrameStatsAddWork( &_frameStats, CACurrentMediaTime() - startTime );
+}
+
+
+// Returns the time of the touch event that triggered the current recognizer action, in the CACurrentMediaTime time base.
+// Actions may run late in the frame, so timing samples on their arrival would skew the velocity fit
+- (CFTimeInterval)_touchTimestampWithRecognizer:(UIPanGestureRecognizer *)recognizer
+{
+    NSTimeInterval timestamp = 0;
+    if ( [recognizer isKindOfClass:[SWRevealViewControllerPanGestureRecognizer class]] )
+        timestamp = [(SWRevealViewControllerPanGestureRecognizer *)recognizer touchTimestamp];
+    
+    return timestamp > 0 ? timestamp : CACurrentMediaTime();
+}
+
+
+// Adds the current drag location to the touch history
+- (void)_addFlingSampleWithRecognizer:(UIPanGestureRecognizer *)recognizer
 {
     CGFloat translation = [recognizer translationInView:_contentView].x;
+    CFTimeInterval time = [self _touchTimestampWithRecognizer:recognizer];
+    SWRevealFlingPredictorAddSample( &_flingPredictor, time, _panInitialLocation + translation );
+}
+
+
+// Appends a gesture event to the gesture trace if we are recording one, a new gesture is started on the began phase
+- (void)_recordTracePhase:(SWRevealTracePhase)phase withRecognizer:(UIPanGestureRecognizer *)recognizer
+{
+    if ( !_traceRecording )
+        return;
     
-    CGFloat baseLocation = [_contentView frontLocationForPosition:_panInitialFrontPosition];
-    CGFloat xLocation = baseLocation + translation;
+    CFTimeInterval time = [self _touchTimestampWithRecognizer:recognizer];
+    if ( phase == SWRevealTracePhaseBegan )
+    {
+        SWRevealTraceConfig config;
+        [self _getTraceConfig:&config];
+        SWRevealTraceRecorderBeginGesture( &_traceRecorder, &config, time );
+    }
     
+    CGFloat translation = [recognizer translationInView:_contentView].x;
+    CGFloat velocity = [recognizer velocityInView:_contentView].x;
+    SWRevealTraceRecorderAddEvent( &_traceRecorder, phase, time, _panInitialLocation + translation, velocity );
+}
+
+
+- (void)_getTraceConfig:(SWRevealTraceConfig*)config
+{
+    BOOL rearBounceBack, rearStableDrag, rightBounceBack, rightStableDrag;
+    [self _getBounceBack:&rearBounceBack pStableDrag:&rearStableDrag forSymetry:1];
+    [self _getBounceBack:&rightBounceBack pStableDrag:&rightStableDrag forSymetry:-1];
+    
+    SWRevealResistanceCurve curve;
+    [self _getDragResistanceCurve:&curve];
+    
+    [_contentView getGeometryConfig:&config->geometry];
+    config->geometry.frontOffsetY = [_contentView hierarchycalFrontOffset];
+    config->initialPosition = (SWRevealPosition)_frontViewPosition;
+    config->quickFlickVelocity = _quickFlickVelocity;
+    config->rearBounceBack = rearBounceBack;
+    config->rearStableDrag = rearStableDrag;
+    config->rightBounceBack = rightBounceBack;
+    config->rightStableDrag = rightStableDrag;
+    config->hasRear = _rearViewController != nil;
+    config->hasRight = _rightViewController != nil;
+    config->resistanceType = curve.type;
+    config->resistanceParameter = curve.parameter;
+}
+
+
+// Deploys the rear or right view as needed to drag the front view to the given location. Returns the location,
+// clamped to zero if there is no controller to reveal on that side
+- (CGFloat)_deployViewsForDragLocation:(CGFloat)xLocation
+{
     if ( xLocation < 0 )
     {
         if ( _rightViewController == nil ) xLocation = 0;
@@ -1260,8 +3475,54 @@ const int FrontViewPositionNone = 0xff;
         [self _rearViewDeploymentForNewFrontViewPosition:FrontViewPositionRight]();
     }
     
-    [_contentView dragFrontViewToXLocation:xLocation];
-    [self _notifyPanGestureMoved];
+    return xLocation;
+}
+
+
+// Stops a running position animation where the front view is on screen, so that the pan gesture can continue from there.
+// Does nothing if there is no animation or if it can not be interrupted. The queue is left untouched, the interrupted command
+// is replaced by a gesture command only when the pan begins
+- (void)_interruptFrontViewAnimation
+{
+    if ( _runningDeploymentCompletion == nil || !SWRevealCommandQueueCanInterrupt( &_commandQueue ) )
+        return;
+    
+    if ( _frontViewPosition == FrontViewPositionRightMostRemoved || _frontViewPosition == FrontViewPositionLeftSideMostRemoved )
+        return;
+    
+    [_contentView setDisableLayout:YES];
+    [_animationDriver stop];
+    _animationDriver = nil;
+    [_contentView setDrivesLocation:NO];
+    [_springAnimator stopAnimation:YES];  // <-- leaves the views where they are on screen
+    _springAnimator = nil;
+    CGFloat xLocation = [_contentView stopAnimations];
+    [self _endFrameStats];
+    
+    // the completion block of the interrupted animation will be ignored. Its deployment completion is held until we know
+    // whether the touch turns into a pan, so that a tap does not make child controllers disappear and appear again
+    _interruptedDeploymentCompletion = _runningDeploymentCompletion;
+    _runningDeploymentCompletion = nil;
+    _animationSerial += 1;
+    
+    _panInitialLocation = xLocation;
+    [_contentView placeFrontViewAtXLocation:xLocation];
+    _panInterruptPending = YES;
+}
+
+
+// Called when the pan that interrupted an animation begins. The held deployment completion runs now, this also runs its
+// alongside completion and tells the delegate about the position the animation was moving to, then the views are deployed
+// for the drag location
+- (void)_finishInterruptedDeployment
+{
+    void (^deploymentCompletion)(void) = _interruptedDeploymentCompletion;
+    _interruptedDeploymentCompletion = nil;
+    if ( deploymentCompletion )
+        deploymentCompletion();
+    
+    _panInitialLocation = [self _deployViewsForDragLocation:_panInitialLocation];
+    [_contentView placeFrontViewAtXLocation:_panInitialLocation];
 }
 
 
@@ -1270,93 +3531,102 @@ const int FrontViewPositionNone = 0xff;
     UIView *frontView = _contentView.frontView;
     
     CGFloat xLocation = frontView.frame.origin.x;
-    CGFloat velocity = [recognizer velocityInView:_contentView].x;
-    //NSLog( @"Velocity:%1.4f", velocity);
     
-    // depending on position we compute a simetric replacement of widths and positions
-    int symetry = xLocation<0 ? -1 : 1;
-    
-    // simetring computing of widths
-    CGFloat revealWidth ;
-    CGFloat revealOverdraw ;
-    BOOL bounceBack;
-    BOOL stableDrag;
-    
-    [self _getRevealWidth:&revealWidth revealOverDraw:&revealOverdraw forSymetry:symetry];
-    [self _getBounceBack:&bounceBack pStableDrag:&stableDrag forSymetry:symetry];
+    // the release velocity is fitted over the recent touch history, we only use the recognizer velocity if the
+    // history is too short. The resting location of a fling is projected from it
+    double velocity;
+    [self _addFlingSampleWithRecognizer:recognizer];
+    [self _recordTracePhase:SWRevealTracePhaseEnded withRecognizer:recognizer];
+    if ( !SWRevealFlingPredictorGetVelocity( &_flingPredictor, SWRevealFlingDefaultWindow, SWRevealFlingDefaultHalfLife, &velocity ) )
+        velocity = [recognizer velocityInView:_contentView].x;
     
-    // simetric replacement of position
-    xLocation = xLocation * symetry;
+    //NSLog( @"Velocity:%1.4f", velocity);
     
-    // initially we assume drag to left and default duration
-    FrontViewPosition frontViewPosition = FrontViewPositionLeft;
-    NSTimeInterval duration = _toggleAnimationDuration;
-
-    // Velocity driven change:
-    if (ABS(velocity) > _quickFlickVelocity)
+    // the position is decided on the projected resting location, quick flicks also set the duration. Sides with
+    // custom stops snap to the closest one to that location
+    double journey;
+    FrontViewPosition frontViewPosition;
+    const SWRevealDetentSide *side = &_detents.sides[xLocation<0 ? 0 : 1];
+    if ( side->count > 0 )
     {
-        // we may need to set the drag position and to adjust the animation duration
-        CGFloat journey = xLocation;
-        if (velocity*symetry > 0.0f)
-        {
-            frontViewPosition = FrontViewPositionRight;
-            journey = revealWidth - xLocation;
-            if (xLocation > revealWidth)
-            {
-                if (!bounceBack && stableDrag /*&& xPosition > _rearViewRevealWidth+_rearViewRevealOverdraw*0.5f*/)
-                {
-                    frontViewPosition = FrontViewPositionRightMost;
-                    journey = revealWidth+revealOverdraw - xLocation;
-                }
-            }
-        }
-        
-        duration = ABS(journey/velocity);
+        double target;
+        int detent = SWRevealDetentsSnap( &_detents, xLocation, velocity, SWRevealFlingDefaultDecelerationRate, &target );
+        frontViewPosition = detent > 0 ? FrontViewPositionRight : detent < 0 ? FrontViewPositionLeftSide : FrontViewPositionLeft;
+        journey = ABS( target - xLocation );
+        [self _setFrontViewDetent:detent];
     }
-    
-    // Position driven change:
-    else
-    {    
-        // we may need to set the drag position        
-        if (xLocation > revealWidth*0.5f)
-        {
-            frontViewPosition = FrontViewPositionRight;
-            if (xLocation > revealWidth)
-            {
-                if (bounceBack)
-                    frontViewPosition = FrontViewPositionLeft;
-
-                else if (stableDrag && xLocation > revealWidth+revealOverdraw*0.5f)
-                    frontViewPosition = FrontViewPositionRightMost;
-            }
-        }
+    else
+    {
+        SWRevealDrawerConfig drawer;
+        [_contentView getDrawerConfig:&drawer];
+        frontViewPosition = (FrontViewPosition)SWRevealDrawerReleasePosition( &drawer, xLocation, velocity, &journey );
+        [self _setFrontViewDetent:0];
     }
     
-    // symetric replacement of frontViewPosition
-    [self _getAdjustedFrontViewPosition:&frontViewPosition forSymetry:symetry];
+    NSTimeInterval duration = _toggleAnimationDuration;
+    if ( ABS(velocity) > _quickFlickVelocity )
+        duration = ABS(journey/velocity);
     
     // restore user interaction and animate to the final position
     [self _restoreUserInteraction];
     [self _notifyPanGestureEnded];
-    [self _setFrontViewPosition:frontViewPosition withDuration:duration];
+    [self _endFrameStats];
+    [self _setFrontViewPosition:frontViewPosition withDuration:duration velocity:velocity];
 }
 
 
 - (void)_handleRevealGestureStateCancelledWithRecognizer:(UIPanGestureRecognizer *)recognizer
 {    
+    [self _recordTracePhase:SWRevealTracePhaseCancelled withRecognizer:recognizer];
     [self _restoreUserInteraction];
     [self _notifyPanGestureEnded];
+    [self _endFrameStats];
     [self _dequeue];
 }
 
 
+#pragma mark Frame pacing instrumentation
+
+- (void)_beginFrameStatsDuringGesture:(BOOL)duringGesture
+{
+    if ( !_instrumentsFramePacing )
+        return;
+    
+    [self _endFrameStats];
+    SWRevealFrameStatsReset( &_frameStats, _frameBudget );
+    _frameStatsDuringGesture = duringGesture;
+    
+    // the display link retains us until the stats end
+    _frameStatsLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(_frameStatsLinkFired:)];
+    [_frameStatsLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+}
+
+
+- (void)_frameStatsLinkFired:(CADisplayLink *)link
+{
+    SWRevealFrameStatsAddFrame( &_frameStats, link.timestamp );
+}
+
+
+- (void)_endFrameStats
+{
+    if ( _frameStatsLink == nil )
+        return;
+    
+    [_frameStatsLink invalidate];
+    _frameStatsLink = nil;
+    
+    if ( _delegateCapabilities & SWRevealDelegateFrameStats )
+        [_delegate revealController:self didCollectFrameStats:&_frameStats duringGesture:_frameStatsDuringGesture];
+}
+
+
 #pragma mark Enqueued position and controller setup
 
 - (void)_dispatchSetFrontViewPosition:(FrontViewPosition)frontViewPosition animated:(BOOL)animated
 {
     NSTimeInterval duration = animated?_toggleAnimationDuration:0.0;
-    __weak SWRevealViewController *theSelf = self;
-    _enqueue( [theSelf _setFrontViewPosition:frontViewPosition withDuration:duration] );
+    [self _enqueueSetFrontViewPosition:frontViewPosition withDuration:duration group:0];
 }
 
 
@@ -1372,36 +3642,124 @@ const int FrontViewPositionNone = 0xff;
     if ( initialPosDif == 1 ) firstDuration *= 0.8;
     else if ( initialPosDif == 0 ) firstDuration = 0;
     
-    __weak SWRevealViewController *theSelf = self;
+    // the push steps are enqueued as a group, so that a later push will supersede them if they did not start yet
+    unsigned int group = SWRevealCommandQueueNewGroup( &_commandQueue );
     if ( animated )
     {
-        _enqueue( [theSelf _setFrontViewPosition:preReplacementPosition withDuration:firstDuration] );
-        _enqueue( [theSelf _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:newFrontViewController animated:NO] );
-        _enqueue( [theSelf _setFrontViewPosition:FrontViewPositionLeft withDuration:duration] );
+        [self _enqueueSetFrontViewPosition:preReplacementPosition withDuration:firstDuration group:group];
+        [self _enqueueTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:newFrontViewController animated:NO group:group];
+        [self _enqueueSetFrontViewPosition:FrontViewPositionLeft withDuration:duration group:group];
     }
     else
     {
-        _enqueue( [theSelf _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:newFrontViewController animated:NO] );
+        [self _enqueueTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:newFrontViewController animated:NO group:group];
     }
 }
 
 
 - (void)_dispatchTransitionOperation:(SWRevealControllerOperation)operation withViewController:(UIViewController *)newViewController animated:(BOOL)animated
 {
-    __weak SWRevealViewController *theSelf = self;
-    _enqueue( [theSelf _performTransitionOperation:operation withViewController:newViewController animated:animated] );
+    [self _enqueueTransitionOperation:operation withViewController:newViewController animated:animated group:0];
 }
 
 
 #pragma mark Animated view controller deployment and layout
 
-// Primitive method for view controller deployment and animated layout to the given position.
+// Animated layout to the given position for programatic changes, these start with a velocity of one journey per duration
 - (void)_setFrontViewPosition:(FrontViewPosition)newPosition withDuration:(NSTimeInterval)duration
 {
+    CGFloat journey = [_contentView frontLocationForPosition:newPosition] - _contentView.frontView.frame.origin.x;
+    CGFloat velocity = duration > 0.0 ? journey/duration : 0.0f;
+    [self _setFrontViewPosition:newPosition withDuration:duration velocity:velocity];
+}
+
+
+// Computes the stiffness, as an angular frequency, the duration and the initial velocity, in journeys per second as UIKit
+// expects it, of a spring animation over 'journey' points that starts at 'velocity' points per second. The spring stiffness
+// is such that a journey starting at rest settles in 'duration', which is shorter than toggleAnimationDuration for quick
+// flicks, so faster releases settle sooner
+- (void)_getSpringFrequency:(double*)pAngularFrequency duration:(NSTimeInterval*)pDuration initialVelocity:(CGFloat*)pVelocity
+    forJourney:(CGFloat)journey duration:(NSTimeInterval)duration velocity:(CGFloat)velocity
+{
+    // velocities are meaningless for journeys shorter than a point
+    CGFloat unitVelocity = ABS(journey) >= 1.0f ? velocity/journey : 0.0f;
+    
+    double tolerance = SWRevealSpringDefaultTolerance;
+    double angularFrequency = SWRevealSpringAngularFrequencyForSettlingTime( _springDampingRatio, duration, tolerance );
+    
+    SWRevealSpring spring;
+    SWRevealSpringInit( &spring, _springDampingRatio, angularFrequency, 1.0, unitVelocity );
+    NSTimeInterval springDuration = SWRevealSpringSettlingTime( &spring, tolerance );
+    
+    // undamped springs never settle, we just use the requested duration for them
+    if ( !isfinite(springDuration) ) springDuration = duration;
+    
+    *pAngularFrequency = angularFrequency;
+    *pDuration = springDuration;
+    *pVelocity = unitVelocity;
+}
+
+
+// Runs a spring animation over 'journey' points starting at 'velocity' points per second, settling in about 'duration' from
+// rest. UIKit springs given by a duration do not follow the analytic spring, so on iOS 10 and later the animation is given
+// the stiffness and damping of the spring computed above, with a unit mass. Earlier systems only take a duration and the
+// initial velocity
+- (void)_animateSpringForJourney:(CGFloat)journey duration:(NSTimeInterval)duration velocity:(CGFloat)velocity
+    animations:(void (^)(void))animations completion:(void (^)(BOOL))completion
+{
+    double angularFrequency;
+    NSTimeInterval springDuration;
+    CGFloat springVelocity;
+    [self _getSpringFrequency:&angularFrequency duration:&springDuration initialVelocity:&springVelocity
+        forJourney:journey duration:duration velocity:velocity];
+    
+    Class animatorClass = NSClassFromString(@"UIViewPropertyAnimator");
+    if ( animatorClass == nil || _springDampingRatio <= 0.0 )
+    {
+        [UIView animateWithDuration:duration delay:0.0 usingSpringWithDamping:_springDampingRatio initialSpringVelocity:springVelocity
+        options:0 animations:animations completion:completion];
+        return;
+    }
+    
+    UISpringTimingParameters *timing = [[UISpringTimingParameters alloc] initWithMass:1.0
+        stiffness:angularFrequency*angularFrequency damping:2.0*_springDampingRatio*angularFrequency initialVelocity:CGVectorMake(springVelocity, 0)];
+    
+    // the animator takes its duration from the spring parameters
+    UIViewPropertyAnimator *animator = [[animatorClass alloc] initWithDuration:springDuration timingParameters:timing];
+    __weak UIViewPropertyAnimator *weakAnimator = animator;
+    [animator addAnimations:animations];
+    [animator addCompletion:^(UIViewAnimatingPosition position)
+    {
+        if ( _springAnimator == weakAnimator ) _springAnimator = nil;
+        if ( completion ) completion( position == UIViewAnimatingPositionEnd );
+    }];
+    
+    _springAnimator = animator;
+    [animator startAnimation];
+}
+
+
+- (void)_setFrontViewPosition:(FrontViewPosition)newPosition withDuration:(NSTimeInterval)duration velocity:(CGFloat)velocity
+{
+    [self _setFrontViewPosition:newPosition withDuration:duration velocity:velocity alongsideAnimations:nil completion:nil];
+}
+
+
+// Primitive method for view controller deployment and animated layout to the given position. Velocity is the
+// current front view velocity in points per second, spring animations start with it. The alongside animations and
+// completion, if any, run in the same animation block and before the next command is dequeued
+- (void)_setFrontViewPosition:(FrontViewPosition)newPosition withDuration:(NSTimeInterval)duration velocity:(CGFloat)velocity
+    alongsideAnimations:(void (^)(void))alongsideAnimations completion:(void (^)(void))alongsideCompletion
+{
+    CGFloat journey = [_contentView frontLocationForPosition:newPosition] - _contentView.frontView.frame.origin.x;
+    
     void (^rearDeploymentCompletion)() = [self _rearViewDeploymentForNewFrontViewPosition:newPosition];
     void (^rightDeploymentCompletion)() = [self _rightViewDeploymentForNewFrontViewPosition:newPosition];
     void (^frontDeploymentCompletion)() = [self _frontViewDeploymentForNewFrontViewPosition:newPosition];
     
+    // the animation driver lays out the views itself on each frame
+    BOOL drivesAnimation = _usesDisplayLinkAnimations && duration > 0.0;
+    
     void (^animations)() = ^()
     {
         // Calling this in the animation block causes the status bar to appear/dissapear in sync with our own animation
@@ -1409,31 +3767,58 @@ const int FrontViewPositionNone = 0xff;
         
         // We call the layoutSubviews method on the contentView view and send a delegate, which will
         // occur inside of an animation block if any animated transition is being performed
-        [_contentView layoutSubviews];
+        if ( !drivesAnimation )
+        {
+            [_contentView layoutSubviews];
+            [self _pushProgressPhase:SWRevealProgressPhaseAnimationTarget];
+        }
+        
+        if ( alongsideAnimations )
+            alongsideAnimations();
     
-        if ([_delegate respondsToSelector:@selector(revealController:animateToPosition:)])
+        if ( _delegateCapabilities & SWRevealDelegateAnimateToPosition )
             [_delegate revealController:self animateToPosition:_frontViewPosition];
     };
     
-    void (^completion)(BOOL) = ^(BOOL finished)
+    void (^deploymentCompletion)(void) = ^()
     {
         rearDeploymentCompletion();
         rightDeploymentCompletion();
         frontDeploymentCompletion();
+        if ( alongsideCompletion )
+            alongsideCompletion();
+    };
+    
+    NSUInteger animationSerial = ++_animationSerial;
+    void (^completion)(BOOL) = ^(BOOL finished)
+    {
+        // ignore the completion of an animation that was interrupted by a pan gesture
+        if ( animationSerial != _animationSerial )
+            return;
+        
+        _runningDeploymentCompletion = nil;
+        [self _endFrameStats];
+        [self _pushProgressPhase:SWRevealProgressPhaseAnimationEnded];
+        deploymentCompletion();
         [self _dequeue];
     };
     
     if ( duration > 0.0 )
     {
-        if ( _toggleAnimationType == SWRevealToggleAnimationTypeEaseOut )
+        _runningDeploymentCompletion = deploymentCompletion;
+        [self _beginFrameStatsDuringGesture:NO];
+        if ( drivesAnimation )
+        {
+            [self _driveFrontViewWithDuration:duration journey:journey velocity:velocity animations:animations completion:completion];
+        }
+        else if ( _toggleAnimationType == SWRevealToggleAnimationTypeEaseOut )
         {
             [UIView animateWithDuration:duration delay:0.0
             options:UIViewAnimationOptionCurveEaseOut animations:animations completion:completion];
         }
         else
         {
-            [UIView animateWithDuration:_toggleAnimationDuration delay:0.0 usingSpringWithDamping:_springDampingRatio initialSpringVelocity:1/duration
-            options:0 animations:animations completion:completion];
+            [self _animateSpringForJourney:journey duration:duration velocity:velocity animations:animations completion:completion];
         }
     }
     else
@@ -1444,31 +3829,99 @@ const int FrontViewPositionNone = 0xff;
 }
 
 
+// Display link counterpart of the position animations above. The front view is placed on every frame along the sampled curve
+// and the delegate is told each location, the remaining animations run in a UIKit animation with the same timing
+- (void)_driveFrontViewWithDuration:(NSTimeInterval)duration journey:(CGFloat)journey velocity:(CGFloat)velocity
+    animations:(void (^)(void))animations completion:(void (^)(BOOL))completion
+{
+    SWRevealCurve curve;
+    if ( _toggleAnimationType == SWRevealToggleAnimationTypeEaseOut )
+    {
+        SWRevealCurveInitEaseOut( &curve, duration );
+    }
+    else
+    {
+        double angularFrequency;
+        NSTimeInterval springDuration;
+        CGFloat springVelocity;
+        [self _getSpringFrequency:&angularFrequency duration:&springDuration initialVelocity:&springVelocity
+            forJourney:journey duration:duration velocity:velocity];
+        
+        SWRevealCurveInitSpring( &curve, _springDampingRatio, angularFrequency, springVelocity, springDuration );
+    }
+    
+    CGFloat fromLocation = _contentView.frontView.frame.origin.x;
+    [_animationDriver stop];
+    _animationDriver = [[SWRevealAnimationDriver alloc] initWithCurve:&curve fromLocation:fromLocation toLocation:fromLocation+journey];
+    [self _pushProgressPhase:SWRevealProgressPhaseAnimationTarget forLocation:fromLocation+journey];
+    
+    // the remaining animations follow the same timing as the front view
+    if ( _toggleAnimationType == SWRevealToggleAnimationTypeEaseOut )
+    {
+        [UIView animateWithDuration:duration delay:0.0
+        options:UIViewAnimationOptionCurveEaseOut animations:animations completion:nil];
+    }
+    else
+    {
+        [self _animateSpringForJourney:journey duration:duration velocity:velocity animations:animations completion:nil];
+    }
+    
+    [_contentView placeFrontViewAtXLocation:fromLocation];
+    [_contentView setDrivesLocation:YES];
+    [_animationDriver runWithFrameHandler:^(CGFloat xLocation)
+    {
+        [_contentView placeFrontViewAtXLocation:xLocation];
+        [self _pushProgressPhase:SWRevealProgressPhaseAnimationFrame forLocation:xLocation];
+        [self _notifyAnimationMoved];
+    }
+    completion:^
+    {
+        _animationDriver = nil;
+        [_contentView setDrivesLocation:NO];
+        [_contentView invalidateLocation];
+        [_contentView layoutSubviews];
+        completion(YES);
+    }];
+}
+
+
+- (void)_notifyAnimationMoved
+{
+    [self _notifyDetentProgress];
+    if ( !(_delegateCapabilities & SWRevealDelegateAnimationMovedToLocation) )
+        return;
+    
+    CGFloat xLocation, dragProgress, overProgress;
+    [self _getDragLocation:&xLocation progress:&dragProgress overdrawProgress:&overProgress];
+    [_delegate revealController:self animationMovedToLocation:xLocation progress:dragProgress overProgress:overProgress];
+}
+
+
 // Primitive method for animated controller transition
 //- (void)_performTransitionToViewController:(UIViewController*)new operation:(SWRevealControllerOperation)operation animated:(BOOL)animated
 - (void)_performTransitionOperation:(SWRevealControllerOperation)operation withViewController:(UIViewController*)new animated:(BOOL)animated
 {
-    if ( [_delegate respondsToSelector:@selector(revealController:willAddViewController:forOperation:animated:)] )
+    if ( _delegateCapabilities & SWRevealDelegateWillAddViewController )
         [_delegate revealController:self willAddViewController:new forOperation:operation animated:animated];
 
-    UIViewController *old = nil;
     UIView *view = nil;
+    UIViewController *old = [self _replaceViewControllerForOperation:operation withViewController:new view:&view];
     
-    if ( operation == SWRevealControllerOperationReplaceRearController )
-        old = _rearViewController, _rearViewController = new, view = _contentView.rearView;
-    
-    else if ( operation == SWRevealControllerOperationReplaceFrontController )
-        old = _frontViewController, _frontViewController = new, view = _contentView.frontView;
-    
-    else if ( operation == SWRevealControllerOperationReplaceRightController )
-        old = _rightViewController, _rightViewController = new, view = _contentView.rightView;
+    // the new view is only added if its side is deployed, otherwise the next position change will do it. This avoids
+    // appearance calls for views left in retained or offscreen containers, the deployment tests cover both cases
+    if ( ![self _isDeployedForOperation:operation] )
+        view = nil;
 
     void (^completion)() = [self _transitionFromViewController:old toViewController:new inView:view];
     
     void (^animationCompletion)() = ^
     {
         completion();
-        if ( [_delegate respondsToSelector:@selector(revealController:didAddViewController:forOperation:animated:)] )
+        
+        // the replaced front controller may now be evicted from the cache
+        if ( operation == SWRevealControllerOperationReplaceFrontController )
+            [_frontControllerCache evictExceptController:_frontViewController];
+        if ( _delegateCapabilities & SWRevealDelegateDidAddViewController )
             [_delegate revealController:self didAddViewController:new forOperation:operation animated:animated];
     
         [self _dequeue];
@@ -1478,7 +3931,7 @@ const int FrontViewPositionNone = 0xff;
     {
         id<UIViewControllerAnimatedTransitioning> animationController = nil;
     
-        if ( [_delegate respondsToSelector:@selector(revealController:animationControllerForOperation:fromViewController:toViewController:)] )
+        if ( _delegateCapabilities & SWRevealDelegateAnimationController )
             animationController = [_delegate revealController:self animationControllerForOperation:operation fromViewController:old toViewController:new];
     
         if ( !animationController )
@@ -1505,23 +3958,18 @@ const int FrontViewPositionNone = 0xff;
 // that must be invoked on animation completion in order to finish deployment
 - (void (^)(void))_frontViewDeploymentForNewFrontViewPosition:(FrontViewPosition)newPosition
 {
-    if ( (_rightViewController == nil && newPosition < FrontViewPositionLeft) ||
-         (_rearViewController == nil && newPosition > FrontViewPositionLeft) )
-        newPosition = FrontViewPositionLeft;
+    // the deployment rules are shared with the headless model, see SWRevealDeployment.h
+    SWRevealDeploymentStep step;
+    SWRevealFrontDeploymentStep( _frontViewPosition, newPosition, _rearViewController != nil, _rightViewController != nil, &step );
+    newPosition = step.position;
     
     BOOL positionIsChanging = (_frontViewPosition != newPosition);
-    
-    BOOL appear =
-        (_frontViewPosition >= FrontViewPositionRightMostRemoved || _frontViewPosition <= FrontViewPositionLeftSideMostRemoved || _frontViewPosition == FrontViewPositionNone) &&
-        (newPosition < FrontViewPositionRightMostRemoved && newPosition > FrontViewPositionLeftSideMostRemoved);
-    
-    BOOL disappear =
-        (newPosition >= FrontViewPositionRightMostRemoved || newPosition <= FrontViewPositionLeftSideMostRemoved ) &&
-        (_frontViewPosition < FrontViewPositionRightMostRemoved && _frontViewPosition > FrontViewPositionLeftSideMostRemoved && _frontViewPosition != FrontViewPositionNone);
+    BOOL appear = step.appear;
+    BOOL disappear = step.disappear;
     
     if ( positionIsChanging )
     {
-        if ( [_delegate respondsToSelector:@selector(revealController:willMoveToPosition:)] )
+        if ( _delegateCapabilities & SWRevealDelegateWillMoveToPosition )
             [_delegate revealController:self willMoveToPosition:newPosition];
     }
     
@@ -1535,7 +3983,7 @@ const int FrontViewPositionNone = 0xff;
         deploymentCompletion();
         if ( positionIsChanging )
         {
-            if ( [_delegate respondsToSelector:@selector(revealController:didMoveToPosition:)] )
+            if ( _delegateCapabilities & SWRevealDelegateDidMoveToPosition )
                 [_delegate revealController:self didMoveToPosition:newPosition];
         }
     };
@@ -1547,28 +3995,31 @@ const int FrontViewPositionNone = 0xff;
 // that must be invoked on animation completion in order to finish deployment
 - (void (^)(void))_rearViewDeploymentForNewFrontViewPosition:(FrontViewPosition)newPosition
 {
-    if ( _presentFrontViewHierarchically )
-        newPosition = FrontViewPositionRight;
-    
-    if ( _rearViewController == nil && newPosition > FrontViewPositionLeft )
-        newPosition = FrontViewPositionLeft;
+    SWRevealDeploymentStep step;
+    SWRevealRearDeploymentStep( _rearViewPosition, newPosition, _rearViewController != nil, _presentFrontViewHierarchically, &step );
+    newPosition = step.position;
 
-    BOOL appear = (_rearViewPosition <= FrontViewPositionLeft || _rearViewPosition == FrontViewPositionNone) && newPosition > FrontViewPositionLeft;
-    BOOL disappear = newPosition <= FrontViewPositionLeft && (_rearViewPosition > FrontViewPositionLeft && _rearViewPosition != FrontViewPositionNone);
+    BOOL appear = step.appear;
+    BOOL disappear = step.disappear;
     
     if ( appear )
+    {
+        [self _reuseContainerForSymetry:1];
         [_contentView prepareRearViewForPosition:newPosition];
+    }
     
     _rearViewPosition = newPosition;
     
-    void (^deploymentCompletion)() =
+    // controller views stay in containers that are retained when closed
+    void (^deploymentCompletion)() = disappear && _viewRetentionPolicy != SWRevealViewRetentionPolicyNone ?
+        [self _undeployForViewController:_rearViewController keepingView:YES] :
         [self _deploymentForViewController:_rearViewController inView:_contentView.rearView appear:appear disappear:disappear];
     
     void (^completion)() = ^()
     {
         deploymentCompletion();
         if ( disappear )
-            [_contentView unloadRearView];
+            [self _retainOrUnloadContainerForSymetry:1];
     };
     
     return completion;
@@ -1578,31 +4029,183 @@ const int FrontViewPositionNone = 0xff;
 // that must be invoked on animation completion in order to finish deployment
 - (void (^)(void))_rightViewDeploymentForNewFrontViewPosition:(FrontViewPosition)newPosition
 {
-    if ( _rightViewController == nil && newPosition < FrontViewPositionLeft )
-        newPosition = FrontViewPositionLeft;
+    SWRevealDeploymentStep step;
+    SWRevealRightDeploymentStep( _rightViewPosition, newPosition, _rightViewController != nil, &step );
+    newPosition = step.position;
 
-    BOOL appear = (_rightViewPosition >= FrontViewPositionLeft || _rightViewPosition == FrontViewPositionNone) && newPosition < FrontViewPositionLeft ;
-    BOOL disappear = newPosition >= FrontViewPositionLeft && (_rightViewPosition < FrontViewPositionLeft && _rightViewPosition != FrontViewPositionNone);
+    BOOL appear = step.appear;
+    BOOL disappear = step.disappear;
     
     if ( appear )
+    {
+        [self _reuseContainerForSymetry:-1];
         [_contentView prepareRightViewForPosition:newPosition];
+    }
     
     _rightViewPosition = newPosition;
     
-    void (^deploymentCompletion)() =
+    // controller views stay in containers that are retained when closed
+    void (^deploymentCompletion)() = disappear && _viewRetentionPolicy != SWRevealViewRetentionPolicyNone ?
+        [self _undeployForViewController:_rightViewController keepingView:YES] :
         [self _deploymentForViewController:_rightViewController inView:_contentView.rightView appear:appear disappear:disappear];
     
     void (^completion)() = ^()
     {
         deploymentCompletion();
         if ( disappear )
-            [_contentView unloadRightView];
+            [self _retainOrUnloadContainerForSymetry:-1];
     };
 
     return completion;
 }
 
 
+// Primitive method for batch updates. All the controllers are replaced in a single containment pass, then the views move to
+// the new position, if any, with a single layout and animation that also cross dissolves the replaced views
+- (void)_performBatch:(SWRevealTransaction *)transaction
+{
+    BOOL animated = transaction.animated;
+    NSArray *operations = transaction.operations;
+    FrontViewPosition newPosition = transaction.hasPosition ? transaction.position : _frontViewPosition;
+    if ( transaction.hasPosition )
+        [self _setFrontViewDetent:0];
+    
+    // all controllers are replaced first, as the deployment of each side depends on the controllers present
+    NSMutableArray *oldControllers = [NSMutableArray array];
+    NSMutableArray *views = [NSMutableArray array];
+    for ( NSNumber *operation in operations )
+    {
+        SWRevealControllerOperation op = [operation integerValue];
+        UIViewController *new = [transaction viewControllerForOperation:op];
+        
+        if ( _delegateCapabilities & SWRevealDelegateWillAddViewController )
+            [_delegate revealController:self willAddViewController:new forOperation:op animated:animated];
+        
+        UIView *view = nil;
+        UIViewController *old = [self _replaceViewControllerForOperation:op withViewController:new view:&view];
+        [oldControllers addObject:old ?: [NSNull null]];
+        [views addObject:view ?: [NSNull null]];
+    }
+    
+    NSMutableArray *transitionCompletions = [NSMutableArray array];
+    NSMutableArray *fadeAnimations = [NSMutableArray array];
+    NSMutableArray *fadeCompletions = [NSMutableArray array];
+    for ( NSUInteger i=0 ; i<operations.count ; i++ )
+    {
+        SWRevealControllerOperation op = [operations[i] integerValue];
+        UIViewController *new = [transaction viewControllerForOperation:op];
+        UIViewController *old = oldControllers[i] == [NSNull null] ? nil : oldControllers[i];
+        UIView *view = views[i] == [NSNull null] ? nil : views[i];
+        
+        // new views are added now only to sides that stay deployed, the position change adds them to sides that open
+        if ( ![self _isDeployedForOperation:op] || ![self _isDeployedForOperation:op afterPosition:newPosition] )
+            view = nil;
+        
+        BOOL oldShown = old != new && [old isViewLoaded] && old.view.window != nil;
+        [transitionCompletions addObject:[self _transitionFromViewController:old toViewController:new inView:view]];
+        
+        if ( !animated || old == new )
+            continue;
+        
+        // the new view fades in over the old one, or the old one fades out if there is no new view to show
+        if ( view && new )
+        {
+            UIView *toView = new.view;
+            CGFloat alpha = toView.alpha;
+            toView.alpha = 0;
+            [fadeAnimations addObject:^{ toView.alpha = alpha; }];
+        }
+        else if ( oldShown )
+        {
+            UIView *fromView = old.view;
+            CGFloat alpha = fromView.alpha;
+            [fadeAnimations addObject:^{ fromView.alpha = 0; }];
+            [fadeCompletions addObject:^{ fromView.alpha = alpha; }];
+        }
+    }
+    
+    void (^alongsideAnimations)(void) = ^
+    {
+        for ( void (^fade)(void) in fadeAnimations ) fade();
+    };
+    
+    void (^alongsideCompletion)(void) = ^
+    {
+        for ( void (^completion)(void) in transitionCompletions ) completion();
+        for ( void (^completion)(void) in fadeCompletions ) completion();
+        
+        for ( NSNumber *operation in operations )
+        {
+            SWRevealControllerOperation op = [operation integerValue];
+            if ( op == SWRevealControllerOperationReplaceFrontController )
+                [_frontControllerCache evictExceptController:_frontViewController];
+            if ( _delegateCapabilities & SWRevealDelegateDidAddViewController )
+                [_delegate revealController:self didAddViewController:[transaction viewControllerForOperation:op] forOperation:op animated:animated];
+        }
+    };
+    
+    NSTimeInterval duration = 0.0;
+    if ( animated ) duration = transaction.hasPosition ? _toggleAnimationDuration : _replaceViewAnimationDuration;
+    
+    CGFloat journey = [_contentView frontLocationForPosition:newPosition] - _contentView.frontView.frame.origin.x;
+    CGFloat velocity = duration > 0.0 ? journey/duration : 0.0f;
+    [self _setFrontViewPosition:newPosition withDuration:duration velocity:velocity
+        alongsideAnimations:alongsideAnimations completion:alongsideCompletion];
+}
+
+
+// Sets the controller for 'operation' and returns the replaced one, its container view is returned in 'pView'
+- (UIViewController *)_replaceViewControllerForOperation:(SWRevealControllerOperation)operation withViewController:(UIViewController*)new
+    view:(UIView**)pView
+{
+    UIViewController *old = nil;
+    
+    if ( operation == SWRevealControllerOperationReplaceRearController )
+        old = _rearViewController, _rearViewController = new, *pView = _contentView.rearView;
+    
+    else if ( operation == SWRevealControllerOperationReplaceFrontController )
+        old = _frontViewController, _frontViewController = new, *pView = _contentView.frontView;
+    
+    else if ( operation == SWRevealControllerOperationReplaceRightController )
+        old = _rightViewController, _rightViewController = new, *pView = _contentView.rightView;
+    
+    return old;
+}
+
+
+// Returns whether the side of 'operation' will still be deployed after moving to 'newPosition'
+- (BOOL)_isDeployedForOperation:(SWRevealControllerOperation)operation afterPosition:(FrontViewPosition)newPosition
+{
+    SWRevealDeploymentStep step;
+    if ( operation == SWRevealControllerOperationReplaceRearController )
+    {
+        SWRevealRearDeploymentStep( _rearViewPosition, newPosition, _rearViewController != nil, _presentFrontViewHierarchically, &step );
+        return step.position > FrontViewPositionLeft;
+    }
+    
+    if ( operation == SWRevealControllerOperationReplaceRightController )
+    {
+        SWRevealRightDeploymentStep( _rightViewPosition, newPosition, _rightViewController != nil, &step );
+        return step.position < FrontViewPositionLeft;
+    }
+    
+    SWRevealFrontDeploymentStep( _frontViewPosition, newPosition, _rearViewController != nil, _rightViewController != nil, &step );
+    return step.position > FrontViewPositionLeftSideMostRemoved && step.position < FrontViewPositionRightMostRemoved;
+}
+
+
+- (BOOL)_isDeployedForOperation:(SWRevealControllerOperation)operation
+{
+    if ( operation == SWRevealControllerOperationReplaceRearController )
+        return _rearViewPosition > FrontViewPositionLeft && _rearViewPosition != FrontViewPositionNone;
+    
+    if ( operation == SWRevealControllerOperationReplaceRightController )
+        return _rightViewPosition < FrontViewPositionLeft;
+    
+    return _frontViewPosition > FrontViewPositionLeftSideMostRemoved && _frontViewPosition < FrontViewPositionRightMostRemoved;
+}
+
+
 - (void (^)(void)) _deploymentForViewController:(UIViewController*)controller inView:(UIView*)view appear:(BOOL)appear disappear:(BOOL)disappear
 {
     if ( appear ) return [self _deployForViewController:controller inView:view];
@@ -1611,6 +4214,100 @@ const int FrontViewPositionNone = 0xff;
 }
 
 
+#pragma mark Container retention
+
+// Called when the rear (symetry > 0) or right (symetry < 0) side closes, keeps its container according to the retention policy
+- (void)_retainOrUnloadContainerForSymetry:(int)symetry
+{
+    if ( _viewRetentionPolicy == SWRevealViewRetentionPolicyNone )
+    {
+        [self _unloadContainerForSymetry:symetry];
+        return;
+    }
+    
+    int index = symetry<0 ? 0 : 1;
+    _containerRetained[index] = YES;
+    NSUInteger generation = ++_containerGeneration[index];
+    
+    if ( symetry > 0 ) [_contentView retainRearView];
+    else [_contentView retainRightView];
+    
+    if ( _viewRetentionPolicy == SWRevealViewRetentionPolicyExpire )
+    {
+        __weak SWRevealViewController *weakSelf = self;
+        dispatch_after( dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_viewRetentionInterval*NSEC_PER_SEC)), dispatch_get_main_queue(), ^
+        {
+            [weakSelf _expireContainerForSymetry:symetry generation:generation];
+        });
+    }
+    
+    [self _notifyRetainedViews];
+}
+
+
+// Called when the rear or right side opens, a retained container is no longer retained but in use
+- (void)_reuseContainerForSymetry:(int)symetry
+{
+    int index = symetry<0 ? 0 : 1;
+    _containerGeneration[index] += 1;
+    
+    if ( _containerRetained[index] )
+    {
+        _containerRetained[index] = NO;
+        [self _notifyRetainedViews];
+    }
+}
+
+
+- (void)_expireContainerForSymetry:(int)symetry generation:(NSUInteger)generation
+{
+    int index = symetry<0 ? 0 : 1;
+    if ( _containerRetained[index] && _containerGeneration[index] == generation )
+        [self _unloadContainerForSymetry:symetry];
+}
+
+
+- (void)_unloadContainerForSymetry:(int)symetry
+{
+    int index = symetry<0 ? 0 : 1;
+    BOOL wasRetained = _containerRetained[index];
+    _containerRetained[index] = NO;
+    _containerGeneration[index] += 1;
+    
+    if ( symetry > 0 ) [_contentView unloadRearView];
+    else [_contentView unloadRightView];
+    
+    if ( wasRetained )
+        [self _notifyRetainedViews];
+}
+
+
+- (void)_notifyRetainedViews
+{
+    if ( !(_delegateCapabilities & SWRevealDelegateRetainedViews) )
+        return;
+    
+    NSUInteger count = 0;
+    NSUInteger bytes = 0;
+    for ( int index=0 ; index<2 ; index++ )
+    {
+        if ( !_containerRetained[index] )
+            continue;
+        
+        count += 1;
+        UIViewController *controller = index == 0 ? _rightViewController : _rearViewController;
+        if ( [controller isViewLoaded] )
+        {
+            UIView *view = controller.view;
+            CGFloat scale = view.contentScaleFactor;
+            bytes += (NSUInteger)(view.bounds.size.width*scale * view.bounds.size.height*scale * 4);
+        }
+    }
+    
+    [_delegate revealController:self didRetainViewCount:count estimatedBytes:bytes];
+}
+
+
 #pragma mark Containment view controller deployment and transition
 
 // Containment Deploy method. Returns a block to be invoked at the
@@ -1632,11 +4329,14 @@ const int FrontViewPositionNone = 0xff;
         
         if ( adjust )
         {
-            [(id)controllerView setContentInset:UIEdgeInsetsMake(statusBarAdjustment(_contentView), 0, 0, 0)];
+            SWRevealMetrics fallback;
+            [(id)controllerView setContentInset:UIEdgeInsetsMake([self _metricsWithFallback:&fallback]->statusBarInset, 0, 0, 0)];
         }
     }
     
-    [view addSubview:controllerView];
+    // a retained container may already hold the view
+    if ( controllerView.superview != view )
+        [view addSubview:controllerView];
     
     void (^completionBlock)(void) = ^(void)
     {
@@ -1649,6 +4349,13 @@ const int FrontViewPositionNone = 0xff;
 // Containment Undeploy method. Returns a block to be invoked at the
 // animation completion, or right after return in case of non-animated deployment.
 - (void (^)(void))_undeployForViewController:(UIViewController*)controller
+{
+    return [self _undeployForViewController:controller keepingView:NO];
+}
+
+
+// Same as above, the controller view is left in its container if 'keepView' is YES
+- (void (^)(void))_undeployForViewController:(UIViewController*)controller keepingView:(BOOL)keepView
 {
     if (!controller)
         return ^(void){};
@@ -1657,7 +4364,9 @@ const int FrontViewPositionNone = 0xff;
     
     void (^completionBlock)(void) = ^(void)
     {
-        [controller.view removeFromSuperview];
+        [self _restoreTransformTrackLayerForController:controller];
+        if ( !keepView )
+            [controller.view removeFromSuperview];
     };
     
     return completionBlock;
@@ -1689,6 +4398,14 @@ const int FrontViewPositionNone = 0xff;
     return completionBlock;
 }
 
+- (NSUInteger)nestingLevel
+{
+    NSUInteger depth;
+    SWRevealControllerAbove( self, &depth );
+    return depth;
+}
+
+
 // Load any defined front/rear controllers from the storyboard
 // This method is intended to be overrided in case the default behavior will not meet your needs
 - (void)loadStoryboardControllers
@@ -1736,79 +4453,200 @@ const int FrontViewPositionNone = 0xff;
 
 - (void)encodeRestorableStateWithCoder:(NSCoder *)coder
 {
-    [coder encodeDouble:_rearViewRevealWidth forKey:@"_rearViewRevealWidth"];
-    [coder encodeDouble:_rearViewRevealOverdraw forKey:@"_rearViewRevealOverdraw"];
-    [coder encodeDouble:_rearViewRevealDisplacement forKey:@"_rearViewRevealDisplacement"];
-    [coder encodeDouble:_rightViewRevealWidth forKey:@"_rightViewRevealWidth"];
-    [coder encodeDouble:_rightViewRevealOverdraw forKey:@"_rightViewRevealOverdraw"];
-    [coder encodeDouble:_rightViewRevealDisplacement forKey:@"_rightViewRevealDisplacement"];
-    [coder encodeBool:_bounceBackOnOverdraw forKey:@"_bounceBackOnOverdraw"];
-    [coder encodeBool:_bounceBackOnLeftOverdraw forKey:@"_bounceBackOnLeftOverdraw"];
-    [coder encodeBool:_stableDragOnOverdraw forKey:@"_stableDragOnOverdraw"];
-    [coder encodeBool:_stableDragOnLeftOverdraw forKey:@"_stableDragOnLeftOverdraw"];
-    [coder encodeBool:_presentFrontViewHierarchically forKey:@"_presentFrontViewHierarchically"];
-    [coder encodeDouble:_quickFlickVelocity forKey:@"_quickFlickVelocity"];
-    [coder encodeDouble:_toggleAnimationDuration forKey:@"_toggleAnimationDuration"];
-    [coder encodeInteger:_toggleAnimationType forKey:@"_toggleAnimationType"];
-    [coder encodeDouble:_springDampingRatio forKey:@"_springDampingRatio"];
-    [coder encodeDouble:_replaceViewAnimationDuration forKey:@"_replaceViewAnimationDuration"];
-    [coder encodeDouble:_frontViewShadowRadius forKey:@"_frontViewShadowRadius"];
-    [coder encodeCGSize:_frontViewShadowOffset forKey:@"_frontViewShadowOffset"];
-    [coder encodeDouble:_frontViewShadowOpacity forKey:@"_frontViewShadowOpacity"];
-    [coder encodeObject:_frontViewShadowColor forKey:@"_frontViewShadowColor"];
-    [coder encodeBool:_userInteractionStore forKey:@"_userInteractionStore"];
-    [coder encodeDouble:_draggableBorderWidth forKey:@"_draggableBorderWidth"];
-    [coder encodeBool:_clipsViewsToBounds forKey:@"_clipsViewsToBounds"];
-    [coder encodeBool:_extendsPointInsideHit forKey:@"_extendsPointInsideHit"];
+    // the configuration and position are encoded in a single blob, see SWRevealStateCodec.h
+    SWRevealState state;
+    [self _getRestorableState:&state];
+    
+    NSMutableData *data = [NSMutableData dataWithLength:SWRevealStateEncodedSize()];
+    SWRevealStateEncode( &state, [data mutableBytes] );
+    [coder encodeObject:data forKey:@"_state"];
     
     [coder encodeObject:_rearViewController forKey:@"_rearViewController"];
     [coder encodeObject:_frontViewController forKey:@"_frontViewController"];
     [coder encodeObject:_rightViewController forKey:@"_rightViewController"];
     
-    [coder encodeInteger:_frontViewPosition  forKey:@"_frontViewPosition"];
-    
     [super encodeRestorableStateWithCoder:coder];
 }
 
 
 - (void)decodeRestorableStateWithCoder:(NSCoder *)coder
 {
-    _rearViewRevealWidth = [coder decodeDoubleForKey:@"_rearViewRevealWidth"];
-    _rearViewRevealOverdraw = [coder decodeDoubleForKey:@"_rearViewRevealOverdraw"];
-    _rearViewRevealDisplacement = [coder decodeDoubleForKey:@"_rearViewRevealDisplacement"];
-    _rightViewRevealWidth = [coder decodeDoubleForKey:@"_rightViewRevealWidth"];
-    _rightViewRevealOverdraw = [coder decodeDoubleForKey:@"_rightViewRevealOverdraw"];
-    _rightViewRevealDisplacement = [coder decodeDoubleForKey:@"_rightViewRevealDisplacement"];
-    _bounceBackOnOverdraw = [coder decodeBoolForKey:@"_bounceBackOnOverdraw"];
-    _bounceBackOnLeftOverdraw = [coder decodeBoolForKey:@"_bounceBackOnLeftOverdraw"];
-    _stableDragOnOverdraw = [coder decodeBoolForKey:@"_stableDragOnOverdraw"];
-    _stableDragOnLeftOverdraw = [coder decodeBoolForKey:@"_stableDragOnLeftOverdraw"];
-    _presentFrontViewHierarchically = [coder decodeBoolForKey:@"_presentFrontViewHierarchically"];
-    _quickFlickVelocity = [coder decodeDoubleForKey:@"_quickFlickVelocity"];
-    _toggleAnimationDuration = [coder decodeDoubleForKey:@"_toggleAnimationDuration"];
-    _toggleAnimationType = [coder decodeIntegerForKey:@"_toggleAnimationType"];
-    _springDampingRatio = [coder decodeDoubleForKey:@"_springDampingRatio"];
-    _replaceViewAnimationDuration = [coder decodeDoubleForKey:@"_replaceViewAnimationDuration"];
-    _frontViewShadowRadius = [coder decodeDoubleForKey:@"_frontViewShadowRadius"];
-    _frontViewShadowOffset = [coder decodeCGSizeForKey:@"_frontViewShadowOffset"];
-    _frontViewShadowOpacity = [coder decodeDoubleForKey:@"_frontViewShadowOpacity"];
-    _frontViewShadowColor = [coder decodeObjectForKey:@"_frontViewShadowColor"];
-    _userInteractionStore = [coder decodeBoolForKey:@"_userInteractionStore"];
-    _animationQueue = [NSMutableArray array];
-    _draggableBorderWidth = [coder decodeDoubleForKey:@"_draggableBorderWidth"];
-    _clipsViewsToBounds = [coder decodeBoolForKey:@"_clipsViewsToBounds"];
-    _extendsPointInsideHit = [coder decodeBoolForKey:@"_extendsPointInsideHit"];
-
-    [self setRearViewController:[coder decodeObjectForKey:@"_rearViewController"]];
-    [self setFrontViewController:[coder decodeObjectForKey:@"_frontViewController"]];
-    [self setRightViewController:[coder decodeObjectForKey:@"_rightViewController"]];
-    
-    [self setFrontViewPosition:[coder decodeIntForKey: @"_frontViewPosition"]];
+    // fields missing from the blob keep the current values
+    SWRevealState state;
+    [self _getRestorableState:&state];
+    
+    NSData *data = [coder decodeObjectForKey:@"_state"];
+    if ( ![data isKindOfClass:[NSData class]] || SWRevealStateDecode( [data bytes], [data length], &state ) != 0 )
+        [self _getRestorableState:&state fromLegacyCoder:coder];
+    
+    [self _setRestorableState:&state];
+    [_contentView invalidateMetrics];
+    [_contentView reloadShadow];
+    
+    UIViewController *rearViewController = [coder decodeObjectForKey:@"_rearViewController"];
+    UIViewController *frontViewController = [coder decodeObjectForKey:@"_frontViewController"];
+    UIViewController *rightViewController = [coder decodeObjectForKey:@"_rightViewController"];
+    FrontViewPosition position = (FrontViewPosition)state.frontViewPosition;
+    if ( position < FrontViewPositionLeftSideMostRemoved || position > FrontViewPositionRightMostRemoved )
+        position = FrontViewPositionLeft;
+    
+    // if nothing is pending we deploy the controllers and place them at the restored position right away, with a single layout
+    if ( SWRevealCommandQueueCount( &_commandQueue ) == 0 )
+    {
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceRearController withViewController:rearViewController animated:NO];
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceFrontController withViewController:frontViewController animated:NO];
+        [self _performTransitionOperation:SWRevealControllerOperationReplaceRightController withViewController:rightViewController animated:NO];
+        
+        if ( [self isViewLoaded] )
+            [self _setFrontViewPosition:position withDuration:0.0];
+        else
+            _frontViewPosition = _rearViewPosition = _rightViewPosition = position;
+    }
+    else
+    {
+        [self setRearViewController:rearViewController];
+        [self setFrontViewController:frontViewController];
+        [self setRightViewController:rightViewController];
+        [self setFrontViewPosition:position];
+    }
     
     [super decodeRestorableStateWithCoder:coder];
 }
 
 
+- (void)_getRestorableState:(SWRevealState*)state
+{
+    memset( state, 0, sizeof *state );
+    state->rearViewRevealWidth = _rearViewRevealWidth;
+    state->rearViewRevealOverdraw = _rearViewRevealOverdraw;
+    state->rearViewRevealDisplacement = _rearViewRevealDisplacement;
+    state->rightViewRevealWidth = _rightViewRevealWidth;
+    state->rightViewRevealOverdraw = _rightViewRevealOverdraw;
+    state->rightViewRevealDisplacement = _rightViewRevealDisplacement;
+    state->quickFlickVelocity = _quickFlickVelocity;
+    state->toggleAnimationDuration = _toggleAnimationDuration;
+    state->springDampingRatio = _springDampingRatio;
+    state->replaceViewAnimationDuration = _replaceViewAnimationDuration;
+    state->frontViewShadowRadius = _frontViewShadowRadius;
+    state->frontViewShadowOffsetWidth = _frontViewShadowOffset.width;
+    state->frontViewShadowOffsetHeight = _frontViewShadowOffset.height;
+    state->frontViewShadowOpacity = _frontViewShadowOpacity;
+    
+    CGFloat red, green, blue, alpha;
+    SWGetColorComponents( _frontViewShadowColor, &red, &green, &blue, &alpha );
+    state->frontViewShadowRed = red, state->frontViewShadowGreen = green, state->frontViewShadowBlue = blue, state->frontViewShadowAlpha = alpha;
+    
+    state->draggableBorderWidth = _draggableBorderWidth;
+    state->viewRetentionInterval = _viewRetentionInterval;
+    
+    unsigned int flags = 0;
+    if ( _bounceBackOnOverdraw ) flags |= SWRevealStateBounceBackOnOverdraw;
+    if ( _bounceBackOnLeftOverdraw ) flags |= SWRevealStateBounceBackOnLeftOverdraw;
+    if ( _stableDragOnOverdraw ) flags |= SWRevealStateStableDragOnOverdraw;
+    if ( _stableDragOnLeftOverdraw ) flags |= SWRevealStateStableDragOnLeftOverdraw;
+    if ( _presentFrontViewHierarchically ) flags |= SWRevealStatePresentFrontViewHierarchically;
+    if ( _userInteractionStore ) flags |= SWRevealStateUserInteractionStore;
+    if ( _clipsViewsToBounds ) flags |= SWRevealStateClipsViewsToBounds;
+    if ( _extendsPointInsideHit ) flags |= SWRevealStateExtendsPointInsideHit;
+    if ( _interruptibleAnimations ) flags |= SWRevealStateInterruptibleAnimations;
+    if ( _routesNestedPanGestures ) flags |= SWRevealStateRoutesNestedPanGestures;
+    state->flags = flags;
+    
+    state->toggleAnimationType = (int)_toggleAnimationType;
+    state->dragResistanceType = (int)_dragResistanceType;
+    state->frontViewShadowStyle = (int)_frontViewShadowStyle;
+    state->viewRetentionPolicy = (int)_viewRetentionPolicy;
+    state->frontViewPosition = (int)_frontViewPosition;
+}
+
+
+- (void)_setRestorableState:(const SWRevealState*)state
+{
+    _rearViewRevealWidth = state->rearViewRevealWidth;
+    _rearViewRevealOverdraw = state->rearViewRevealOverdraw;
+    _rearViewRevealDisplacement = state->rearViewRevealDisplacement;
+    _rightViewRevealWidth = state->rightViewRevealWidth;
+    _rightViewRevealOverdraw = state->rightViewRevealOverdraw;
+    _rightViewRevealDisplacement = state->rightViewRevealDisplacement;
+    _quickFlickVelocity = state->quickFlickVelocity;
+    _toggleAnimationDuration = state->toggleAnimationDuration;
+    _springDampingRatio = state->springDampingRatio;
+    _replaceViewAnimationDuration = state->replaceViewAnimationDuration;
+    _frontViewShadowRadius = state->frontViewShadowRadius;
+    _frontViewShadowOffset = CGSizeMake( state->frontViewShadowOffsetWidth, state->frontViewShadowOffsetHeight );
+    _frontViewShadowOpacity = state->frontViewShadowOpacity;
+    _frontViewShadowColor = [UIColor colorWithRed:state->frontViewShadowRed green:state->frontViewShadowGreen
+        blue:state->frontViewShadowBlue alpha:state->frontViewShadowAlpha];
+    _draggableBorderWidth = state->draggableBorderWidth;
+    _viewRetentionInterval = state->viewRetentionInterval;
+    
+    unsigned int flags = state->flags;
+    _bounceBackOnOverdraw = (flags & SWRevealStateBounceBackOnOverdraw) != 0;
+    _bounceBackOnLeftOverdraw = (flags & SWRevealStateBounceBackOnLeftOverdraw) != 0;
+    _stableDragOnOverdraw = (flags & SWRevealStateStableDragOnOverdraw) != 0;
+    _stableDragOnLeftOverdraw = (flags & SWRevealStateStableDragOnLeftOverdraw) != 0;
+    _presentFrontViewHierarchically = (flags & SWRevealStatePresentFrontViewHierarchically) != 0;
+    _userInteractionStore = (flags & SWRevealStateUserInteractionStore) != 0;
+    _clipsViewsToBounds = (flags & SWRevealStateClipsViewsToBounds) != 0;
+    _extendsPointInsideHit = (flags & SWRevealStateExtendsPointInsideHit) != 0;
+    _interruptibleAnimations = (flags & SWRevealStateInterruptibleAnimations) != 0;
+    _routesNestedPanGestures = (flags & SWRevealStateRoutesNestedPanGestures) != 0;
+    
+    _toggleAnimationType = state->toggleAnimationType;
+    _dragResistanceType = state->dragResistanceType;
+    _frontViewShadowStyle = state->frontViewShadowStyle;
+    _viewRetentionPolicy = state->viewRetentionPolicy;
+    
+    // the position is applied by the caller
+}
+
+
+// Reads the individual keys written by versions before 2.5.0
+- (void)_getRestorableState:(SWRevealState*)state fromLegacyCoder:(NSCoder *)coder
+{
+    if ( ![coder containsValueForKey:@"_rearViewRevealWidth"] )
+        return;
+    
+    state->rearViewRevealWidth = [coder decodeDoubleForKey:@"_rearViewRevealWidth"];
+    state->rearViewRevealOverdraw = [coder decodeDoubleForKey:@"_rearViewRevealOverdraw"];
+    state->rearViewRevealDisplacement = [coder decodeDoubleForKey:@"_rearViewRevealDisplacement"];
+    state->rightViewRevealWidth = [coder decodeDoubleForKey:@"_rightViewRevealWidth"];
+    state->rightViewRevealOverdraw = [coder decodeDoubleForKey:@"_rightViewRevealOverdraw"];
+    state->rightViewRevealDisplacement = [coder decodeDoubleForKey:@"_rightViewRevealDisplacement"];
+    state->quickFlickVelocity = [coder decodeDoubleForKey:@"_quickFlickVelocity"];
+    state->toggleAnimationDuration = [coder decodeDoubleForKey:@"_toggleAnimationDuration"];
+    state->springDampingRatio = [coder decodeDoubleForKey:@"_springDampingRatio"];
+    state->replaceViewAnimationDuration = [coder decodeDoubleForKey:@"_replaceViewAnimationDuration"];
+    state->frontViewShadowRadius = [coder decodeDoubleForKey:@"_frontViewShadowRadius"];
+    
+    CGSize offset = [coder decodeCGSizeForKey:@"_frontViewShadowOffset"];
+    state->frontViewShadowOffsetWidth = offset.width;
+    state->frontViewShadowOffsetHeight = offset.height;
+    state->frontViewShadowOpacity = [coder decodeDoubleForKey:@"_frontViewShadowOpacity"];
+    
+    CGFloat red, green, blue, alpha;
+    SWGetColorComponents( [coder decodeObjectForKey:@"_frontViewShadowColor"], &red, &green, &blue, &alpha );
+    state->frontViewShadowRed = red, state->frontViewShadowGreen = green, state->frontViewShadowBlue = blue, state->frontViewShadowAlpha = alpha;
+    
+    state->draggableBorderWidth = [coder decodeDoubleForKey:@"_draggableBorderWidth"];
+    
+    unsigned int flags = 0;
+    if ( [coder decodeBoolForKey:@"_bounceBackOnOverdraw"] ) flags |= SWRevealStateBounceBackOnOverdraw;
+    if ( [coder decodeBoolForKey:@"_bounceBackOnLeftOverdraw"] ) flags |= SWRevealStateBounceBackOnLeftOverdraw;
+    if ( [coder decodeBoolForKey:@"_stableDragOnOverdraw"] ) flags |= SWRevealStateStableDragOnOverdraw;
+    if ( [coder decodeBoolForKey:@"_stableDragOnLeftOverdraw"] ) flags |= SWRevealStateStableDragOnLeftOverdraw;
+    if ( [coder decodeBoolForKey:@"_presentFrontViewHierarchically"] ) flags |= SWRevealStatePresentFrontViewHierarchically;
+    if ( [coder decodeBoolForKey:@"_userInteractionStore"] ) flags |= SWRevealStateUserInteractionStore;
+    if ( [coder decodeBoolForKey:@"_clipsViewsToBounds"] ) flags |= SWRevealStateClipsViewsToBounds;
+    if ( [coder decodeBoolForKey:@"_extendsPointInsideHit"] ) flags |= SWRevealStateExtendsPointInsideHit;
+    state->flags = flags;
+    
+    state->toggleAnimationType = (int)[coder decodeIntegerForKey:@"_toggleAnimationType"];
+    state->dragResistanceType = (int)[coder decodeIntegerForKey:@"_dragResistanceType"];
+    state->frontViewPosition = [coder decodeIntForKey:@"_frontViewPosition"];
+}
+
+
 - (void)applicationFinishedRestoringState
 {
     // nothing to do at this stage
@@ -1824,10 +4662,7 @@ const int FrontViewPositionNone = 0xff;
 
 - (SWRevealViewController*)revealViewController
 {
-    UIViewController *parent = self;
-    Class revealClass = [SWRevealViewController class];
-    while ( nil != (parent = [parent parentViewController]) && ![parent isKindOfClass:revealClass] ) {}
-    return (id)parent;
+    return SWRevealControllerAbove( self, NULL );
 }
 
 @end
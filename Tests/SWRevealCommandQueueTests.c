@@ -0,0 +1,201 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealCommandQueue.h"
+#include "SWRevealTest.h"
+
+
+static int releases[1024];
+
+static void releaseObject( void *object )
+{
+    releases[(int *)object - releases] += 1;
+}
+
+
+static SWRevealCommand positionCommand( int position, unsigned int group )
+{
+    SWRevealCommand command = { SWRevealCommandSetPosition, group, position, 0.25, 0, 1, NULL, 0 };
+    return command;
+}
+
+
+static SWRevealCommand transitionCommand( int operation, unsigned int group, void *object )
+{
+    SWRevealCommand command = { SWRevealCommandTransition, group, 0, 0.25, operation, 1, object, 0 };
+    return command;
+}
+
+
+static void testCoalescing( void )
+{
+    SWRevealCommandQueue queue;
+    SWRevealCommandQueueInit( &queue, releaseObject );
+
+    SWRevealCommand command = positionCommand( 4, 0 );
+    SW_CHECK( SWRevealCommandQueueEnqueue( &queue, &command ) == SWRevealCommandExecuteNow );
+
+    // the command being executed is never coalesced, the pending ones collapse into the last target
+    command = positionCommand( 3, 0 );
+    SW_CHECK( SWRevealCommandQueueEnqueue( &queue, &command ) == SWRevealCommandQueued );
+    for ( int i=0 ; i<100 ; i++ )
+    {
+        command = positionCommand( 3 + (i & 1), 0 );
+        SW_CHECK( SWRevealCommandQueueEnqueue( &queue, &command ) == SWRevealCommandCoalesced );
+    }
+    SW_CHECK( SWRevealCommandQueueCount( &queue ) == 2 );
+    SW_CHECK( SWRevealCommandQueuePendingAtIndex( &queue, 0 )->position == 4 );
+
+    SW_CHECK( SWRevealCommandQueueDequeue( &queue )->position == 4 );
+    SW_CHECK( SWRevealCommandQueueDequeue( &queue ) == NULL );
+    SWRevealCommandQueueFree( &queue );
+}
+
+
+static void testGroups( void )
+{
+    SWRevealCommandQueue queue;
+    SWRevealCommandQueueInit( &queue, releaseObject );
+    releases[0] = releases[1] = 0;
+
+    SWRevealCommand command = positionCommand( 4, 0 );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+
+    // a pending group that did not start is superseded by a later one, releasing its objects
+    unsigned int group = SWRevealCommandQueueNewGroup( &queue );
+    command = positionCommand( 5, group );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+    command = transitionCommand( 2, group, &releases[0] );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+
+    group = SWRevealCommandQueueNewGroup( &queue );
+    command = positionCommand( 5, group );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+    command = transitionCommand( 2, group, &releases[1] );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+    SW_CHECK( SWRevealCommandQueueCount( &queue ) == 3 );
+    SW_CHECK( releases[0] == 1 && releases[1] == 0 );
+
+    // a group being executed can not be interrupted while it has pending steps
+    const SWRevealCommand *front = SWRevealCommandQueueDequeue( &queue );
+    SW_CHECK( front->group == group && front->position == 5 );
+    SW_CHECK( !SWRevealCommandQueueCanInterrupt( &queue ) );
+    SW_CHECK( SWRevealCommandQueueCancelPending( &queue ) == 0 );
+
+    SW_CHECK( SWRevealCommandQueueDequeue( &queue )->object == &releases[1] );
+    SW_CHECK( SWRevealCommandQueueDequeue( &queue ) == NULL );
+    SW_CHECK( releases[0] == 1 && releases[1] == 1 );
+    SWRevealCommandQueueFree( &queue );
+}
+
+
+static void testInterruptAndCancel( void )
+{
+    SWRevealCommandQueue queue;
+    SWRevealCommandQueueInit( &queue, releaseObject );
+    releases[0] = 0;
+
+    SWRevealCommand command = positionCommand( 4, 0 );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+    command = transitionCommand( 1, 0, &releases[0] );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+    command = positionCommand( 3, 0 );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+
+    // interrupting removes the pending position changes and keeps everything else in order
+    SW_CHECK( SWRevealCommandQueueCanInterrupt( &queue ) );
+    SWRevealCommand gesture = { SWRevealCommandGesture, 0, 0, 0.0, 0, 0, NULL, 0 };
+    SW_CHECK( SWRevealCommandQueueInterrupt( &queue, &gesture ) == 1 );
+    SW_CHECK( SWRevealCommandQueueCount( &queue ) == 2 );
+    SW_CHECK( SWRevealCommandQueueFront( &queue )->type == SWRevealCommandGesture );
+    SW_CHECK( SWRevealCommandQueuePendingAtIndex( &queue, 0 )->type == SWRevealCommandTransition );
+
+    SW_CHECK( SWRevealCommandQueueCancelPending( &queue ) == 1 );
+    SW_CHECK( releases[0] == 1 );
+    SW_CHECK( SWRevealCommandQueueDequeue( &queue ) == NULL );
+    SWRevealCommandQueueFree( &queue );
+}
+
+
+// Commands that can not be coalesced are never dropped, the ring grows and keeps their order across wraps
+static void testGrowth( void )
+{
+    SWRevealCommandQueue queue;
+    SWRevealCommandQueueInit( &queue, releaseObject );
+    for ( int i=0 ; i<1024 ; i++ ) releases[i] = 0;
+
+    int next = 0, expected = 0;
+    for ( int round=0 ; round<6 ; round++ )
+    {
+        // enqueue a burst larger than the ring, then drain part of it so that the head wraps before the next one
+        int burst = 40 << round;
+        for ( int i=0 ; i<burst && next<1024 ; i++, next++ )
+        {
+            SWRevealCommand command = transitionCommand( next, 0, &releases[next] );
+            SWRevealCommandEnqueueResult result = SWRevealCommandQueueEnqueue( &queue, &command );
+            SW_CHECK( result == (SWRevealCommandQueueCount( &queue ) == 1 ? SWRevealCommandExecuteNow : SWRevealCommandQueued) );
+        }
+        SW_CHECK( SWRevealCommandQueueCount( &queue ) == (unsigned int)(next - expected) );
+        SW_CHECK( (queue.capacity & (queue.capacity - 1)) == 0 && queue.capacity >= queue.count );
+
+        for ( int i=0 ; i<burst/3 ; i++ )
+        {
+            SW_CHECK( SWRevealCommandQueueFront( &queue )->operation == expected );
+            SWRevealCommandQueueDequeue( &queue );
+            expected += 1;
+        }
+    }
+    SW_CHECK( next == 1024 );
+
+    for ( const SWRevealCommand *front = SWRevealCommandQueueFront( &queue ) ; front != NULL ; expected++ )
+    {
+        SW_CHECK( front->operation == expected );
+        front = SWRevealCommandQueueDequeue( &queue );
+    }
+    SW_CHECK( expected == 1024 );
+
+    // every object was released exactly once
+    int once = 1;
+    for ( int i=0 ; i<1024 ; i++ ) once = once && releases[i] == 1;
+    SW_CHECK( once );
+
+    // clearing a grown queue releases the pending objects, freeing it releases the ring
+    SWRevealCommand command = transitionCommand( 0, 0, &releases[0] );
+    SWRevealCommandQueueEnqueue( &queue, &command );
+    SWRevealCommandQueueFree( &queue );
+    SW_CHECK( releases[0] == 2 );
+    SW_CHECK( queue.commands == NULL && queue.capacity == 0 && queue.count == 0 );
+    SWRevealCommandQueueFree( &queue );
+}
+
+
+int main( void )
+{
+    testCoalescing();
+    testGroups();
+    testInterruptAndCancel();
+    testGrowth();
+    return SW_TEST_RESULT();
+}
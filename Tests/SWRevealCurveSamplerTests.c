@@ -0,0 +1,99 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealCurveSampler.h"
+#include "SWRevealTest.h"
+
+
+static void makeCurve( SWRevealCurve *curve, int type, double duration, double velocity )
+{
+    if ( type == 0 )
+    {
+        SWRevealCurveInitEaseOut( curve, duration );
+        return;
+    }
+
+    double dampingRatio = type == 1 ? 0.5 : type == 2 ? 1.0 : 2.0;
+    double angularFrequency = SWRevealSpringAngularFrequencyForSettlingTime( dampingRatio, duration, SWRevealSpringDefaultTolerance );
+    SWRevealCurveInitSpring( curve, dampingRatio, angularFrequency, velocity, duration );
+}
+
+
+// Batch samples must match the curve evaluated at each frame time, up to the bezier solver tolerance, and end exactly at 1
+static void testSamplesMatchValues( void )
+{
+    static double values[SWRevealCurveMaxSamples];
+    const double frameIntervals[] = { 1/60.0, 1/90.0, 1/120.0, 1/30.0 };
+    double maxError = 0.0;
+    int badEnds = 0;
+
+    for ( int k=0 ; k<2000 ; k++ )
+    {
+        SWRevealCurve curve;
+        makeCurve( &curve, k % 4, 0.05 + (k % 37)*0.07, (k % 11) - 5.0 );
+        double frameInterval = frameIntervals[(k/4) % 4];
+        SW_CHECK( SWRevealCurveFitsSamples( &curve, frameInterval ) );
+
+        int count = SWRevealCurveSampleCount( &curve, frameInterval );
+        SWRevealCurveSample( &curve, frameInterval, values, count );
+        if ( values[count-1] != 1.0 || fabs( values[0] ) > 1e-12 ) badEnds += 1;
+
+        for ( int i=0 ; i<count-1 ; i++ )
+            maxError = fmax( maxError, fabs( values[i] - SWRevealCurveValue( &curve, i*frameInterval ) ) );
+    }
+    SW_CHECK( badEnds == 0 );
+    SW_CHECK_CLOSE( maxError, 0.0, 1e-8 );
+}
+
+
+// Curves longer than the sample table do not fit, their samples only cover the beginning
+static void testLongCurves( void )
+{
+    SWRevealCurve curve;
+    makeCurve( &curve, 1, 9.0, 0.0 );
+    SW_CHECK( SWRevealCurveFitsSamples( &curve, 1/60.0 ) );
+    SW_CHECK( !SWRevealCurveFitsSamples( &curve, 1/120.0 ) );
+    SW_CHECK( SWRevealCurveSampleCount( &curve, 1/120.0 ) == SWRevealCurveMaxSamples );
+
+    // exactly the largest duration that fits
+    makeCurve( &curve, 0, (SWRevealCurveMaxSamples-1)/120.0, 0.0 );
+    SW_CHECK( SWRevealCurveFitsSamples( &curve, 1/120.0 ) );
+    SW_CHECK( SWRevealCurveSampleCount( &curve, 1/120.0 ) == SWRevealCurveMaxSamples );
+
+    // evaluation covers the whole duration
+    makeCurve( &curve, 0, 30.0, 0.0 );
+    SW_CHECK( SWRevealCurveValue( &curve, 15.0 ) > 0.5 && SWRevealCurveValue( &curve, 15.0 ) < 1.0 );
+    SW_CHECK( SWRevealCurveValue( &curve, 30.0 ) == 1.0 );
+}
+
+
+int main( void )
+{
+    testSamplesMatchValues();
+    testLongCurves();
+    return SW_TEST_RESULT();
+}
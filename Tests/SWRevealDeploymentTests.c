@@ -0,0 +1,173 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealDeploymentModel.h"
+#include "SWRevealTest.h"
+
+
+static void testRules( void )
+{
+    SWRevealDeploymentStep step;
+
+    // loading at Left shows the front view, the sides stay closed
+    SWRevealFrontDeploymentStep( SWRevealPositionNone, SWRevealPositionLeft, 1, 1, &step );
+    SW_CHECK( step.position == SWRevealPositionLeft && step.appear && !step.disappear );
+    SWRevealRearDeploymentStep( SWRevealPositionNone, SWRevealPositionLeft, 1, 0, &step );
+    SW_CHECK( !step.appear && !step.disappear );
+
+    // opening and closing the rear side
+    SWRevealRearDeploymentStep( SWRevealPositionLeft, SWRevealPositionRight, 1, 0, &step );
+    SW_CHECK( step.appear && !step.disappear );
+    SWRevealRearDeploymentStep( SWRevealPositionRight, SWRevealPositionLeft, 1, 0, &step );
+    SW_CHECK( !step.appear && step.disappear );
+
+    // missing controllers keep the front view at Left, hierarchical presentation keeps the rear view deployed
+    SWRevealFrontDeploymentStep( SWRevealPositionLeft, SWRevealPositionRight, 0, 1, &step );
+    SW_CHECK( step.position == SWRevealPositionLeft );
+    SWRevealRightDeploymentStep( SWRevealPositionLeft, SWRevealPositionLeftSide, 0, &step );
+    SW_CHECK( step.position == SWRevealPositionLeft && !step.appear );
+    SWRevealRearDeploymentStep( SWRevealPositionNone, SWRevealPositionLeft, 1, 1, &step );
+    SW_CHECK( step.position == SWRevealPositionRight && step.appear );
+
+    // removed positions take the front view out and bring it back
+    SWRevealFrontDeploymentStep( SWRevealPositionRight, SWRevealPositionRightMostRemoved, 1, 1, &step );
+    SW_CHECK( !step.appear && step.disappear );
+    SWRevealFrontDeploymentStep( SWRevealPositionRightMostRemoved, SWRevealPositionLeft, 1, 1, &step );
+    SW_CHECK( step.appear && !step.disappear );
+}
+
+
+static void apply( SWRevealDeploymentModel *model, SWRevealModelEventType type, int position, int animated )
+{
+    SWRevealModelEvent event = { type, position, animated, 0 };
+    SW_CHECK( SWRevealDeploymentModelApply( model, &event ) == 0 );
+}
+
+
+static void testScriptedSequence( void )
+{
+    SWRevealDeploymentModel model;
+    SWRevealDeploymentModelInit( &model, 1, 1, 0, 0, SWRevealPositionLeft );
+    SW_CHECK( SWRevealDeploymentModelIsAtRest( &model ) );
+    SW_CHECK( model.stats.appears[SWRevealDeploymentSlotFront] == 1 && model.stats.appears[SWRevealDeploymentSlotRear] == 0 );
+
+    // an animated reveal shows the rear view right away, a second command waits for the animation
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionRight, 1 );
+    SW_CHECK( model.stats.appears[SWRevealDeploymentSlotRear] == 1 && !SWRevealDeploymentModelIsAtRest( &model ) );
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionLeft, 1 );
+    SW_CHECK( model.stats.commands == 1 );
+    apply( &model, SWRevealModelEventAnimationEnded, 0, 0 );
+    SW_CHECK( model.stats.commands == 2 && model.stats.disappears[SWRevealDeploymentSlotRear] == 0 );
+    apply( &model, SWRevealModelEventAnimationEnded, 0, 0 );
+    SW_CHECK( model.stats.disappears[SWRevealDeploymentSlotRear] == 1 && SWRevealDeploymentModelIsAtRest( &model ) );
+
+    // a pan interrupts a running animation and deploys the side it drags toward
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionRight, 1 );
+    apply( &model, SWRevealModelEventPanBegan, SWRevealPositionLeftSide, 0 );
+    SW_CHECK( model.stats.appears[SWRevealDeploymentSlotRight] == 1 );
+    apply( &model, SWRevealModelEventPanEnded, SWRevealPositionLeft, 0 );
+    SW_CHECK( SWRevealDeploymentModelIsAtRest( &model ) );
+
+    // an animated push moves the front view out and back in
+    apply( &model, SWRevealModelEventPush, 0, 1 );
+    while ( !SWRevealDeploymentModelIsAtRest( &model ) )
+        apply( &model, SWRevealModelEventAnimationEnded, 0, 0 );
+    SW_CHECK( model.slots[SWRevealDeploymentSlotFront].shown == model.slots[SWRevealDeploymentSlotFront].controller );
+
+    SW_CHECK( model.stats.doubleAppears == 0 && model.stats.unbalancedDisappears == 0 && model.stats.restMismatches == 0 );
+    SWRevealDeploymentModelFree( &model );
+}
+
+
+// Replaced controllers are only added to sides that are deployed, the next position change adds the others
+static void testReplacementsOnClosedSides( void )
+{
+    SWRevealDeploymentModel model;
+    SWRevealDeploymentModelInit( &model, 1, 1, 0, 1, SWRevealPositionLeft );
+
+    // open and close the rear side, its container is retained
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionRight, 0 );
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionLeft, 0 );
+    SW_CHECK( model.slots[SWRevealDeploymentSlotRear].containerLoaded );
+    unsigned long long rearAppears = model.stats.appears[SWRevealDeploymentSlotRear];
+
+    SWRevealModelEvent replace = { SWRevealModelEventReplaceRear, 0, 0, 0 };
+    SW_CHECK( SWRevealDeploymentModelApply( &model, &replace ) == 0 );
+    SW_CHECK( model.stats.appears[SWRevealDeploymentSlotRear] == rearAppears );
+    SW_CHECK( model.slots[SWRevealDeploymentSlotRear].shown == 0 );
+
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionRight, 0 );
+    SW_CHECK( model.stats.appears[SWRevealDeploymentSlotRear] == rearAppears+1 );
+    SW_CHECK( model.slots[SWRevealDeploymentSlotRear].shown == model.slots[SWRevealDeploymentSlotRear].controller );
+
+    // the same goes for a front controller replaced while the front view is removed
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionRightMostRemoved, 0 );
+    unsigned long long frontAppears = model.stats.appears[SWRevealDeploymentSlotFront];
+    apply( &model, SWRevealModelEventPush, 0, 0 );
+    SW_CHECK( model.stats.appears[SWRevealDeploymentSlotFront] == frontAppears );
+    apply( &model, SWRevealModelEventSetPosition, SWRevealPositionLeft, 0 );
+    SW_CHECK( model.stats.appears[SWRevealDeploymentSlotFront] == frontAppears+1 );
+
+    SW_CHECK( model.stats.doubleAppears == 0 && model.stats.unbalancedDisappears == 0 && model.stats.restMismatches == 0 );
+    SWRevealDeploymentModelFree( &model );
+}
+
+
+static void testRandomRuns( void )
+{
+    for ( int c=0 ; c<8 ; c++ )
+    {
+        SWRevealDeploymentModel model;
+        SWRevealDeploymentModelInit( &model, c & 1, (c >> 1) & 1, 0, (c >> 2) & 1, SWRevealPositionLeft );
+        SWRevealDeploymentModelRun( &model, 1000 + c, 200000 );
+
+        SW_CHECK( model.stats.commands > 0 );
+        SW_CHECK( model.stats.doubleAppears == 0 );
+        SW_CHECK( model.stats.unbalancedDisappears == 0 );
+        SW_CHECK( model.stats.restMismatches == 0 );
+        SWRevealDeploymentModelFree( &model );
+    }
+
+    // runs are reproducible from their seed
+    SWRevealDeploymentModel a, b;
+    SWRevealDeploymentModelInit( &a, 1, 1, 1, 0, SWRevealPositionLeft );
+    SWRevealDeploymentModelInit( &b, 1, 1, 1, 0, SWRevealPositionLeft );
+    SWRevealDeploymentModelRun( &a, 42, 50000 );
+    SWRevealDeploymentModelRun( &b, 42, 50000 );
+    SW_CHECK( a.stats.commands == b.stats.commands && a.stats.redundantCycles == b.stats.redundantCycles );
+    SW_CHECK( a.stats.doubleAppears == 0 && a.stats.unbalancedDisappears == 0 && a.stats.restMismatches == 0 );
+    SWRevealDeploymentModelFree( &a );
+    SWRevealDeploymentModelFree( &b );
+}
+
+
+int main( void )
+{
+    testRules();
+    testScriptedSequence();
+    testReplacementsOnClosedSides();
+    testRandomRuns();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealDetents.h"
+#include "SWRevealTest.h"
+
+
+// The preset stops must map the default positions to the detents the controller reports and animates to
+static void testPresetStops( void )
+{
+    SWRevealDetents detents;
+    SWRevealDetentSideInitWithRevealWidth( &detents.sides[0], 200, 0 );
+    SWRevealDetentSideInitWithRevealWidth( &detents.sides[1], 260, 60 );
+    SW_CHECK( detents.sides[0].count == 2 );
+    SW_CHECK( detents.sides[1].count == 3 );
+
+    SW_CHECK( SWRevealDetentSideIndexForOffset( &detents.sides[1], 0 ) == 0 );
+    SW_CHECK( SWRevealDetentSideIndexForOffset( &detents.sides[1], 260 ) == 1 );
+    SW_CHECK( SWRevealDetentSideIndexForOffset( &detents.sides[1], 320 ) == 2 );
+
+    // with no overdraw the most position rests on the reveal width stop
+    SW_CHECK( SWRevealDetentSideIndexForOffset( &detents.sides[0], 200 ) == 1 );
+
+    SW_CHECK( SWRevealDetentsPresetPosition( 0 ) == SWRevealPositionLeft );
+    SW_CHECK( SWRevealDetentsPresetPosition( 1 ) == SWRevealPositionRight );
+    SW_CHECK( SWRevealDetentsPresetPosition( 2 ) == SWRevealPositionRightMost );
+    SW_CHECK( SWRevealDetentsPresetPosition( -1 ) == SWRevealPositionLeftSide );
+
+    SW_CHECK_CLOSE( SWRevealDetentsLocation( &detents, 2 ), 320, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealDetentsLocation( &detents, -2 ), -200, 1e-9 );
+}
+
+
+static void testProgress( void )
+{
+    SWRevealDetents detents;
+    SWRevealDetentSideInitWithRevealWidth( &detents.sides[0], 200, 0 );
+    SWRevealDetentSideInitWithRevealWidth( &detents.sides[1], 260, 60 );
+
+    SW_CHECK_CLOSE( SWRevealDetentsProgress( &detents, 0 ), 0, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealDetentsProgress( &detents, 130 ), 0.5, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealDetentsProgress( &detents, 260 ), 1, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealDetentsProgress( &detents, 275 ), 1.25, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealDetentsProgress( &detents, 400 ), 2, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealDetentsProgress( &detents, -50 ), -0.25, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealDetentsProgress( &detents, -300 ), -1, 1e-9 );
+
+    // progress is monotonic across both sides
+    double last = -1e9;
+    int ordered = 1;
+    for ( double x=-300 ; x<=400 ; x+=0.5 )
+    {
+        double progress = SWRevealDetentsProgress( &detents, x );
+        if ( progress < last ) ordered = 0;
+        last = progress;
+    }
+    SW_CHECK( ordered );
+}
+
+
+int main( void )
+{
+    testPresetStops();
+    testProgress();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,133 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealDragResistance.h"
+#include "SWRevealTest.h"
+
+
+// The drag location adjustment of version 2.4, which the default linear clamp curve must reproduce
+static double legacyDragLocation( double x, double revealWidth, double revealOverdraw )
+{
+    if ( x <= revealWidth ) return x;
+    if ( x <= revealWidth + 2*revealOverdraw ) return revealWidth + (x-revealWidth)/2;
+    return revealWidth + revealOverdraw;
+}
+
+
+static double customCurve( double overshoot, void *context )
+{
+    double k = *(double *)context;
+    return overshoot*k;
+}
+
+
+static void testLinearClampMatchesLegacy( void )
+{
+    SWRevealResistanceCurve curve = { SWRevealResistanceCurveLinearClamp, 0.0, NULL, NULL };
+    SWRevealResistanceTable table;
+    SWRevealResistanceTableBake( &table, &curve, 260, 60, 0 );
+
+    for ( double x=0 ; x<600 ; x+=0.37 )
+        SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, x, 0 ), legacyDragLocation( x, 260, 60 ), 1e-9 );
+}
+
+
+static void testStableTrack( void )
+{
+    SWRevealResistanceCurve curve = { SWRevealResistanceCurveRubberBand, 0.0, NULL, NULL };
+    SWRevealResistanceTable table;
+
+    SWRevealResistanceTableBake( &table, &curve, 260, 60, 1 );
+    SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, 300, 0 ), 300, 0 );
+    SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, 400, 0 ), 320, 0 );
+
+    SWRevealResistanceTableBake( &table, &curve, 260, 60, 0 );
+    SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, 300, 1 ), 300, 0 );
+
+    // no overdraw means there is nothing to resist
+    SWRevealResistanceTableBake( &table, &curve, 260, 0, 0 );
+    SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, 300, 0 ), 260, 0 );
+}
+
+
+static void testAsymptoticCurves( void )
+{
+    SWRevealResistanceCurveType types[] = { SWRevealResistanceCurveRubberBand, SWRevealResistanceCurveExponential };
+    double parameters[] = { 0.55, 1.0 };
+
+    for ( int t=0 ; t<2 ; t++ )
+    {
+        SWRevealResistanceCurve curve = { types[t], 0.0, NULL, NULL };
+        SWRevealResistanceTable table;
+        SWRevealResistanceTableBake( &table, &curve, 200, 100, 0 );
+
+        double last = 0.0;
+        for ( double x=0 ; x<2000 ; x+=1.3 )
+        {
+            double location = SWRevealResistanceTableLookup( &table, x, 0 );
+            SW_CHECK( location >= last );
+            SW_CHECK( location <= 300 );
+            last = location;
+
+            // the table is interpolated linearly, so it is close to the curve inside its domain
+            double u = (x-200)/100;
+            if ( u > 0 && u < 8 )
+            {
+                double k = parameters[t];
+                double v = t == 0 ? 1.0 - 1.0/(u*k + 1.0) : 1.0 - exp( -u*k );
+                SW_CHECK_CLOSE( location, 200 + 100*v, 0.5 );
+            }
+        }
+    }
+}
+
+
+static void testCustomCurve( void )
+{
+    double k = 0.25;
+    SWRevealResistanceCurve curve = { SWRevealResistanceCurveCustom, 0.0, customCurve, &k };
+    SWRevealResistanceTable table;
+    SWRevealResistanceTableBake( &table, &curve, 100, 100, 0 );
+
+    SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, 200, 0 ), 125, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, 500, 0 ), 200, 1e-9 );
+
+    // values out of [0,1] are clamped
+    k = -1.0;
+    SWRevealResistanceTableBake( &table, &curve, 100, 100, 0 );
+    SW_CHECK_CLOSE( SWRevealResistanceTableLookup( &table, 200, 0 ), 100, 0 );
+}
+
+
+int main( void )
+{
+    testLinearClampMatchesLegacy();
+    testStableTrack();
+    testAsymptoticCurves();
+    testCustomCurve();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,174 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealDrawerGeometry.h"
+#include "SWRevealTest.h"
+
+
+static SWRevealResistanceTable tables[2];
+
+
+// Fills a config for the given sides and policies, with the tables baked as SWRevealView does
+static void makeConfig( SWRevealDrawerConfig *config, SWRevealDrawerSides sides, SWRevealOverdrawPolicy rearPolicy,
+    SWRevealOverdrawPolicy rightPolicy, SWRevealResistanceCurveType curveType )
+{
+    SWRevealResistanceCurve curve = { curveType, 0.0, NULL, NULL };
+    config->sides = sides;
+    config->rearPolicy = rearPolicy;
+    config->rightPolicy = rightPolicy;
+    config->revealWidth[0] = 200;
+    config->revealOverdraw[0] = 40;
+    config->revealWidth[1] = 260;
+    config->revealOverdraw[1] = 60;
+    config->quickFlickVelocity = 250;
+    config->decelerationRate = SWRevealFlingDefaultDecelerationRate;
+
+    for ( int i=0 ; i<2 ; i++ )
+    {
+        SWRevealOverdrawPolicy policy = i==0 ? rightPolicy : rearPolicy;
+        int stable = (policy & SWRevealOverdrawBounceBack) == 0 || (policy & SWRevealOverdrawStableDrag) != 0;
+        SWRevealResistanceTableBake( &tables[i], &curve, config->revealWidth[i], config->revealOverdraw[i], stable );
+        config->resistanceTables[i] = &tables[i];
+    }
+}
+
+
+// The drag adjustment as it was done with the tables alone, after clamping to the sides that are present
+static double referenceDragLocation( const SWRevealDrawerConfig *config, double x, int stableTrack )
+{
+    if ( (x < 0 && !(config->sides & SWRevealDrawerSidesRight)) || (x > 0 && !(config->sides & SWRevealDrawerSidesRear)) )
+        x = 0;
+
+    int symetry = x<0 ? -1 : 1;
+    return symetry*SWRevealResistanceTableLookup( config->resistanceTables[symetry<0 ? 0 : 1], x*symetry, stableTrack );
+}
+
+
+// The release rule of version 2.5 as it was written in the controller
+static SWRevealPosition referenceReleasePosition( const SWRevealDrawerConfig *config, double x, double velocity, double *pJourney )
+{
+    double projected = x + SWRevealFlingProjectedDistance( velocity, config->decelerationRate );
+    int symetry = x<0 ? -1 : 1;
+    int index = symetry<0 ? 0 : 1;
+    SWRevealOverdrawPolicy policy = index==0 ? config->rightPolicy : config->rearPolicy;
+    int bounceBack = (policy & SWRevealOverdrawBounceBack) != 0;
+    int stableDrag = (policy & SWRevealOverdrawStableDrag) != 0;
+    double revealWidth = config->revealWidth[index];
+    double revealOverdraw = config->revealOverdraw[index];
+
+    x *= symetry;
+    projected *= symetry;
+    int quickFlick = velocity*symetry > config->quickFlickVelocity;
+
+    SWRevealPosition position = SWRevealPositionLeft;
+    double journey = x;
+    if ( projected > revealWidth*0.5 )
+    {
+        position = SWRevealPositionRight;
+        journey = revealWidth - x;
+        if ( x > revealWidth && bounceBack && !quickFlick )
+            position = SWRevealPositionLeft, journey = x;
+        else if ( x > revealWidth && !bounceBack && stableDrag && projected > revealWidth+revealOverdraw*0.5 )
+            position = SWRevealPositionRightMost, journey = revealWidth+revealOverdraw - x;
+    }
+
+    *pJourney = fabs( journey );
+    return SWRevealAdjustedPosition( position, symetry );
+}
+
+
+static void testMatchesReference( void )
+{
+    const SWRevealDrawerSides sides[] = { SWRevealDrawerSidesRear, SWRevealDrawerSidesRight, SWRevealDrawerSidesBoth };
+    const SWRevealResistanceCurveType curves[] = { SWRevealResistanceCurveLinearClamp, SWRevealResistanceCurveRubberBand };
+
+    for ( int s=0 ; s<3 ; s++ )
+    for ( SWRevealOverdrawPolicy rear=0 ; rear<4 ; rear++ )
+    for ( SWRevealOverdrawPolicy right=0 ; right<4 ; right++ )
+    for ( int c=0 ; c<2 ; c++ )
+    {
+        SWRevealDrawerConfig config;
+        makeConfig( &config, sides[s], rear, right, curves[c] );
+
+        int dragMismatches = 0, releaseMismatches = 0;
+        for ( int i=0 ; i<2000 ; i++ )
+        {
+            double x = SWTestUniform( -400, 400 );
+            double velocity = SWTestUniform( -2000, 2000 );
+            int stableTrack = (i & 7) == 0;
+
+            double reference = referenceDragLocation( &config, x, stableTrack );
+            if ( fabs( SWRevealDrawerDragLocation( &config, x, stableTrack ) - reference ) > 1e-9 ) dragMismatches += 1;
+
+            // releases happen at front view locations, which are clamped to the sides that are present
+            double location = SWRevealDrawerClampedLocation( config.sides, x );
+            double journey, referenceJourney;
+            SWRevealPosition position = SWRevealDrawerReleasePosition( &config, location, velocity, &journey );
+            SWRevealPosition referencePosition = referenceReleasePosition( &config, location, velocity, &referenceJourney );
+            if ( position != referencePosition || fabs( journey - referenceJourney ) > 1e-9 ) releaseMismatches += 1;
+        }
+        SW_CHECK( dragMismatches == 0 );
+        SW_CHECK( releaseMismatches == 0 );
+    }
+}
+
+
+static void testReleaseDecisions( void )
+{
+    SWRevealDrawerConfig config;
+    makeConfig( &config, SWRevealDrawerSidesBoth, SWRevealOverdrawBounceBack, SWRevealOverdrawBounceBack, SWRevealResistanceCurveLinearClamp );
+    double journey;
+
+    // slow releases go to the closest stop, flicks are projected past the middle
+    SW_CHECK( SWRevealDrawerReleasePosition( &config, 100, 0, &journey ) == SWRevealPositionLeft );
+    SW_CHECK_CLOSE( journey, 100, 1e-9 );
+    SW_CHECK( SWRevealDrawerReleasePosition( &config, 140, 0, &journey ) == SWRevealPositionRight );
+    SW_CHECK_CLOSE( journey, 120, 1e-9 );
+    SW_CHECK( SWRevealDrawerReleasePosition( &config, 100, 200, &journey ) == SWRevealPositionRight );
+    SW_CHECK( SWRevealDrawerReleasePosition( &config, -150, 0, &journey ) == SWRevealPositionLeftSide );
+    SW_CHECK_CLOSE( journey, 50, 1e-9 );
+
+    // releases on the overdraw bounce back unless they are quick flicks outwards
+    SW_CHECK( SWRevealDrawerReleasePosition( &config, 280, 0, &journey ) == SWRevealPositionLeft );
+    SW_CHECK( SWRevealDrawerReleasePosition( &config, 280, 300, &journey ) == SWRevealPositionRight );
+    SW_CHECK_CLOSE( journey, 20, 1e-9 );
+
+    // stable drag sides rest at the most position past half the overdraw
+    makeConfig( &config, SWRevealDrawerSidesRear, SWRevealOverdrawStableDrag, SWRevealOverdrawFree, SWRevealResistanceCurveLinearClamp );
+    SW_CHECK( SWRevealDrawerReleasePosition( &config, 300, 0, &journey ) == SWRevealPositionRightMost );
+    SW_CHECK_CLOSE( journey, 20, 1e-9 );
+    SW_CHECK( SWRevealDrawerDragLocation( &config, 400, 0 ) == 320 );
+    SW_CHECK( SWRevealDrawerDragLocation( &config, -50, 0 ) == 0 );
+}
+
+
+int main( void )
+{
+    testMatchesReference();
+    testReleaseDecisions();
+    return SW_TEST_RESULT();
+}
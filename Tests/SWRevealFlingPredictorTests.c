@@ -0,0 +1,183 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealFlingPredictor.h"
+#include "SWRevealTest.h"
+
+
+// Replays a recorded trace of (time, location) pairs into a new predictor
+static void replay( SWRevealFlingPredictor *predictor, const SWRevealFlingSample *trace, int count )
+{
+    SWRevealFlingPredictorReset( predictor );
+    for ( int i=0 ; i<count ; i++ )
+        SWRevealFlingPredictorAddSample( predictor, trace[i].time, trace[i].location );
+}
+
+
+static double velocityOf( const SWRevealFlingPredictor *predictor, int *pValid )
+{
+    double velocity = 0.0;
+    *pValid = SWRevealFlingPredictorGetVelocity( predictor, SWRevealFlingDefaultWindow, SWRevealFlingDefaultHalfLife, &velocity );
+    return velocity;
+}
+
+
+static void testConstantVelocity( void )
+{
+    // a steady 800 points per second drag at 120 Hz, longer than the ring buffer
+    SWRevealFlingSample trace[40];
+    for ( int i=0 ; i<40 ; i++ )
+        trace[i] = (SWRevealFlingSample){ 10.0 + i/120.0, 50.0 + 800.0*i/120.0 };
+
+    SWRevealFlingPredictor predictor;
+    replay( &predictor, trace, 40 );
+    int valid;
+    SW_CHECK_CLOSE( velocityOf( &predictor, &valid ), 800.0, 1e-6 );
+    SW_CHECK( valid );
+}
+
+
+static void testShortTraces( void )
+{
+    SWRevealFlingPredictor predictor;
+    int valid;
+
+    // no samples and a single sample give no velocity
+    SWRevealFlingPredictorReset( &predictor );
+    velocityOf( &predictor, &valid );
+    SW_CHECK( !valid );
+
+    const SWRevealFlingSample single[] = { { 1.0, 100.0 } };
+    replay( &predictor, single, 1 );
+    velocityOf( &predictor, &valid );
+    SW_CHECK( !valid );
+
+    // two samples are enough, the slope is exact
+    const SWRevealFlingSample pair[] = { { 1.0, 100.0 }, { 1.01, 105.0 } };
+    replay( &predictor, pair, 2 );
+    SW_CHECK_CLOSE( velocityOf( &predictor, &valid ), 500.0, 1e-6 );
+    SW_CHECK( valid );
+
+    // samples older than the window are not used
+    const SWRevealFlingSample old[] = { { 1.0, 100.0 }, { 1.5, 105.0 } };
+    replay( &predictor, old, 2 );
+    velocityOf( &predictor, &valid );
+    SW_CHECK( !valid );
+}
+
+
+static void testDuplicateAndOutOfOrderTimestamps( void )
+{
+    SWRevealFlingPredictor predictor, expected;
+    int valid, expectedValid;
+
+    // a coalesced touch with the same timestamp replaces the last location instead of producing an infinite slope
+    const SWRevealFlingSample duplicate[] = { { 0.0, 0.0 }, { 0.01, 10.0 }, { 0.02, 20.0 }, { 0.02, 24.0 } };
+    const SWRevealFlingSample deduplicated[] = { { 0.0, 0.0 }, { 0.01, 10.0 }, { 0.02, 24.0 } };
+    replay( &predictor, duplicate, 4 );
+    replay( &expected, deduplicated, 3 );
+    double velocity = velocityOf( &predictor, &valid );
+    SW_CHECK( valid && isfinite( velocity ) );
+    SW_CHECK_CLOSE( velocity, velocityOf( &expected, &expectedValid ), 1e-9 );
+
+    // an earlier timestamp also replaces the last location, keeping its time
+    const SWRevealFlingSample outOfOrder[] = { { 0.0, 0.0 }, { 0.01, 10.0 }, { 0.02, 20.0 }, { 0.03, 30.0 }, { 0.025, 35.0 } };
+    const SWRevealFlingSample reordered[] = { { 0.0, 0.0 }, { 0.01, 10.0 }, { 0.02, 20.0 }, { 0.03, 35.0 } };
+    replay( &predictor, outOfOrder, 5 );
+    replay( &expected, reordered, 4 );
+    SW_CHECK_CLOSE( velocityOf( &predictor, &valid ), velocityOf( &expected, &expectedValid ), 1e-9 );
+    SW_CHECK( valid );
+
+    // all samples at the same time collapse into one, which gives no velocity
+    const SWRevealFlingSample frozen[] = { { 0.5, 0.0 }, { 0.5, 10.0 }, { 0.5, 20.0 } };
+    replay( &predictor, frozen, 3 );
+    velocityOf( &predictor, &valid );
+    SW_CHECK( !valid );
+}
+
+
+static void testStalledFinger( void )
+{
+    // a fast drag, then the finger rests before lifting
+    SWRevealFlingSample trace[60];
+    int count = 0;
+    for ( int i=0 ; i<30 ; i++, count++ )
+        trace[count] = (SWRevealFlingSample){ i/120.0, 1500.0*i/120.0 };
+    double stopTime = trace[count-1].time, stopLocation = trace[count-1].location;
+
+    SWRevealFlingPredictor predictor;
+    int valid;
+
+    // a brief pause lowers the velocity but keeps its direction
+    for ( int i=1 ; i<=3 ; i++, count++ )
+        trace[count] = (SWRevealFlingSample){ stopTime + i/120.0, stopLocation };
+    replay( &predictor, trace, count );
+    double velocity = velocityOf( &predictor, &valid );
+    SW_CHECK( valid && velocity > 0.0 && velocity < 1500.0 );
+
+    // once the whole window is stalled there is no velocity left
+    for ( int i=4 ; i<=20 ; i++, count++ )
+        trace[count] = (SWRevealFlingSample){ stopTime + i/120.0, stopLocation };
+    replay( &predictor, trace, count );
+    SW_CHECK_CLOSE( velocityOf( &predictor, &valid ), 0.0, 1e-9 );
+    SW_CHECK( valid );
+}
+
+
+static void testJitter( void )
+{
+    // a 600 points per second drag with up to 1.5 points of noise on each sample, the fit stays close while the
+    // velocity of the last two samples can be off by hundreds of points per second
+    SWRevealFlingSample trace[24];
+    for ( int i=0 ; i<24 ; i++ )
+        trace[i] = (SWRevealFlingSample){ i/120.0, 600.0*i/120.0 + SWTestUniform( -1.5, 1.5 ) };
+
+    SWRevealFlingPredictor predictor;
+    replay( &predictor, trace, 24 );
+    int valid;
+    SW_CHECK_CLOSE( velocityOf( &predictor, &valid ), 600.0, 60.0 );
+}
+
+
+static void testProjectedDistance( void )
+{
+    SW_CHECK_CLOSE( SWRevealFlingProjectedDistance( 1000.0, SWRevealFlingDefaultDecelerationRate ), 499.0, 1e-6 );
+    SW_CHECK_CLOSE( SWRevealFlingProjectedDistance( -1000.0, SWRevealFlingDefaultDecelerationRate ), -499.0, 1e-6 );
+    SW_CHECK( SWRevealFlingProjectedDistance( 0.0, SWRevealFlingDefaultDecelerationRate ) == 0.0 );
+}
+
+
+int main( void )
+{
+    testConstantVelocity();
+    testShortTraces();
+    testDuplicateAndOutOfOrderTimestamps();
+    testStalledFinger();
+    testJitter();
+    testProjectedDistance();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,99 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealFrameStats.h"
+#include "SWRevealTest.h"
+
+
+static void testFramePacing( void )
+{
+    double budget = 1.0/60.0;
+    SWRevealFrameStats stats;
+    SWRevealFrameStatsReset( &stats, budget );
+
+    // 60 regular frames with a little jitter, then a single frame taking three intervals
+    double t = 10.0;
+    for ( int i=0 ; i<60 ; i++ )
+    {
+        SWRevealFrameStatsAddFrame( &stats, t );
+        t += budget + (i % 2 ? 0.0005 : -0.0005);
+    }
+    t += 2*budget;
+    SWRevealFrameStatsAddFrame( &stats, t );
+
+    SW_CHECK( stats.frameIntervals.count == 60 );
+    SW_CHECK( stats.framesOverBudget == 1 );
+    SW_CHECK( stats.missedFrames == 2 );
+    SW_CHECK_CLOSE( stats.frameIntervals.max, 3*budget + 0.0005, 1e-9 );
+    SW_CHECK_CLOSE( SWRevealFrameHistogramMean( &stats.frameIntervals ), (t-10.0)/60, 1e-9 );
+
+    // the median lies in the bucket of a regular interval, the maximum is reported past the last sample
+    double median = SWRevealFrameHistogramPercentile( &stats.frameIntervals, 0.5 );
+    SW_CHECK( median >= budget && median <= budget + budget/8 );
+    SW_CHECK_CLOSE( SWRevealFrameHistogramPercentile( &stats.frameIntervals, 1.0 ), stats.frameIntervals.max, 0 );
+}
+
+
+static void testWorkDurations( void )
+{
+    double budget = 0.008;
+    SWRevealFrameStats stats;
+    SWRevealFrameStatsReset( &stats, budget );
+
+    for ( int i=0 ; i<100 ; i++ )
+        SWRevealFrameStatsAddWork( &stats, i < 90 ? 0.001 : 0.012 );
+
+    SW_CHECK( stats.workDurations.count == 100 );
+    SW_CHECK( stats.workOverBudget == 10 );
+    SW_CHECK_CLOSE( SWRevealFrameHistogramPercentile( &stats.workDurations, 0.9 ), 0.001, 1e-12 );
+    SW_CHECK_CLOSE( SWRevealFrameHistogramPercentile( &stats.workDurations, 0.95 ), 0.012, 1e-12 );
+
+    // durations far past the histogram range land in the last bucket, negative ones in the first
+    SWRevealFrameStatsAddWork( &stats, 10.0 );
+    SWRevealFrameStatsAddWork( &stats, -1.0 );
+    SW_CHECK( stats.workDurations.counts[SWRevealFrameHistogramBuckets-1] == 1 );
+    SW_CHECK( stats.workDurations.counts[0] >= 91 );
+}
+
+
+static void testEmptyStats( void )
+{
+    SWRevealFrameStats stats;
+    SWRevealFrameStatsReset( &stats, 1.0/120.0 );
+    SWRevealFrameStatsAddFrame( &stats, 1.0 );
+
+    SW_CHECK( stats.frameIntervals.count == 0 );
+    SW_CHECK_CLOSE( SWRevealFrameHistogramMean( &stats.frameIntervals ), 0, 0 );
+    SW_CHECK_CLOSE( SWRevealFrameHistogramPercentile( &stats.workDurations, 0.99 ), 0, 0 );
+}
+
+
+int main( void )
+{
+    testFramePacing();
+    testWorkDurations();
+    testEmptyStats();
+    return SW_TEST_RESULT();
+}
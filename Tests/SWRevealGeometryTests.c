@@ -0,0 +1,165 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealGeometry.h"
+#include "SWRevealTest.h"
+
+
+// The rear and right frame computation of version 2.4, written out with the original scaledValue function
+static double legacyScaledValue( double v1, double min2, double max2, double min1, double max1 )
+{
+    double result = min2 + (v1-min1)*((max2-min2)/(max1-min1));
+    if ( result != result ) return min2;
+    if ( result < min2 ) return min2;
+    if ( result > max2 ) return max2;
+    return result;
+}
+
+
+static void legacyFrames( const SWRevealGeometryConfig *c, double x, SWRevealLayoutFrames *f )
+{
+    double rearWidth = SWRevealResolvedWidth( c->rearRevealWidth, c->boundsWidth );
+    double rightWidth = SWRevealResolvedWidth( c->rightRevealWidth, c->boundsWidth );
+
+    f->front = (SWRevealRect){ x, c->frontOffsetY, c->boundsWidth, c->boundsHeight - c->frontOffsetY };
+    f->rear = (SWRevealRect){ legacyScaledValue( x, -c->rearRevealDisplacement, 0, 0, rearWidth ), 0,
+        rearWidth + c->rearRevealOverdraw, c->boundsHeight };
+
+    double rightXLocation = legacyScaledValue( x, 0, c->rightRevealDisplacement, -rightWidth, 0 );
+    double rightTotalWidth = rightWidth + c->rightRevealOverdraw;
+    f->right = (SWRevealRect){ c->boundsWidth - rightTotalWidth + rightXLocation, 0, rightTotalWidth, c->boundsHeight };
+}
+
+
+static void checkRect( SWRevealRect a, SWRevealRect b )
+{
+    SW_CHECK_CLOSE( a.x, b.x, 1e-9 );
+    SW_CHECK_CLOSE( a.y, b.y, 1e-9 );
+    SW_CHECK_CLOSE( a.width, b.width, 1e-9 );
+    SW_CHECK_CLOSE( a.height, b.height, 1e-9 );
+}
+
+
+static void testFramesMatchLegacy( void )
+{
+    for ( int n=0 ; n<200 ; n++ )
+    {
+        SWRevealGeometryConfig config =
+        {
+            SWTestUniform( 200, 1200 ), SWTestUniform( 300, 1400 ),
+            n % 3 == 0 ? -SWTestUniform( 20, 100 ) : SWTestUniform( 50, 300 ), SWTestUniform( 0, 100 ), SWTestUniform( 0, 80 ),
+            n % 4 == 0 ? -SWTestUniform( 20, 100 ) : SWTestUniform( 50, 300 ), SWTestUniform( 0, 100 ), SWTestUniform( 0, 80 ),
+            n % 2 ? 64 : 0,
+        };
+
+        double locations[64];
+        SWRevealLayoutFrames frames[64];
+        for ( int i=0 ; i<64 ; i++ )
+            locations[i] = SWTestUniform( -config.boundsWidth, config.boundsWidth );
+
+        SWRevealGetLayoutFramesBatch( &config, locations, frames, 64 );
+
+        for ( int i=0 ; i<64 ; i++ )
+        {
+            SWRevealLayoutFrames single, legacy;
+            SWRevealGetLayoutFrames( &config, locations[i], &single );
+            legacyFrames( &config, locations[i], &legacy );
+
+            checkRect( frames[i].front, single.front );
+            checkRect( frames[i].rear, single.rear );
+            checkRect( frames[i].right, single.right );
+            checkRect( single.front, legacy.front );
+            checkRect( single.rear, legacy.rear );
+            checkRect( single.right, legacy.right );
+        }
+    }
+}
+
+
+static void testZeroRevealWidth( void )
+{
+    // the legacy scaling is undefined for a zero width and falls back to the minimum, without nans
+    SWRevealGeometryConfig config = { 320, 568, 0, 60, 40, 0, 60, 0, 0 };
+    double locations[] = { -100, 0, 100 };
+    SWRevealLayoutFrames frames[3];
+    SWRevealGetLayoutFramesBatch( &config, locations, frames, 3 );
+
+    for ( int i=0 ; i<3 ; i++ )
+    {
+        SW_CHECK( frames[i].rear.x == frames[i].rear.x );
+        SW_CHECK( frames[i].right.x == frames[i].right.x );
+    }
+}
+
+
+static void testFrontLocations( void )
+{
+    SWRevealGeometryConfig config = { 320, 568, 260, 60, 40, -100, 50, 40, 0 };
+    double expected[] = { -270, -270, -220, 0, 260, 320, 320 };
+
+    for ( int p=SWRevealPositionLeftSideMostRemoved ; p<=SWRevealPositionRightMostRemoved ; p++ )
+        SW_CHECK_CLOSE( SWRevealFrontLocationForPosition( &config, (SWRevealPosition)p ), expected[p], 1e-9 );
+
+    SW_CHECK( SWRevealAdjustedPosition( SWRevealPositionLeftSide, -1 ) == SWRevealPositionRight );
+    SW_CHECK( SWRevealAdjustedPosition( SWRevealPositionLeftSideMost, -1 ) == SWRevealPositionRightMost );
+    SW_CHECK( SWRevealAdjustedPosition( SWRevealPositionRight, 1 ) == SWRevealPositionRight );
+}
+
+
+static void testMetricsAndDirtyState( void )
+{
+    SWRevealWidthProfile profile = { -60, 40, 200, 30 };
+    SWRevealMetrics metrics = { 0 };
+    SWRevealMetricsResolveWidths( &metrics, &profile, 320, 480 );
+    SW_CHECK_CLOSE( metrics.rearRevealWidth, 260, 0 );
+    SW_CHECK_CLOSE( metrics.rightRevealWidth, 200, 0 );
+    SW_CHECK_CLOSE( metrics.rearRevealOverdraw, 40, 0 );
+
+    SWRevealLayoutState a = { 320, 480, SWRevealPositionLeft, 260, 60, 40, 260, 60, 40, 0, 1 };
+    SWRevealLayoutState b = a;
+    SW_CHECK( SWRevealLayoutStateDiff( &a, &b ) == SWRevealLayoutDirtyNone );
+
+    b.position = SWRevealPositionRight;
+    SW_CHECK( SWRevealLayoutStateDiff( &a, &b ) == (SWRevealLayoutDirtyLocation|SWRevealLayoutDirtyRearFrames|SWRevealLayoutDirtyFrontFrame) );
+
+    b = a, b.rearRevealDisplacement = 20;
+    SW_CHECK( SWRevealLayoutStateDiff( &a, &b ) == SWRevealLayoutDirtyRearFrames );
+
+    b = a, b.presentFrontViewHierarchically = 1;
+    SW_CHECK( SWRevealLayoutStateDiff( &a, &b ) == (SWRevealLayoutDirtyFrontOffset|SWRevealLayoutDirtyFrontFrame|SWRevealLayoutDirtyShadowPath) );
+
+    b = a, b.boundsWidth = 480;
+    SW_CHECK( SWRevealLayoutStateDiff( &a, &b ) == SWRevealLayoutDirtyAll );
+}
+
+
+int main( void )
+{
+    testFramesMatchLegacy();
+    testZeroRevealWidth();
+    testFrontLocations();
+    testMetricsAndDirtyState();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,279 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <string.h>
+
+#include "SWRevealGestureTrace.h"
+#include "SWRevealTest.h"
+
+
+enum
+{
+    TraceHeaderSize = 5,
+    TraceConfigSize = 100,
+    TraceEventSize = 13,
+    TraceConfigPositionOffset = 81,
+    TraceConfigResistanceOffset = 91,
+    TraceMaxSteps = 64,
+};
+
+typedef struct
+{
+    SWRevealTraceReplayStep steps[TraceMaxSteps];
+    int count;
+
+} TraceCollector;
+
+// Recorder length after each record and the number of gestures begun by then
+typedef struct
+{
+    size_t lengths[TraceMaxSteps];
+    int gestures[TraceMaxSteps];
+    int count;
+
+} TraceBoundaries;
+
+
+static void collectStep( const SWRevealTraceReplayStep *step, void *context )
+{
+    TraceCollector *collector = context;
+    if ( collector->count < TraceMaxSteps ) collector->steps[collector->count] = *step;
+    collector->count += 1;
+}
+
+
+static void markBoundary( TraceBoundaries *boundaries, const SWRevealTraceRecorder *recorder, int gestures )
+{
+    boundaries->lengths[boundaries->count] = recorder->length;
+    boundaries->gestures[boundaries->count] = gestures;
+    boundaries->count += 1;
+}
+
+
+static SWRevealTraceConfig sampleConfig( SWRevealPosition position )
+{
+    SWRevealTraceConfig config =
+    {
+        { 320, 568, 260, 60, 40, 260, 60, 40, 0 }, position, 250, 1, 0, 1, 0, 1, 1,
+        SWRevealResistanceCurveLinearClamp, 0,
+    };
+    return config;
+}
+
+
+// Records a fling that opens the rear view and a slow drag back released in place. Times, locations and velocities are
+// all exactly representable as float so they must survive the round trip unchanged
+static void recordSample( SWRevealTraceRecorder *recorder, TraceBoundaries *boundaries )
+{
+    SWRevealTraceConfig config = sampleConfig( SWRevealPositionLeft );
+    boundaries->count = 0;
+
+    SW_CHECK( SWRevealTraceRecorderInit( recorder, 16 ) );
+    markBoundary( boundaries, recorder, 0 );
+
+    SW_CHECK( SWRevealTraceRecorderBeginGesture( recorder, &config, 100.0 ) );
+    markBoundary( boundaries, recorder, 1 );
+    SW_CHECK( SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseBegan, 100.0, 0, 0 ) );
+    markBoundary( boundaries, recorder, 1 );
+    for ( int i=1 ; i<16 ; i++ )
+    {
+        SW_CHECK( SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseMoved, 100.0 + i/128.0, i*16.0, 2048 ) );
+        markBoundary( boundaries, recorder, 1 );
+    }
+    SW_CHECK( SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseEnded, 100.0 + 16/128.0, 256, 2048 ) );
+    markBoundary( boundaries, recorder, 1 );
+
+    config = sampleConfig( SWRevealPositionRight );
+    SW_CHECK( SWRevealTraceRecorderBeginGesture( recorder, &config, 200.0 ) );
+    markBoundary( boundaries, recorder, 2 );
+    SW_CHECK( SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseBegan, 200.0, 260, 0 ) );
+    markBoundary( boundaries, recorder, 2 );
+    for ( int i=1 ; i<8 ; i++ )
+    {
+        SW_CHECK( SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseMoved, 200.0 + i*0.25, 260 - i*0.5, -2 ) );
+        markBoundary( boundaries, recorder, 2 );
+    }
+    SW_CHECK( SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseEnded, 202.0, 256, -2 ) );
+    markBoundary( boundaries, recorder, 2 );
+}
+
+
+static int replayBytes( const unsigned char *bytes, size_t length, TraceCollector *collector )
+{
+    collector->count = 0;
+    return SWRevealTraceReplay( bytes, length, collectStep, collector );
+}
+
+
+static void testRoundTrip( void )
+{
+    SWRevealTraceRecorder recorder;
+    TraceBoundaries boundaries;
+    recordSample( &recorder, &boundaries );
+
+    // the recorder grew past its initial capacity and wrote fixed size records
+    SW_CHECK( recorder.length == TraceHeaderSize + 2*TraceConfigSize + 26*TraceEventSize );
+    SW_CHECK( recorder.capacity >= recorder.length );
+
+    TraceCollector collector;
+    SW_CHECK( replayBytes( recorder.bytes, recorder.length, &collector ) == 2 );
+    SW_CHECK( collector.count == 26 );
+
+    // first gesture, times are relative to the gesture start
+    for ( int i=0 ; i<17 ; i++ )
+    {
+        const SWRevealTraceReplayStep *step = &collector.steps[i];
+        SW_CHECK( step->gesture == 0 );
+        SW_CHECK( step->event.phase == (i == 0 ? SWRevealTracePhaseBegan : i == 16 ? SWRevealTracePhaseEnded : SWRevealTracePhaseMoved) );
+        SW_CHECK( step->event.time == i/128.0 );
+        SW_CHECK( step->event.location == i*16.0 );
+        SW_CHECK( step->event.velocity == (i == 0 ? 0 : 2048) );
+    }
+
+    // second gesture
+    for ( int i=0 ; i<9 ; i++ )
+    {
+        const SWRevealTraceReplayStep *step = &collector.steps[17+i];
+        SW_CHECK( step->gesture == 1 );
+        SW_CHECK( step->event.phase == (i == 0 ? SWRevealTracePhaseBegan : i == 8 ? SWRevealTracePhaseEnded : SWRevealTracePhaseMoved) );
+        SW_CHECK( step->event.time == i*0.25 );
+        SW_CHECK( step->event.location == (i == 8 ? 256 : 260 - i*0.5) );
+        SW_CHECK( step->event.velocity == (i == 0 ? 0 : -2) );
+    }
+
+    // the fling opens the rear view, the slow drag back is released where it started
+    const SWRevealTraceReplayStep *fling = &collector.steps[16];
+    SW_CHECK( fling->finalPosition == SWRevealPositionRight );
+    SW_CHECK( fling->releaseVelocity > 250 );
+
+    const SWRevealTraceReplayStep *drag = &collector.steps[25];
+    SW_CHECK( drag->finalPosition == SWRevealPositionRight );
+    SW_CHECK( drag->releaseVelocity > -250 && drag->releaseVelocity < 0 );
+
+    // replay is deterministic
+    TraceCollector again;
+    SW_CHECK( replayBytes( recorder.bytes, recorder.length, &again ) == 2 );
+    SW_CHECK( again.count == collector.count );
+    SW_CHECK( memcmp( again.steps, collector.steps, sizeof collector.steps[0] * collector.count ) == 0 );
+
+    // replay without a callback still validates and counts gestures
+    SW_CHECK( SWRevealTraceReplay( recorder.bytes, recorder.length, NULL, NULL ) == 2 );
+
+    SWRevealTraceRecorderFree( &recorder );
+    SW_CHECK( recorder.bytes == NULL && recorder.length == 0 && recorder.capacity == 0 );
+}
+
+
+static void testEmptyTrace( void )
+{
+    SWRevealTraceRecorder recorder;
+    SW_CHECK( SWRevealTraceRecorderInit( &recorder, 0 ) );
+    SW_CHECK( recorder.length == TraceHeaderSize );
+
+    TraceCollector collector;
+    SW_CHECK( replayBytes( recorder.bytes, recorder.length, &collector ) == 0 );
+    SW_CHECK( collector.count == 0 );
+    SWRevealTraceRecorderFree( &recorder );
+}
+
+
+static void testTruncated( void )
+{
+    SWRevealTraceRecorder recorder;
+    TraceBoundaries boundaries;
+    recordSample( &recorder, &boundaries );
+
+    // a trace cut on a record boundary replays the complete records, anywhere else it is rejected
+    int b = 0;
+    TraceCollector collector;
+    for ( size_t length=0 ; length<recorder.length ; length++ )
+    {
+        while ( b < boundaries.count && boundaries.lengths[b] < length ) b++;
+        int onBoundary = b < boundaries.count && boundaries.lengths[b] == length;
+
+        int result = replayBytes( recorder.bytes, length, &collector );
+        if ( onBoundary )
+        {
+            SW_CHECK( result == boundaries.gestures[b] );
+            SW_CHECK( collector.count == (int)((length - TraceHeaderSize - boundaries.gestures[b]*TraceConfigSize) / TraceEventSize) );
+        }
+        else
+        {
+            SW_CHECK( result == -1 );
+        }
+    }
+
+    SWRevealTraceRecorderFree( &recorder );
+}
+
+
+static int replayCorrupted( const SWRevealTraceRecorder *recorder, size_t offset, unsigned char value )
+{
+    unsigned char bytes[TraceHeaderSize + 2*TraceConfigSize + 26*TraceEventSize];
+    memcpy( bytes, recorder->bytes, recorder->length );
+    bytes[offset] = value;
+    return SWRevealTraceReplay( bytes, recorder->length, NULL, NULL );
+}
+
+
+static void testCorrupted( void )
+{
+    SWRevealTraceRecorder recorder;
+    TraceBoundaries boundaries;
+    recordSample( &recorder, &boundaries );
+
+    const size_t config = TraceHeaderSize;
+    const size_t event = TraceHeaderSize + TraceConfigSize;
+    const size_t secondConfig = TraceHeaderSize + TraceConfigSize + 17*TraceEventSize;
+
+    SW_CHECK( replayCorrupted( &recorder, 0, 'X' ) == -1 );                                     // <-- magic
+    SW_CHECK( replayCorrupted( &recorder, 4, SWRevealGestureTraceVersion+1 ) == -1 );          // <-- version
+    SW_CHECK( replayCorrupted( &recorder, config, 0xC1 ) == -1 );                               // <-- config tag
+    SW_CHECK( replayCorrupted( &recorder, secondConfig, 0x00 ) == -1 );                         // <-- config read as an event
+    SW_CHECK( replayCorrupted( &recorder, event, SWRevealTracePhaseCancelled+1 ) == -1 );      // <-- event phase
+    SW_CHECK( replayCorrupted( &recorder, config + TraceConfigPositionOffset, 0x7F ) == -1 );
+    SW_CHECK( replayCorrupted( &recorder, config + TraceConfigResistanceOffset, 0x7F ) == -1 );
+
+    // a recognized phase in place of another is well formed
+    SW_CHECK( replayCorrupted( &recorder, event, SWRevealTracePhaseCancelled ) == 2 );
+
+    // events are only valid after a configuration
+    unsigned char orphan[TraceHeaderSize + TraceEventSize];
+    memcpy( orphan, recorder.bytes, TraceHeaderSize );
+    memcpy( orphan + TraceHeaderSize, recorder.bytes + event, TraceEventSize );
+    SW_CHECK( SWRevealTraceReplay( orphan, sizeof orphan, NULL, NULL ) == -1 );
+
+    SWRevealTraceRecorderFree( &recorder );
+}
+
+
+int main( void )
+{
+    testRoundTrip();
+    testEmptyTrace();
+    testTruncated();
+    testCorrupted();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,145 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include "SWRevealGestureZones.h"
+#include "SWRevealTest.h"
+
+
+// Mask of the rectangles covering a point, including their top left edges but not their bottom right ones
+static unsigned int referenceMask( const SWRevealIndexedRect *rects, unsigned int count, double x, double y )
+{
+    unsigned int mask = 0;
+    for ( unsigned int i=0 ; i<count ; i++ )
+    {
+        const SWRevealRect *r = &rects[i].rect;
+        if ( r->width > 0 && r->height > 0 && x >= r->x && x < r->x + r->width && y >= r->y && y < r->y + r->height )
+            mask |= rects[i].mask;
+    }
+    return mask;
+}
+
+
+static void testIndexMatchesReference( void )
+{
+    SWRevealIndexedRect rects[12];
+    int mismatches = 0;
+
+    for ( int k=0 ; k<200 ; k++ )
+    {
+        unsigned int count = 1 + SWTestRandom() % 12;
+        for ( unsigned int i=0 ; i<count ; i++ )
+        {
+            // coarse coordinates so that edges are often shared and hit exactly
+            rects[i].rect = (SWRevealRect){ SWTestRandom() % 20 * 10.0, SWTestRandom() % 20 * 10.0,
+                SWTestRandom() % 10 * 10.0, SWTestRandom() % 10 * 10.0 };
+            rects[i].mask = 1u << (SWTestRandom() % 3);
+        }
+
+        SWRevealZoneIndex index = { 0 };
+        SW_CHECK( SWRevealZoneIndexBuild( &index, rects, count ) == 0 );
+        for ( int i=0 ; i<400 ; i++ )
+        {
+            double x = (SWTestRandom() % 60)*5.0 - 10.0;
+            double y = (SWTestRandom() % 60)*5.0 - 10.0;
+            if ( SWRevealZoneIndexLookup( &index, x, y ) != referenceMask( rects, count, x, y ) ) mismatches += 1;
+        }
+        SWRevealZoneIndexFree( &index );
+    }
+    SW_CHECK( mismatches == 0 );
+}
+
+
+static void testEmptyIndex( void )
+{
+    SWRevealZoneIndex index = { 0 };
+    SW_CHECK( SWRevealZoneIndexLookup( &index, 0, 0 ) == 0 );
+
+    // rectangles with no area are ignored
+    SWRevealIndexedRect rects[2] = { { { 0, 0, 0, 100 }, 1 }, { { 10, 10, 50, 0 }, 2 } };
+    SW_CHECK( SWRevealZoneIndexBuild( &index, rects, 2 ) == 0 );
+    SW_CHECK( SWRevealZoneIndexLookup( &index, 0, 50 ) == 0 );
+    SW_CHECK( SWRevealZoneIndexLookup( &index, 20, 10 ) == 0 );
+    SWRevealZoneIndexFree( &index );
+    SW_CHECK( SWRevealZoneIndexLookup( &index, 0, 0 ) == 0 );
+}
+
+
+static void testEmptyMap( void )
+{
+    SWRevealZoneMap map;
+    SWRevealZoneMapInit( &map );
+
+    // a map with no zones allows everything, compiled or not
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 10, 10 ) );
+    SWRevealZoneMapCompile( &map, 320, 480 );
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 10, 10 ) );
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionRight, -5, 1000 ) );
+    SWRevealZoneMapFree( &map );
+}
+
+
+static void testMapZones( void )
+{
+    SWRevealZoneMap map;
+    SWRevealZoneMapInit( &map );
+
+    // a 44 point bar at the top excluded in every position, and a 20 point strip along the right edge allowed when closed
+    SWRevealZone bar = { { 0, 0, 0, 44 }, SWRevealZoneExclude, SWRevealZoneEdgeLeft, 0 };
+    SWRevealZone strip = { { 0, 0, 20, 0 }, SWRevealZoneAllow, SWRevealZoneEdgeRight, SWRevealZonePositionMask(SWRevealPositionLeft) };
+    SW_CHECK( SWRevealZoneMapAdd( &map, &bar ) == 0 );
+    SW_CHECK( SWRevealZoneMapAdd( &map, &strip ) == 0 );
+    SWRevealZoneMapCompile( &map, 320, 480 );
+
+    // exclude zones take precedence over allow zones
+    SW_CHECK( !SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 310, 20 ) );
+    SW_CHECK( !SWRevealZoneMapAllows( &map, SWRevealPositionRight, 100, 20 ) );
+
+    // positions with allow zones only allow them, others allow anything not excluded
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 310, 200 ) );
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 300, 200 ) );
+    SW_CHECK( !SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 299, 200 ) );
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionRight, 100, 200 ) );
+
+    // right edge zones follow the width when compiled again for another size
+    SWRevealZoneMapCompile( &map, 480, 320 );
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 470, 200 ) );
+    SW_CHECK( !SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 310, 200 ) );
+
+    // removing the zones allows everything again once compiled
+    SWRevealZoneMapRemoveAll( &map );
+    SWRevealZoneMapCompile( &map, 480, 320 );
+    SW_CHECK( SWRevealZoneMapAllows( &map, SWRevealPositionLeft, 10, 10 ) );
+    SWRevealZoneMapFree( &map );
+}
+
+
+int main( void )
+{
+    testIndexMatchesReference();
+    testEmptyIndex();
+    testEmptyMap();
+    testMapZones();
+    return SW_TEST_RESULT();
+}
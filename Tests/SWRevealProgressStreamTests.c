@@ -0,0 +1,180 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#if !defined(_POSIX_C_SOURCE) && !defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "SWRevealProgressStream.h"
+#include "SWRevealTest.h"
+
+
+static SWRevealProgressRecord recordForIndex( unsigned int i )
+{
+    SWRevealProgressRecord record = { i*1.0, i*2.0, i*0.5, -1.0*i, i%6, 0 };
+    return record;
+}
+
+
+static int recordMatches( const SWRevealProgressRecord *record )
+{
+    unsigned int i = record->sequence;
+    return record->timestamp == i*1.0 && record->location == i*2.0 && record->progress == i*0.5 &&
+        record->overProgress == -1.0*i && record->phase == i%6;
+}
+
+
+static void testSingleThread( void )
+{
+    SWRevealProgressStream *stream = SWRevealProgressStreamCreate( 100 );
+    SW_CHECK( stream != NULL );
+    SW_CHECK( SWRevealProgressStreamGetCapacity( stream ) == 128 );
+    SW_CHECK( (uintptr_t)stream % SWRevealProgressStreamCacheLineSize == 0 );
+
+    // a full ring drops new records and leaves a gap in the sequence
+    for ( unsigned int i=0 ; i<130 ; i++ )
+    {
+        SWRevealProgressRecord record = recordForIndex( i );
+        SW_CHECK( SWRevealProgressStreamPush( stream, &record ) == (i < 128) );
+    }
+
+    SWRevealProgressRecord records[200];
+    SW_CHECK( SWRevealProgressStreamDrain( stream, records, 100 ) == 100 );
+    SW_CHECK( SWRevealProgressStreamDrain( stream, records+100, 100 ) == 28 );
+    SW_CHECK( SWRevealProgressStreamDrain( stream, records, 100 ) == 0 );
+
+    int ordered = 1;
+    for ( unsigned int i=0 ; i<128 ; i++ ) ordered = ordered && records[i].sequence == i && recordMatches( &records[i] );
+    SW_CHECK( ordered );
+
+    SWRevealProgressRecord record = recordForIndex( 130 );
+    SW_CHECK( SWRevealProgressStreamPush( stream, &record ) );
+    SW_CHECK( SWRevealProgressStreamDrain( stream, records, 10 ) == 1 && records[0].sequence == 130 );
+
+    unsigned int pushed, dropped;
+    SWRevealProgressStreamGetCounters( stream, &pushed, &dropped );
+    SW_CHECK( pushed == 129 && dropped == 2 );
+
+    // extra references keep the stream alive
+    SW_CHECK( SWRevealProgressStreamRetain( stream ) == stream );
+    SWRevealProgressStreamRelease( stream );
+    SW_CHECK( SWRevealProgressStreamGetCapacity( stream ) == 128 );
+    SWRevealProgressStreamRelease( stream );
+    SWRevealProgressStreamRelease( NULL );
+}
+
+
+/* Producer and consumer on separate threads */
+
+#define SWStressRecords 2000000u
+
+typedef struct
+{
+    SWRevealProgressStream *stream;
+    unsigned int count;
+    int releases;               // <-- the producer drops its reference when done, as the controller does on a capacity change
+    int done;
+
+} SWStressContext;
+
+
+static void *producerThread( void *argument )
+{
+    SWStressContext *context = argument;
+    for ( unsigned int i=0 ; i<context->count ; i++ )
+    {
+        SWRevealProgressRecord record = recordForIndex( i );
+        SWRevealProgressStreamPush( context->stream, &record );
+    }
+
+    if ( context->releases )
+        SWRevealProgressStreamRelease( context->stream );
+
+    __atomic_store_n( &context->done, 1, __ATOMIC_RELEASE );
+    return NULL;
+}
+
+
+// Drains the stream until the producer is done and the ring is empty. Records must come in order, intact, and
+// the gaps must add up to the dropped count
+static void runStress( unsigned int capacity, int producerReleases )
+{
+    SWStressContext context;
+    context.stream = SWRevealProgressStreamCreate( capacity );
+    context.count = SWStressRecords;
+    context.releases = producerReleases;
+    context.done = 0;
+
+    // the consumer takes its own reference before the stream is handed over
+    SWRevealProgressStream *stream = SWRevealProgressStreamRetain( context.stream );
+
+    pthread_t producer;
+    SW_CHECK( pthread_create( &producer, NULL, producerThread, &context ) == 0 );
+
+    SWRevealProgressRecord records[64];
+    unsigned long received = 0, corrupted = 0, gaps = 0;
+    long last = -1;
+    for ( ;; )
+    {
+        int done = __atomic_load_n( &context.done, __ATOMIC_ACQUIRE );
+        unsigned int count = SWRevealProgressStreamDrain( stream, records, 64 );
+        for ( unsigned int i=0 ; i<count ; i++ )
+        {
+            long sequence = records[i].sequence;
+            if ( !recordMatches( &records[i] ) || sequence <= last ) corrupted += 1;
+            gaps += (unsigned long)(sequence - last - 1);
+            last = sequence;
+            received += 1;
+        }
+
+        if ( count == 0 && done )
+            break;
+    }
+    pthread_join( producer, NULL );
+    gaps += (unsigned long)(SWStressRecords - 1 - last);
+
+    // the consumer reference keeps the stream valid after the producer dropped its own
+    unsigned int pushed, dropped;
+    SWRevealProgressStreamGetCounters( stream, &pushed, &dropped );
+    SW_CHECK( corrupted == 0 );
+    SW_CHECK( received == pushed && gaps == dropped && pushed + dropped == SWStressRecords );
+    SW_CHECK( SWRevealProgressStreamDrain( stream, records, 64 ) == 0 );
+
+    SWRevealProgressStreamRelease( stream );
+    if ( !producerReleases )
+        SWRevealProgressStreamRelease( context.stream );
+}
+
+
+int main( void )
+{
+    testSingleThread();
+    runStress( 1000, 1 );
+    runStress( 16, 0 );
+    return SW_TEST_RESULT();
+}
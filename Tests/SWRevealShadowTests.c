@@ -0,0 +1,143 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "SWRevealShadow.h"
+#include "SWRevealTest.h"
+
+
+// Alpha of the pixel at (x, y), 0 to 1
+static double pixelAlpha( const SWRevealShadowImage *image, unsigned int x, unsigned int y )
+{
+    return image->pixels[((size_t)y*image->width + x)*4 + 3]/255.0;
+}
+
+
+// Continuous blur of a box edge: the fraction of a unit gaussian of deviation 'sigma' lying inside [a, b]
+static double boxProfile( double x, double a, double b, double sigma )
+{
+    return 0.5*(erf( (b-x)/(sigma*sqrt(2.0)) ) - erf( (a-x)/(sigma*sqrt(2.0)) ));
+}
+
+
+static void testRenderedImage( void )
+{
+    SWRevealShadowConfig config = { 2.5, 0.0, 0.0, 0.0, 1.0, 0.8, 2.0 };
+    SWRevealShadowImage image;
+    SW_CHECK( SWRevealShadowImageRender( &image, &config ) == 0 );
+
+    double sigma = config.radius*config.scale;
+    SW_CHECK( image.padding == (unsigned int)ceil( 3*sigma ) );
+    SW_CHECK( image.width == 4*image.padding + 1 && image.height == image.width );
+    SW_CHECK( image.capInset == 2*image.padding );
+
+    // the image is symmetric, and is the product of the blurred box profile in both directions
+    unsigned int size = image.width;
+    double a = image.padding - 0.5, b = 3*image.padding + 0.5;
+    for ( unsigned int y=0 ; y<size ; y++ )
+    {
+        for ( unsigned int x=0 ; x<size ; x++ )
+        {
+            SW_CHECK( image.pixels[((size_t)y*size + x)*4 + 3] == image.pixels[((size_t)x*size + (size-1-y))*4 + 3] );
+            double expected = config.opacity*boxProfile( x, a, b, sigma )*boxProfile( y, a, b, sigma );
+            SW_CHECK_CLOSE( pixelAlpha( &image, x, y ), expected, 0.02 );
+        }
+    }
+
+    // black shadows have no color, the center is fully shadowed
+    SW_CHECK( image.pixels[0] == 0 && image.pixels[1] == 0 && image.pixels[2] == 0 );
+    SW_CHECK_CLOSE( pixelAlpha( &image, size/2, size/2 ), 0.8, 1.0/255 );
+    SWRevealShadowImageFree( &image );
+    SW_CHECK( image.pixels == NULL );
+}
+
+
+static void testPremultipliedColor( void )
+{
+    SWRevealShadowConfig config = { 1.0, 1.0, 0.5, 0.0, 0.5, 1.0, 1.0 };
+    SWRevealShadowImage image;
+    SW_CHECK( SWRevealShadowImageRender( &image, &config ) == 0 );
+
+    unsigned char *center = image.pixels + ((size_t)(image.height/2)*image.width + image.width/2)*4;
+    // the center alpha is 0.5 less the gaussian tails beyond 3 sigma, the components are premultiplied
+    SW_CHECK( center[3] >= 126 && center[3] <= 128 );
+    SW_CHECK( center[0] == center[3] && abs( 2*center[1] - center[0] ) <= 1 && center[2] == 0 );
+    SWRevealShadowImageFree( &image );
+}
+
+
+static void testZeroRadius( void )
+{
+    SWRevealShadowConfig config = { 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 3.0 };
+    SWRevealShadowImage image;
+    SW_CHECK( SWRevealShadowImageRender( &image, &config ) == 0 );
+    SW_CHECK( image.width == 1 && image.padding == 0 );
+    SW_CHECK( image.pixels[3] == 255 );
+    SWRevealShadowImageFree( &image );
+}
+
+
+static void testCache( void )
+{
+    SWRevealShadowCache cache;
+    SWRevealShadowCacheInit( &cache );
+
+    SWRevealShadowConfig configs[SWRevealShadowCacheSlots+1];
+    for ( int i=0 ; i<SWRevealShadowCacheSlots+1 ; i++ )
+        configs[i] = (SWRevealShadowConfig){ 1.0 + i, 0.0, 0.0, 0.0, 1.0, 1.0, 2.0 };
+
+    const SWRevealShadowImage *first = SWRevealShadowCacheGetImage( &cache, &configs[0] );
+    SW_CHECK( first != NULL && cache.misses == 1 );
+    SW_CHECK( SWRevealShadowCacheGetImage( &cache, &configs[0] ) == first && cache.hits == 1 );
+
+    for ( int i=1 ; i<SWRevealShadowCacheSlots ; i++ )
+        SWRevealShadowCacheGetImage( &cache, &configs[i] );
+    SW_CHECK( cache.misses == SWRevealShadowCacheSlots );
+
+    // touching the first image makes the second one the least recently used, which is replaced
+    SWRevealShadowCacheGetImage( &cache, &configs[0] );
+    SWRevealShadowCacheGetImage( &cache, &configs[SWRevealShadowCacheSlots] );
+    SW_CHECK( cache.misses == SWRevealShadowCacheSlots+1 );
+
+    unsigned int hits = cache.hits;
+    SWRevealShadowCacheGetImage( &cache, &configs[0] );
+    SW_CHECK( cache.hits == hits+1 );
+    SWRevealShadowCacheGetImage( &cache, &configs[1] );
+    SW_CHECK( cache.hits == hits+1 && cache.misses == SWRevealShadowCacheSlots+2 );
+
+    SWRevealShadowCacheFree( &cache );
+}
+
+
+int main( void )
+{
+    testRenderedImage();
+    testPremultipliedColor();
+    testZeroRadius();
+    testCache();
+    return SW_TEST_RESULT();
+}
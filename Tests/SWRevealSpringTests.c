@@ -0,0 +1,104 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealSpring.h"
+#include "SWRevealTest.h"
+
+
+static const double dampingRatios[] = { 0.3, 0.7, 1.0, 1.5, 3.0 };
+static const double velocities[] = { -8.0, 0.0, 8.0 };
+
+
+static void testInitialConditions( void )
+{
+    for ( int i=0 ; i<5 ; i++ )
+    {
+        for ( int k=0 ; k<3 ; k++ )
+        {
+            SWRevealSpring spring;
+            SWRevealSpringInit( &spring, dampingRatios[i], 20.0, 1.0, velocities[k] );
+            SW_CHECK_CLOSE( SWRevealSpringPosition( &spring, 0.0 ), 0.0, 1e-12 );
+            SW_CHECK_CLOSE( SWRevealSpringVelocity( &spring, 0.0 ), velocities[k], 1e-9 );
+            SW_CHECK_CLOSE( SWRevealSpringPosition( &spring, 10.0 ), 1.0, 1e-9 );
+        }
+    }
+}
+
+
+// The velocity is the derivative of the position, and the spring stays within tolerance past its settling time
+static void testSettling( void )
+{
+    double tolerance = SWRevealSpringDefaultTolerance;
+    for ( int i=0 ; i<5 ; i++ )
+    {
+        double angularFrequency = SWRevealSpringAngularFrequencyForSettlingTime( dampingRatios[i], 0.25, tolerance );
+        for ( int k=0 ; k<3 ; k++ )
+        {
+            SWRevealSpring spring;
+            SWRevealSpringInit( &spring, dampingRatios[i], angularFrequency, 1.0, velocities[k] );
+            double settlingTime = SWRevealSpringSettlingTime( &spring, tolerance );
+            SW_CHECK( settlingTime > 0.0 && isfinite( settlingTime ) );
+
+            double maxError = 0.0, maxAfter = 0.0, h = 1e-6;
+            for ( double t=h ; t<3.0 ; t+=0.001 )
+            {
+                double derivative = (SWRevealSpringPosition( &spring, t+h ) - SWRevealSpringPosition( &spring, t-h ))/(2*h);
+                maxError = fmax( maxError, fabs( derivative - SWRevealSpringVelocity( &spring, t ) ) );
+                if ( t >= settlingTime ) maxAfter = fmax( maxAfter, fabs( SWRevealSpringPosition( &spring, t ) - 1.0 ) );
+            }
+            SW_CHECK( maxError < 1e-4 );
+            SW_CHECK( maxAfter <= tolerance );
+        }
+
+        // a spring starting at rest settles in the time its frequency was computed for
+        SWRevealSpring spring;
+        SWRevealSpringInit( &spring, dampingRatios[i], angularFrequency, 1.0, 0.0 );
+        SW_CHECK_CLOSE( SWRevealSpringSettlingTime( &spring, tolerance ), 0.25, 1e-3 );
+    }
+
+    // the critically damped settling time is where the envelope of the displacement meets the tolerance
+    for ( double velocity=-30.0 ; velocity<=30.0 ; velocity+=0.5 )
+    {
+        SWRevealSpring spring;
+        SWRevealSpringInit( &spring, 1.0, 20.0, 1.0, velocity );
+        double t = SWRevealSpringSettlingTime( &spring, tolerance );
+        double envelope = (fabs( spring.a ) + fabs( spring.b )*t)*exp( -spring.rateA*t );
+        SW_CHECK_CLOSE( envelope, tolerance, 1e-12 );
+    }
+
+    SWRevealSpring undamped;
+    SWRevealSpringInit( &undamped, 0.0, 20.0, 1.0, 0.0 );
+    SW_CHECK( SWRevealSpringSettlingTime( &undamped, tolerance ) == HUGE_VAL );
+}
+
+
+int main( void )
+{
+    testInitialConditions();
+    testSettling();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,201 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+#include <string.h>
+
+#include "SWRevealStateCodec.h"
+#include "SWRevealTest.h"
+
+
+static SWRevealState sampleState( void )
+{
+    SWRevealState state;
+    memset( &state, 0, sizeof state );
+    state.rearViewRevealWidth = 260.0;
+    state.rearViewRevealOverdraw = 60.0;
+    state.rearViewRevealDisplacement = 40.0;
+    state.rightViewRevealWidth = 260.0;
+    state.quickFlickVelocity = 250.0;
+    state.toggleAnimationDuration = 0.3;
+    state.springDampingRatio = 1.0;
+    state.frontViewShadowRadius = 2.5;
+    state.frontViewShadowOpacity = 1.0;
+    state.frontViewShadowAlpha = 1.0;
+    state.viewRetentionInterval = 30.0;
+    state.flags = SWRevealStateBounceBackOnOverdraw | SWRevealStateUserInteractionStore | SWRevealStateRoutesNestedPanGestures;
+    state.toggleAnimationType = 1;
+    state.viewRetentionPolicy = 2;
+    state.frontViewPosition = 4;
+    return state;
+}
+
+
+static void testRoundTrip( void )
+{
+    SWRevealState state = sampleState();
+    unsigned char bytes[256];
+    size_t length = SWRevealStateEncode( &state, bytes );
+    SW_CHECK( length == SWRevealStateEncodedSize() );
+    SW_CHECK( memcmp( bytes, "SWRS", 4 ) == 0 && bytes[4] == SWRevealStateVersion );
+
+    SWRevealState decoded;
+    memset( &decoded, 0, sizeof decoded );
+    SW_CHECK( SWRevealStateDecode( bytes, length, &decoded ) == 0 );
+    SW_CHECK( memcmp( &state, &decoded, sizeof state ) == 0 );
+}
+
+
+static void testLayoutChanges( void )
+{
+    SWRevealState state = sampleState();
+    unsigned char bytes[256];
+    size_t length = SWRevealStateEncode( &state, bytes );
+
+    SWRevealState defaults;
+    memset( &defaults, 0, sizeof defaults );
+    defaults.flags = 7;
+    defaults.frontViewPosition = 3;
+
+    // a blob from an older version with just the floating point fields, the others keep their defaults
+    unsigned char older[256];
+    memcpy( older, bytes, length );
+    older[5] = 20;
+    SWRevealState decoded = defaults;
+    SW_CHECK( SWRevealStateDecode( older, 6 + 20*8, &decoded ) == 0 );
+    SW_CHECK( decoded.rearViewRevealWidth == 260.0 && decoded.viewRetentionInterval == 30.0 );
+    SW_CHECK( decoded.flags == 7 && decoded.frontViewPosition == 3 );
+
+    // a blob from a newer version with fields appended, these are ignored
+    unsigned char newer[256];
+    memcpy( newer, bytes, length );
+    newer[5] = 40;
+    memset( newer + length, 0x5a, 30 );
+    decoded = defaults;
+    SW_CHECK( SWRevealStateDecode( newer, length + 30, &decoded ) == 0 );
+    SW_CHECK( memcmp( &state, &decoded, sizeof state ) == 0 );
+
+    // an incompatible version is rejected
+    newer[4] = SWRevealStateVersion + 1;
+    SW_CHECK( SWRevealStateDecode( newer, length + 30, &decoded ) == -1 );
+}
+
+
+static void testInvalidBlobs( void )
+{
+    SWRevealState state = sampleState();
+    unsigned char bytes[256];
+    size_t length = SWRevealStateEncode( &state, bytes );
+
+    SWRevealState defaults;
+    memset( &defaults, 0, sizeof defaults );
+    SWRevealState decoded;
+
+    // truncated blobs are rejected and leave the state untouched
+    for ( size_t k=0 ; k<length ; k++ )
+    {
+        decoded = defaults;
+        SW_CHECK( SWRevealStateDecode( bytes, k, &decoded ) == -1 );
+        SW_CHECK( memcmp( &decoded, &defaults, sizeof decoded ) == 0 );
+    }
+    SW_CHECK( SWRevealStateDecode( NULL, length, &decoded ) == -1 );
+
+    bytes[0] = 'X';
+    SW_CHECK( SWRevealStateDecode( bytes, length, &decoded ) == -1 );
+
+    // non finite values keep the defaults
+    state.rearViewRevealWidth = NAN;
+    state.quickFlickVelocity = INFINITY;
+    length = SWRevealStateEncode( &state, bytes );
+    decoded = defaults;
+    decoded.rearViewRevealWidth = 100.0;
+    SW_CHECK( SWRevealStateDecode( bytes, length, &decoded ) == 0 );
+    SW_CHECK( decoded.rearViewRevealWidth == 100.0 && decoded.quickFlickVelocity == 0.0 );
+    SW_CHECK( decoded.toggleAnimationDuration == 0.3 );
+}
+
+
+// Decodes random bytes and randomly corrupted blobs, decoding must never read past the blob and must either
+// fail leaving the state untouched, or produce finite values that survive a round trip
+static void testFuzz( void )
+{
+    SWRevealState state = sampleState();
+    unsigned char valid[256];
+    size_t validLength = SWRevealStateEncode( &state, valid );
+
+    SWRevealState defaults = sampleState();
+    long accepted = 0;
+    for ( int i=0 ; i<200000 ; i++ )
+    {
+        unsigned char bytes[256];
+        size_t length;
+        if ( i % 2 )
+        {
+            length = SWTestRandom() % 200;
+            for ( size_t k=0 ; k<length ; k++ ) bytes[k] = (unsigned char)SWTestRandom();
+            if ( i % 4 == 1 && length >= 6 ) { memcpy( bytes, "SWRS", 4 ); bytes[4] = SWRevealStateVersion; }
+        }
+        else
+        {
+            length = validLength;
+            memcpy( bytes, valid, length );
+            int flips = 1 + SWTestRandom() % 8;
+            for ( int f=0 ; f<flips ; f++ )
+                bytes[SWTestRandom() % length] ^= (unsigned char)(1 << (SWTestRandom() % 8));
+            if ( SWTestRandom() % 4 == 0 ) length = SWTestRandom() % (length + 1);
+        }
+
+        SWRevealState decoded = defaults;
+        if ( SWRevealStateDecode( bytes, length, &decoded ) != 0 )
+        {
+            if ( memcmp( &decoded, &defaults, sizeof decoded ) != 0 ) SW_CHECK( 0 );
+            continue;
+        }
+
+        accepted += 1;
+        const double *values = &decoded.rearViewRevealWidth;
+        for ( int k=0 ; k<20 ; k++ )
+            if ( !isfinite( values[k] ) ) SW_CHECK( 0 );
+
+        // enum values are clamped to a byte on encoding, which decoding always reproduces
+        unsigned char again[256];
+        size_t againLength = SWRevealStateEncode( &decoded, again );
+        SWRevealState redecoded = defaults;
+        if ( SWRevealStateDecode( again, againLength, &redecoded ) != 0 || memcmp( &redecoded, &decoded, sizeof decoded ) != 0 )
+            SW_CHECK( 0 );
+    }
+
+    SW_CHECK( accepted > 0 );
+}
+
+
+int main( void )
+{
+    testRoundTrip();
+    testLayoutChanges();
+    testInvalidBlobs();
+    testFuzz();
+    return SW_TEST_RESULT();
+}
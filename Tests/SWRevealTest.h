@@ -0,0 +1,70 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealTest
+
+ Minimal checking macros for the tests of the portable C modules. Failed checks are reported with their location and
+ counted, and SW_TEST_RESULT returns the exit status of the test program.
+
+*/
+
+#ifndef SWRevealTest_h
+#define SWRevealTest_h
+
+#include <math.h>
+#include <stdio.h>
+
+static int SWTestFailures = 0;
+static int SWTestChecks = 0;
+
+#define SW_CHECK( cond ) \
+    do { SWTestChecks++; if ( !(cond) ) { SWTestFailures++; \
+        fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); } } while ( 0 )
+
+#define SW_CHECK_CLOSE( a, b, tolerance ) \
+    do { double sw_a = (a), sw_b = (b); SWTestChecks++; if ( !(fabs(sw_a-sw_b) <= (tolerance)) ) { SWTestFailures++; \
+        fprintf( stderr, "%s:%d: check failed: %s == %s (%.12g != %.12g)\n", __FILE__, __LINE__, #a, #b, sw_a, sw_b ); } } while ( 0 )
+
+#define SW_TEST_RESULT() \
+    ( printf( "%s: %d checks, %d failed\n", __FILE__, SWTestChecks, SWTestFailures ), SWTestFailures ? 1 : 0 )
+
+// Small deterministic generator, so that randomized tests are reproducible on every platform
+static unsigned int SWTestRandomState = 12345;
+
+static inline unsigned int SWTestRandom( void )
+{
+    SWTestRandomState = SWTestRandomState*1103515245u + 12345u;
+    return SWTestRandomState >> 8;
+}
+
+// Returns a value uniformly distributed in [lo, hi)
+static inline double SWTestUniform( double lo, double hi )
+{
+    return lo + (hi-lo)*(SWTestRandom() & 0xffffff)/16777216.0;
+}
+
+#endif
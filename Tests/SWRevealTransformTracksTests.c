@@ -0,0 +1,159 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <math.h>
+
+#include "SWRevealTransformTracks.h"
+#include "SWRevealTest.h"
+
+
+// Reference track, evaluated by a linear search over its keyframes
+typedef struct
+{
+    int active;
+    unsigned int count;
+    double progress[16];
+    double values[16];
+
+} SWReferenceTrack;
+
+static const double identityValues[SWRevealTrackPropertyCount] = { 0.0, 0.0, 1.0, 1.0, 0.0 };
+
+
+static double referenceValue( const SWReferenceTrack *track, double x )
+{
+    unsigned int n = track->count;
+    if ( n == 1 || x <= track->progress[0] ) return track->values[0];
+    if ( x >= track->progress[n-1] ) return track->values[n-1];
+
+    for ( unsigned int i=0 ; i<n-1 ; i++ )
+    {
+        if ( x < track->progress[i+1] )
+        {
+            double t = (x - track->progress[i])/(track->progress[i+1] - track->progress[i]);
+            return track->values[i] + (track->values[i+1] - track->values[i])*t;
+        }
+    }
+    return track->values[n-1];
+}
+
+
+static void testSingleTrack( void )
+{
+    SWRevealTrackSet set;
+    SWRevealTrackSetInit( &set );
+
+    double progress[] = { 0.0, 1.0 };
+    double values[] = { 1.0, 0.8 };
+    SW_CHECK( SWRevealTrackSetAdd( &set, SWRevealTrackLayerFront, SWRevealTrackPropertyScale, progress, values, 2 ) == 0 );
+
+    SWRevealLayerValues layers[SWRevealTrackLayerCount];
+    SWRevealTrackSetEvaluate( &set, 0.5, layers );
+    SW_CHECK_CLOSE( layers[SWRevealTrackLayerFront].values[SWRevealTrackPropertyScale], 0.9, 1e-12 );
+    SW_CHECK( layers[SWRevealTrackLayerFront].mask == 1u << SWRevealTrackPropertyScale );
+    SW_CHECK( layers[SWRevealTrackLayerRear].mask == 0 );
+
+    // values hold outside the keyframes, untracked properties are at identity
+    SWRevealTrackSetEvaluate( &set, -1.0, layers );
+    SW_CHECK_CLOSE( layers[SWRevealTrackLayerFront].values[SWRevealTrackPropertyScale], 1.0, 0 );
+    SWRevealTrackSetEvaluate( &set, 1.2, layers );
+    SW_CHECK_CLOSE( layers[SWRevealTrackLayerFront].values[SWRevealTrackPropertyScale], 0.8, 0 );
+    SW_CHECK_CLOSE( layers[SWRevealTrackLayerFront].values[SWRevealTrackPropertyAlpha], 1.0, 0 );
+
+    // keyframes must ascend
+    double descending[] = { 1.0, 0.0 };
+    SW_CHECK( SWRevealTrackSetAdd( &set, SWRevealTrackLayerRear, SWRevealTrackPropertyAlpha, descending, values, 2 ) == -1 );
+    SW_CHECK( SWRevealTrackSetAdd( &set, SWRevealTrackLayerRear, SWRevealTrackPropertyAlpha, progress, values, 0 ) == -1 );
+
+    SWRevealTrackSetRemove( &set, SWRevealTrackLayerFront, SWRevealTrackPropertyScale );
+    SWRevealTrackSetEvaluate( &set, 0.5, layers );
+    SW_CHECK( layers[SWRevealTrackLayerFront].mask == 0 && set.trackCount == 0 );
+
+    SWRevealTrackSetFree( &set );
+}
+
+
+// Random additions, replacements and removals checked against the reference tracks at random progress values,
+// the remembered segments make successive evaluations depend on each other
+static void testRandomTracks( void )
+{
+    SWRevealTrackSet set;
+    SWRevealTrackSetInit( &set );
+    SWReferenceTrack reference[SWRevealTrackLayerCount][SWRevealTrackPropertyCount] = {{{ 0 }}};
+
+    for ( int i=0 ; i<100000 ; i++ )
+    {
+        unsigned int operation = SWTestRandom() % 10;
+        unsigned int layer = SWTestRandom() % SWRevealTrackLayerCount;
+        unsigned int property = SWTestRandom() % SWRevealTrackPropertyCount;
+
+        if ( operation == 0 )
+        {
+            SWRevealTrackSetRemove( &set, layer, property );
+            reference[layer][property].active = 0;
+        }
+        else if ( operation == 1 )
+        {
+            SWReferenceTrack *track = &reference[layer][property];
+            track->count = 1 + SWTestRandom() % 16;
+            double x = SWTestUniform( -2.0, -1.0 );
+            for ( unsigned int k=0 ; k<track->count ; k++ )
+            {
+                track->progress[k] = x;
+                track->values[k] = SWTestUniform( 0.0, 10.0 );
+                x += SWTestUniform( 0.01, 0.5 );
+            }
+            track->active = 1;
+            if ( SWRevealTrackSetAdd( &set, layer, property, track->progress, track->values, track->count ) != 0 ) SW_CHECK( 0 );
+        }
+        else
+        {
+            double x = SWTestUniform( -3.0, 3.0 );
+            SWRevealLayerValues layers[SWRevealTrackLayerCount];
+            SWRevealTrackSetEvaluate( &set, x, layers );
+
+            for ( unsigned int l=0 ; l<SWRevealTrackLayerCount ; l++ )
+            {
+                for ( unsigned int p=0 ; p<SWRevealTrackPropertyCount ; p++ )
+                {
+                    const SWReferenceTrack *track = &reference[l][p];
+                    double expected = track->active ? referenceValue( track, x ) : identityValues[p];
+                    if ( fabs( layers[l].values[p] - expected ) > 1e-9 ) SW_CHECK( 0 );
+                    if ( ((layers[l].mask >> p) & 1) != (unsigned int)track->active ) SW_CHECK( 0 );
+                }
+            }
+        }
+    }
+
+    SWRevealTrackSetFree( &set );
+}
+
+
+int main( void )
+{
+    testSingleTrack();
+    testRandomTracks();
+    return SW_TEST_RESULT();
+}
@@ -0,0 +1,76 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SWRevealDeploymentModel.h"
+
+
+// Runs random event sequences through the deployment model for every combination of controllers and retention,
+// prints the counters and fails if an invariant is violated
+//
+//  usage: SWRevealDeploymentCheck [events per configuration] [seed]
+
+static void printStats( const char *name, const SWRevealDeploymentStats *stats )
+{
+    printf( "%-28s events %llu (ignored %llu)  commands %llu  appears %llu/%llu/%llu  disappears %llu/%llu/%llu\n",
+        name, stats->events, stats->ignoredEvents, stats->commands,
+        stats->appears[SWRevealDeploymentSlotFront], stats->appears[SWRevealDeploymentSlotRear], stats->appears[SWRevealDeploymentSlotRight],
+        stats->disappears[SWRevealDeploymentSlotFront], stats->disappears[SWRevealDeploymentSlotRear], stats->disappears[SWRevealDeploymentSlotRight] );
+
+    printf( "%-28s redundant cycles %llu  double appears %llu  unbalanced disappears %llu  rest mismatches %llu\n",
+        "", stats->redundantCycles, stats->doubleAppears, stats->unbalancedDisappears, stats->restMismatches );
+}
+
+
+int main( int argc, char **argv )
+{
+    unsigned long count = argc > 1 ? strtoul( argv[1], NULL, 10 ) : 1000000;
+    unsigned long long seed = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 1;
+    unsigned long long violations = 0;
+
+    // configurations are given by the bits of 'c': rear, right, retained containers, hierarchical
+    for ( int c=0 ; c<16 ; c++ )
+    {
+        int hasRear = c & 1, hasRight = (c >> 1) & 1, retains = (c >> 2) & 1, hierarchical = (c >> 3) & 1;
+        if ( hierarchical && !hasRear )
+            continue;
+
+        char name[64];
+        snprintf( name, sizeof name, "rear %d right %d retain %d hier %d", hasRear, hasRight, retains, hierarchical );
+
+        SWRevealDeploymentModel model;
+        SWRevealDeploymentModelInit( &model, hasRear, hasRight, hierarchical, retains, SWRevealPositionLeft );
+        SWRevealDeploymentModelRun( &model, seed + c, count );
+        printStats( name, &model.stats );
+        SWRevealDeploymentModelFree( &model );
+
+        violations += model.stats.doubleAppears + model.stats.unbalancedDisappears + model.stats.restMismatches;
+    }
+
+    printf( "%llu invariant violations\n", violations );
+    return violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,520 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#include <string.h>
+
+#include "SWRevealDeploymentModel.h"
+
+
+/* Views */
+
+// Adds the view of 'controller' to its container
+static void showController( SWRevealDeploymentModel *model, int slot, int controller )
+{
+    SWRevealDeploymentSlotState *state = &model->slots[slot];
+    if ( controller == 0 )
+        return;
+
+    if ( state->shown == controller )
+    {
+        model->stats.doubleAppears += 1;
+        return;
+    }
+
+    state->shown = controller;
+    model->stats.appears[slot] += 1;
+
+    if ( state->cycleCandidate == controller )
+    {
+        model->stats.redundantCycles += 1;
+        state->cycleCandidate = 0;
+    }
+}
+
+
+// Removes the view of 'controller' from its container. Removals decided by the rules are 'expected' to find it there,
+// while the undeploy of a replaced controller is harmless if its view was not shown
+static void hideController( SWRevealDeploymentModel *model, int slot, int controller, int expected )
+{
+    SWRevealDeploymentSlotState *state = &model->slots[slot];
+    if ( controller == 0 )
+        return;
+
+    if ( state->shown == controller ) state->shown = 0;
+    else if ( state->leaving == controller ) state->leaving = 0;
+    else
+    {
+        if ( expected ) model->stats.unbalancedDisappears += 1;
+        return;
+    }
+
+    model->stats.disappears[slot] += 1;
+    state->cycleCandidate = controller;
+}
+
+
+// Returns non zero if the controller of a slot is deployed for the current position, transitions only add views to these
+static int isSlotDeployed( const SWRevealDeploymentModel *model, int slot )
+{
+    switch ( slot )
+    {
+        case SWRevealDeploymentSlotRight:
+            return model->rightPosition < SWRevealPositionLeft;
+
+        case SWRevealDeploymentSlotRear:
+            return model->rearPosition > SWRevealPositionLeft && model->rearPosition != SWRevealPositionNone;
+
+        default:
+            return model->frontPosition > SWRevealPositionLeftSideMostRemoved && model->frontPosition < SWRevealPositionRightMostRemoved;
+    }
+}
+
+
+/* Completions */
+
+static void resetCompletion( SWRevealDeploymentCompletion *completion )
+{
+    memset( completion, 0, sizeof *completion );
+    completion->transitionSlot = -1;
+}
+
+
+static void runCompletion( SWRevealDeploymentModel *model, SWRevealDeploymentCompletion *completion )
+{
+    if ( !completion->active )
+        return;
+
+    completion->active = 0;
+
+    for ( int slot=0 ; slot<3 ; slot++ )
+        hideController( model, slot, completion->disappear[slot], 1 );
+
+    for ( int slot=0 ; slot<2 ; slot++ )
+    {
+        if ( completion->unload[slot] && !model->retainsContainers )
+            model->slots[slot].containerLoaded = 0;
+    }
+
+    if ( completion->transitionSlot >= 0 )
+        hideController( model, completion->transitionSlot, completion->transitionOld, 0 );
+}
+
+
+static void executeCommand( SWRevealDeploymentModel *model, const SWRevealCommand *command );
+
+// Completes the running animation and executes the next command, as the controller does from its completion blocks
+static void finishAnimation( SWRevealDeploymentModel *model )
+{
+    runCompletion( model, &model->completion );
+
+    const SWRevealCommand *next = SWRevealCommandQueueDequeue( &model->queue );
+    if ( next )
+    {
+        SWRevealCommand command = *next;
+        executeCommand( model, &command );
+    }
+}
+
+
+/* Deployment */
+
+static void deploySide( SWRevealDeploymentModel *model, int slot, int newPosition, SWRevealDeploymentCompletion *completion )
+{
+    SWRevealDeploymentSlotState *state = &model->slots[slot];
+    SWRevealDeploymentStep step;
+
+    if ( slot == SWRevealDeploymentSlotRear )
+    {
+        SWRevealRearDeploymentStep( model->rearPosition, newPosition, state->controller != 0, model->hierarchical, &step );
+        model->rearPosition = step.position;
+    }
+    else
+    {
+        SWRevealRightDeploymentStep( model->rightPosition, newPosition, state->controller != 0, &step );
+        model->rightPosition = step.position;
+    }
+
+    if ( step.appear )
+    {
+        state->containerLoaded = 1;
+        showController( model, slot, state->controller );
+    }
+
+    if ( step.disappear )
+    {
+        completion->disappear[slot] = state->controller;
+        completion->unload[slot] = 1;
+    }
+}
+
+
+static void setFrontPosition( SWRevealDeploymentModel *model, int newPosition, int animated )
+{
+    SWRevealDeploymentCompletion completion;
+    resetCompletion( &completion );
+    completion.active = 1;
+
+    deploySide( model, SWRevealDeploymentSlotRear, newPosition, &completion );
+    deploySide( model, SWRevealDeploymentSlotRight, newPosition, &completion );
+
+    SWRevealDeploymentSlotState *front = &model->slots[SWRevealDeploymentSlotFront];
+    SWRevealDeploymentStep step;
+    SWRevealFrontDeploymentStep( model->frontPosition, newPosition,
+        model->slots[SWRevealDeploymentSlotRear].controller != 0, model->slots[SWRevealDeploymentSlotRight].controller != 0, &step );
+
+    model->frontPosition = step.position;
+    if ( step.appear ) showController( model, SWRevealDeploymentSlotFront, front->controller );
+    if ( step.disappear ) completion.disappear[SWRevealDeploymentSlotFront] = front->controller;
+
+    model->completion = completion;
+    if ( !animated )
+        finishAnimation( model );
+}
+
+
+static void transition( SWRevealDeploymentModel *model, int slot, int controller, int animated )
+{
+    SWRevealDeploymentSlotState *state = &model->slots[slot];
+    int old = state->controller;
+
+    SWRevealDeploymentCompletion completion;
+    resetCompletion( &completion );
+    completion.active = 1;
+
+    if ( old != controller )
+    {
+        state->controller = controller;
+
+        // the new view is added right away, the old one is removed on completion
+        if ( old != 0 && state->shown == old )
+        {
+            state->leaving = old;
+            state->shown = 0;
+        }
+
+        if ( isSlotDeployed( model, slot ) && state->containerLoaded )
+            showController( model, slot, controller );
+
+        completion.transitionSlot = slot;
+        completion.transitionOld = old;
+    }
+
+    model->completion = completion;
+    if ( !animated )
+        finishAnimation( model );
+}
+
+
+// Deploys the rear and right views for a drag toward the side of 'position', completions run right away
+static void deployForDrag( SWRevealDeploymentModel *model, int position )
+{
+    if ( position == SWRevealPositionLeft )
+        return;
+
+    int dragPosition = position < SWRevealPositionLeft ? SWRevealPositionLeftSide : SWRevealPositionRight;
+    SWRevealDeploymentCompletion completion;
+
+    resetCompletion( &completion );
+    completion.active = 1;
+    deploySide( model, SWRevealDeploymentSlotRight, dragPosition, &completion );
+    runCompletion( model, &completion );
+
+    resetCompletion( &completion );
+    completion.active = 1;
+    deploySide( model, SWRevealDeploymentSlotRear, dragPosition, &completion );
+    runCompletion( model, &completion );
+}
+
+
+/* Commands */
+
+// Transition commands keep the new controller in 'position', as the model has no objects
+static void executeCommand( SWRevealDeploymentModel *model, const SWRevealCommand *command )
+{
+    model->stats.commands += 1;
+    model->settled = 0;
+
+    switch ( command->type )
+    {
+        case SWRevealCommandSetPosition:
+            setFrontPosition( model, command->position, command->duration > 0.0 );
+            break;
+
+        case SWRevealCommandTransition:
+            transition( model, command->operation, command->position, command->animated );
+            break;
+
+        case SWRevealCommandGesture:
+        case SWRevealCommandBatch:      // <-- not issued by the model
+            break;
+    }
+}
+
+
+static int enqueueCommand( SWRevealDeploymentModel *model, const SWRevealCommand *command )
+{
+    SWRevealCommandEnqueueResult result = SWRevealCommandQueueEnqueue( &model->queue, command );
+    if ( result == SWRevealCommandOverflow )
+        return -1;
+
+    if ( result == SWRevealCommandExecuteNow )
+    {
+        SWRevealCommand front = *SWRevealCommandQueueFront( &model->queue );
+        executeCommand( model, &front );
+    }
+    return 0;
+}
+
+
+static int enqueuePush( SWRevealDeploymentModel *model, int animated )
+{
+    int preReplacementPosition = SWRevealPositionLeft;
+    if ( model->frontPosition > SWRevealPositionLeft ) preReplacementPosition = SWRevealPositionRightMost;
+    if ( model->frontPosition < SWRevealPositionLeft ) preReplacementPosition = SWRevealPositionLeftSideMost;
+
+    double duration = animated ? 1.0 : 0.0;
+    double firstDuration = model->frontPosition == preReplacementPosition ? 0.0 : duration;
+
+    unsigned int group = SWRevealCommandQueueNewGroup( &model->queue );
+    int controller = ++model->nextController;
+    SWRevealCommand transitionCommand = { SWRevealCommandTransition, group, controller, 0.0, SWRevealDeploymentSlotFront, 0, NULL, 0 };
+
+    if ( !animated )
+        return enqueueCommand( model, &transitionCommand );
+
+    SWRevealCommand first = { SWRevealCommandSetPosition, group, preReplacementPosition, firstDuration, 0, 0, NULL, 0 };
+    SWRevealCommand last = { SWRevealCommandSetPosition, group, SWRevealPositionLeft, duration, 0, 0, NULL, 0 };
+    if ( enqueueCommand( model, &first ) != 0 ) return -1;
+    if ( enqueueCommand( model, &transitionCommand ) != 0 ) return -1;
+    return enqueueCommand( model, &last );
+}
+
+
+static int panBegan( SWRevealDeploymentModel *model, int position )
+{
+    SWRevealCommand gesture = { SWRevealCommandGesture, 0, 0, 0.0, 0, 0, NULL, 0 };
+
+    if ( model->panning )
+        return -1;
+
+    if ( SWRevealCommandQueueCount( &model->queue ) == 0 )
+    {
+        enqueueCommand( model, &gesture );
+    }
+    else
+    {
+        // a running position animation is interrupted where the front view is, given by 'position'
+        int removed = model->frontPosition == SWRevealPositionRightMostRemoved || model->frontPosition == SWRevealPositionLeftSideMostRemoved;
+        if ( !model->completion.active || !SWRevealCommandQueueCanInterrupt( &model->queue ) || removed )
+            return -1;
+
+        runCompletion( model, &model->completion );
+        SWRevealCommandQueueInterrupt( &model->queue, &gesture );
+        deployForDrag( model, position );
+    }
+
+    model->panning = 1;
+    model->settled = 0;
+    return 0;
+}
+
+
+/* Model */
+
+int SWRevealDeploymentModelIsAtRest( const SWRevealDeploymentModel *model )
+{
+    return SWRevealCommandQueueCount( &model->queue ) == 0 && !model->completion.active && !model->panning;
+}
+
+
+// Checks that the views shown match the positions, and starts a new cycle detection period
+static void settle( SWRevealDeploymentModel *model )
+{
+    for ( int slot=0 ; slot<3 ; slot++ )
+    {
+        SWRevealDeploymentSlotState *state = &model->slots[slot];
+        int expected = state->controller != 0 && isSlotDeployed( model, slot );
+
+        if ( state->leaving != 0 || (expected ? state->shown != state->controller : state->shown != 0) )
+            model->stats.restMismatches += 1;
+
+        state->cycleCandidate = 0;
+    }
+    model->settled = 1;
+}
+
+
+void SWRevealDeploymentModelInit( SWRevealDeploymentModel *model, int hasRear, int hasRight, int hierarchical,
+    int retainsContainers, int position )
+{
+    memset( model, 0, sizeof *model );
+    SWRevealCommandQueueInit( &model->queue, NULL );
+    resetCompletion( &model->completion );
+
+    model->hierarchical = hierarchical;
+    model->retainsContainers = retainsContainers;
+    model->randomState = 0x9E3779B97F4A7C15ULL;
+
+    model->slots[SWRevealDeploymentSlotFront].controller = ++model->nextController;
+    model->slots[SWRevealDeploymentSlotFront].containerLoaded = 1;
+    if ( hasRear ) model->slots[SWRevealDeploymentSlotRear].controller = ++model->nextController;
+    if ( hasRight ) model->slots[SWRevealDeploymentSlotRight].controller = ++model->nextController;
+
+    // as in loadView, moving from no position forces all views to load
+    model->frontPosition = SWRevealPositionNone;
+    model->rearPosition = SWRevealPositionNone;
+    model->rightPosition = SWRevealPositionNone;
+    setFrontPosition( model, position, 0 );
+    settle( model );
+}
+
+
+void SWRevealDeploymentModelFree( SWRevealDeploymentModel *model )
+{
+    SWRevealCommandQueueFree( &model->queue );
+}
+
+
+int SWRevealDeploymentModelApply( SWRevealDeploymentModel *model, const SWRevealModelEvent *event )
+{
+    int result = 0;
+
+    switch ( event->type )
+    {
+        case SWRevealModelEventSetPosition:
+        {
+            SWRevealCommand command = { SWRevealCommandSetPosition, 0, event->position, event->animated ? 1.0 : 0.0, 0, 0, NULL, 0 };
+            result = enqueueCommand( model, &command );
+            break;
+        }
+
+        case SWRevealModelEventPush:
+            result = enqueuePush( model, event->animated );
+            break;
+
+        case SWRevealModelEventReplaceRear:
+        case SWRevealModelEventReplaceRight:
+        {
+            int slot = event->type == SWRevealModelEventReplaceRear ? SWRevealDeploymentSlotRear : SWRevealDeploymentSlotRight;
+            int controller = event->remove ? 0 : ++model->nextController;
+            SWRevealCommand command = { SWRevealCommandTransition, 0, controller, 0.0, slot, event->animated, NULL, 0 };
+            result = enqueueCommand( model, &command );
+            break;
+        }
+
+        case SWRevealModelEventPanBegan:
+            result = panBegan( model, event->position );
+            break;
+
+        case SWRevealModelEventPanMoved:
+            if ( !model->panning ) result = -1;
+            else deployForDrag( model, event->position );
+            break;
+
+        case SWRevealModelEventPanEnded:
+            if ( !model->panning ) result = -1;
+            else
+            {
+                // the release animation completion removes the gesture command
+                model->panning = 0;
+                setFrontPosition( model, event->position, event->animated );
+            }
+            break;
+
+        case SWRevealModelEventPanCancelled:
+            if ( !model->panning ) result = -1;
+            else
+            {
+                model->panning = 0;
+                finishAnimation( model );
+            }
+            break;
+
+        case SWRevealModelEventAnimationEnded:
+            if ( !model->completion.active ) result = -1;
+            else finishAnimation( model );
+            break;
+    }
+
+    if ( result == 0 ) model->stats.events += 1;
+    else model->stats.ignoredEvents += 1;
+
+    if ( !model->settled && SWRevealDeploymentModelIsAtRest( model ) )
+        settle( model );
+
+    return result;
+}
+
+
+/* Random runs */
+
+// xorshift64*, good enough to explore sequences and reproducible across platforms
+static unsigned long long nextRandom( unsigned long long *state )
+{
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+
+void SWRevealDeploymentModelRun( SWRevealDeploymentModel *model, unsigned long long seed, unsigned long count )
+{
+    static const SWRevealModelEventType types[] =
+    {
+        SWRevealModelEventSetPosition, SWRevealModelEventSetPosition, SWRevealModelEventSetPosition,
+        SWRevealModelEventPush, SWRevealModelEventPush,
+        SWRevealModelEventReplaceRear, SWRevealModelEventReplaceRight,
+        SWRevealModelEventPanBegan, SWRevealModelEventPanBegan,
+        SWRevealModelEventPanMoved, SWRevealModelEventPanMoved,
+        SWRevealModelEventPanEnded, SWRevealModelEventPanEnded,
+        SWRevealModelEventPanCancelled,
+    };
+    static const int dragPositions[] = { SWRevealPositionLeftSide, SWRevealPositionLeft, SWRevealPositionRight };
+
+    if ( seed != 0 )
+        model->randomState = seed;
+
+    for ( unsigned long i=0 ; i<count ; i++ )
+    {
+        unsigned long long r = nextRandom( &model->randomState );
+        SWRevealModelEvent event;
+
+        // running animations complete about one event in three
+        if ( model->completion.active && r%3 == 0 ) event.type = SWRevealModelEventAnimationEnded;
+        else event.type = types[(r >> 8) % (sizeof types/sizeof *types)];
+
+        event.position = SWRevealPositionLeftSideMostRemoved + (int)((r >> 16) % 7);
+        if ( event.type == SWRevealModelEventPanBegan || event.type == SWRevealModelEventPanMoved )
+            event.position = dragPositions[(r >> 16) % 3];
+
+        event.animated = (int)((r >> 24) & 1);
+        event.remove = (r >> 25) % 8 == 0;
+
+        SWRevealDeploymentModelApply( model, &event );
+    }
+}
@@ -0,0 +1,157 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+/*
+
+ SWRevealDeploymentModel
+
+ Headless model of SWRevealViewController deployment. It replays the SWRevealDeployment rules along with the command
+ queue and the deferred animation completions, so that random command sequences can be run on any platform while
+ appearance calls are counted and invariants are checked. Used by the deployment tests, benchmark and check tool,
+ it is not part of the library.
+
+*/
+
+#ifndef SWRevealDeploymentModel_h
+#define SWRevealDeploymentModel_h
+
+#include "SWRevealDeployment.h"
+#include "SWRevealCommandQueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Controller slots, right (0) and rear (1) follow the symetry indexes used elsewhere
+typedef enum
+{
+    SWRevealDeploymentSlotRight,
+    SWRevealDeploymentSlotRear,
+    SWRevealDeploymentSlotFront,
+
+} SWRevealDeploymentSlot;
+
+// Model events, these stand for the calls made on the controller and for the completion of its animations
+typedef enum
+{
+    SWRevealModelEventSetPosition,      // <-- setFrontViewPosition:animated: to 'position'
+    SWRevealModelEventPush,             // <-- pushFrontViewController:animated: with a new controller
+    SWRevealModelEventReplaceRear,      // <-- setRearViewController:animated: with a new controller, or nil if 'remove'
+    SWRevealModelEventReplaceRight,     // <-- setRightViewController:animated: with a new controller, or nil if 'remove'
+    SWRevealModelEventPanBegan,         // <-- a pan gesture begins, possibly interrupting the running animation
+    SWRevealModelEventPanMoved,         // <-- a pan gesture drags toward the side of 'position'
+    SWRevealModelEventPanEnded,         // <-- a pan gesture ends and releases to 'position'
+    SWRevealModelEventPanCancelled,     // <-- a pan gesture is cancelled
+    SWRevealModelEventAnimationEnded,   // <-- the running animation completes
+
+} SWRevealModelEventType;
+
+typedef struct
+{
+    SWRevealModelEventType type;
+    int position;
+    int animated;
+    int remove;
+
+} SWRevealModelEvent;
+
+// Counters. Violations are counted rather than asserted so that a run reports all of them
+typedef struct
+{
+    unsigned long long events;              // <-- applied events
+    unsigned long long ignoredEvents;       // <-- events the controller would not receive in that state, such as pans while busy
+    unsigned long long commands;            // <-- executed commands
+    unsigned long long appears[3];          // <-- controller views added to their containers, per slot
+    unsigned long long disappears[3];       // <-- controller views removed from their containers, per slot
+    unsigned long long redundantCycles;     // <-- views removed and added back before the controller came to rest
+    unsigned long long doubleAppears;       // <-- views added while already in their container
+    unsigned long long unbalancedDisappears;// <-- removals decided for views that were not in their container
+    unsigned long long restMismatches;      // <-- rest states where the views shown do not match the positions
+
+} SWRevealDeploymentStats;
+
+// State of a controller slot. Controllers are identified by positive numbers, 0 meaning no controller
+typedef struct
+{
+    int controller;         // <-- current controller
+    int shown;              // <-- controller whose view is in the container
+    int leaving;            // <-- replaced controller whose view is removed on transition completion
+    int containerLoaded;    // <-- always set for the front slot
+    int cycleCandidate;     // <-- controller removed since the model was last at rest
+
+} SWRevealDeploymentSlotState;
+
+// Completion of the running animation, run on AnimationEnded or when a pan interrupts it
+typedef struct
+{
+    int active;
+    int disappear[3];       // <-- controllers to remove, per slot
+    int unload[2];          // <-- containers to unload, right (0) and rear (1)
+    int transitionSlot;     // <-- slot of a running transition, or -1
+    int transitionOld;      // <-- replaced controller of a running transition
+
+} SWRevealDeploymentCompletion;
+
+typedef struct
+{
+    int frontPosition;
+    int rearPosition;
+    int rightPosition;
+    int hierarchical;           // <-- mirrors presentFrontViewHierarchically
+    int retainsContainers;      // <-- closed containers are kept, as with a retention policy other than None
+    SWRevealDeploymentSlotState slots[3];
+    SWRevealCommandQueue queue;
+    SWRevealDeploymentCompletion completion;
+    int panning;
+    int settled;
+    int nextController;
+    unsigned long long randomState;
+    SWRevealDeploymentStats stats;
+
+} SWRevealDeploymentModel;
+
+
+// Initializes a model as the controller is after loading its view at 'position', with the given controllers
+void SWRevealDeploymentModelInit( SWRevealDeploymentModel *model, int hasRear, int hasRight, int hierarchical,
+    int retainsContainers, int position );
+
+// Releases the memory held by a model
+void SWRevealDeploymentModelFree( SWRevealDeploymentModel *model );
+
+// Applies an event and returns 0, or returns -1 if the controller would not receive it in the current state
+int SWRevealDeploymentModelApply( SWRevealDeploymentModel *model, const SWRevealModelEvent *event );
+
+// Returns non zero if nothing is running, pending or being dragged
+int SWRevealDeploymentModelIsAtRest( const SWRevealDeploymentModel *model );
+
+// Applies 'count' random events drawn from 'seed'. Commands are issued at random times relative to the completion of
+// running animations, so sequences that supersede, interrupt and coalesce each other are frequent
+void SWRevealDeploymentModelRun( SWRevealDeploymentModel *model, unsigned long long seed, unsigned long count );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
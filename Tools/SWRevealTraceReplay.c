@@ -0,0 +1,221 @@
+/*
+
+ Copyright (c) 2013 Joan Lluch <joan.lluch@sweetwilliamsl.com>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is furnished
+ to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*/
+
+
+#if !defined(_POSIX_C_SOURCE) && !defined(__APPLE__)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SWRevealGestureTrace.h"
+
+
+// Replays a gesture trace recorded by SWRevealViewController and prints, for each event, the drag location, the front,
+// rear and right view x locations and the time the replay took for it, followed by the final position of each gesture
+//
+//  usage: SWRevealTraceReplay [--summary] <trace file>
+//         SWRevealTraceReplay [--summary] --sample     replays a built in synthetic trace
+
+typedef struct
+{
+    int summary;
+    double lastTime;
+    unsigned long events;
+    double totalSeconds, maxSeconds;
+
+} SWRevealTraceReplayReport;
+
+static const char *phaseNames[] = { "began", "moved", "ended", "cancelled" };
+
+static const char *positionNames[] =
+{
+    "LeftSideMostRemoved", "LeftSideMost", "LeftSide", "Left", "Right", "RightMost", "RightMostRemoved",
+};
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+
+static const char *positionName( SWRevealPosition position )
+{
+    return (unsigned int)position < sizeof positionNames/sizeof *positionNames ? positionNames[position] : "?";
+}
+
+
+// Called after each event is replayed, the time since the previous call is the replay time of the event
+static void reportStep( const SWRevealTraceReplayStep *step, void *context )
+{
+    SWRevealTraceReplayReport *report = context;
+    double time = now();
+    double seconds = time - report->lastTime;
+
+    report->events += 1;
+    report->totalSeconds += seconds;
+    if ( seconds > report->maxSeconds ) report->maxSeconds = seconds;
+
+    const SWRevealTraceEvent *event = &step->event;
+    if ( !report->summary )
+    {
+        printf( "%3u %-9s t=%7.4f  drag=%8.2f  front=%8.2f  rear=%8.2f  right=%8.2f  %6.0f ns\n",
+            step->gesture, phaseNames[event->phase], event->time, event->location,
+            step->frames.front.x, step->frames.rear.x, step->frames.right.x, seconds*1e9 );
+    }
+
+    if ( event->phase == SWRevealTracePhaseEnded || event->phase == SWRevealTracePhaseCancelled )
+    {
+        printf( "%3u final position %s, front at %.2f, release velocity %.1f\n",
+            step->gesture, positionName( step->finalPosition ), step->frontLocation, step->releaseVelocity );
+    }
+
+    report->lastTime = now();
+}
+
+
+// Records two gestures, a fling that opens the rear view and a short drag back that is released in place
+static int recordSample( SWRevealTraceRecorder *recorder )
+{
+    SWRevealTraceConfig config =
+    {
+        { 320, 568, 260, 60, 40, 260, 60, 40, 0 }, SWRevealPositionLeft, 250, 1, 0, 1, 0, 1, 1,
+        SWRevealResistanceCurveLinearClamp, 0,
+    };
+
+    if ( !SWRevealTraceRecorderInit( recorder, 1024 ) ) return -1;
+
+    int ok = SWRevealTraceRecorderBeginGesture( recorder, &config, 100.0 );
+    ok = ok && SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseBegan, 100.0, 0, 0 );
+    for ( int i=1 ; i<30 ; i++ )
+        ok = ok && SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseMoved, 100.0 + i/120.0, i*10.0, 1200 );
+    ok = ok && SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseEnded, 100.0 + 30/120.0, 300, 1200 );
+
+    config.initialPosition = SWRevealPositionRight;
+    ok = ok && SWRevealTraceRecorderBeginGesture( recorder, &config, 200.0 );
+    ok = ok && SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseBegan, 200.0, 260, 0 );
+    for ( int i=1 ; i<10 ; i++ )
+        ok = ok && SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseMoved, 200.0 + i/120.0, 260 - i*2.0, -100 );
+    ok = ok && SWRevealTraceRecorderAddEvent( recorder, SWRevealTracePhaseEnded, 200.0 + 10/120.0, 240, -100 );
+
+    return ok ? 0 : -1;
+}
+
+
+static int readFile( const char *path, unsigned char **pBytes, size_t *pLength )
+{
+    FILE *file = fopen( path, "rb" );
+    if ( file == NULL )
+        return -1;
+
+    size_t capacity = 4096, length = 0;
+    unsigned char *bytes = malloc( capacity );
+    while ( bytes != NULL )
+    {
+        length += fread( bytes + length, 1, capacity - length, file );
+        if ( length < capacity )
+            break;
+
+        unsigned char *grown = realloc( bytes, capacity *= 2 );
+        if ( grown == NULL ) free( bytes );
+        bytes = grown;
+    }
+
+    int failed = bytes == NULL || ferror( file );
+    fclose( file );
+    if ( failed )
+    {
+        free( bytes );
+        return -1;
+    }
+
+    *pBytes = bytes;
+    *pLength = length;
+    return 0;
+}
+
+
+int main( int argc, char **argv )
+{
+    SWRevealTraceReplayReport report;
+    memset( &report, 0, sizeof report );
+
+    const char *path = NULL;
+    int sample = 0;
+    for ( int i=1 ; i<argc ; i++ )
+    {
+        if ( strcmp( argv[i], "--summary" ) == 0 ) report.summary = 1;
+        else if ( strcmp( argv[i], "--sample" ) == 0 ) sample = 1;
+        else path = argv[i];
+    }
+
+    if ( !sample && path == NULL )
+    {
+        fprintf( stderr, "usage: %s [--summary] <trace file> | --sample\n", argv[0] );
+        return 2;
+    }
+
+    SWRevealTraceRecorder recorder;
+    unsigned char *bytes = NULL;
+    size_t length = 0;
+
+    if ( sample )
+    {
+        if ( recordSample( &recorder ) != 0 )
+        {
+            fprintf( stderr, "could not record the sample trace\n" );
+            SWRevealTraceRecorderFree( &recorder );
+            return 1;
+        }
+        bytes = recorder.bytes;
+        length = recorder.length;
+    }
+    else if ( readFile( path, &bytes, &length ) != 0 )
+    {
+        fprintf( stderr, "could not read %s\n", path );
+        return 1;
+    }
+
+    report.lastTime = now();
+    int gestures = SWRevealTraceReplay( bytes, length, reportStep, &report );
+
+    if ( sample ) SWRevealTraceRecorderFree( &recorder );
+    else free( bytes );
+
+    if ( gestures < 0 )
+    {
+        fprintf( stderr, "malformed trace after %lu events\n", report.events );
+        return 1;
+    }
+
+    printf( "%d gestures, %lu events, replay %.0f ns per event on average, %.0f ns at most\n", gestures, report.events,
+        report.events > 0 ? report.totalSeconds/report.events*1e9 : 0.0, report.maxSeconds*1e9 );
+    return 0;
+}